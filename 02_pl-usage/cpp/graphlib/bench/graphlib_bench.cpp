@@ -0,0 +1,392 @@
+// Benchmarks for graphlib. Generates synthetic graphs (see generators.hpp) at
+// several sizes with fixed seeds, times graph construction and the core
+// algorithms on both Graph and CompactGraph, and prints the results to stdout
+// as JSON. Progress goes to stderr.
+//
+// Usage: graphlib_bench [--min-scale=N] [--max-scale=N] [--filter=TEXT]
+//   Graphs have 2^scale vertices, for every even scale in [min, max] (defaults
+//   8 and 16). Only benchmarks whose generator, representation, or operation
+//   name contains TEXT are run.
+//
+// Configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graphlib/algo/bfs.hpp"
+#include "graphlib/algo/contraction_hierarchy.hpp"
+#include "graphlib/algo/dfs.hpp"
+#include "graphlib/algo/landmarks.hpp"
+#include "graphlib/algo/mst.hpp"
+#include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
+#include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
+
+using graphlib::CompactGraph;
+using graphlib::Graph;
+using graphlib::Graph2d;
+using graphlib::SearchState;
+using graphlib::Vertex;
+
+struct BenchResult {
+  std::string generator, representation, operation;
+  std::size_t num_vertices, num_edges;
+  double seconds;
+  long peak_rss_kb;
+};
+
+std::vector<BenchResult> g_results;
+std::string g_filter;
+
+// Some algorithms are too slow to run on the larger graphs. These are the
+// largest vertex counts they are run on.
+const std::size_t kMaxVerticesFloydWarshallDense = std::size_t(1) << 10;
+const std::size_t kMaxVerticesFloydWarshallMap = std::size_t(1) << 10;
+
+// Contraction hierarchies are only built for the generators with some
+// geometry (as road networks have), up to this size. Random graphs without any
+// have no hierarchy to exploit, and preprocessing blows up.
+const std::size_t kMaxVerticesContractionHierarchy = std::size_t(1) << 16;
+
+// Batched path queries are timed on this many random pairs of vertices, with
+// this many distinct sources.
+const std::size_t kNumBatchPathQueries = 256;
+const std::size_t kNumBatchPathSources = 32;
+
+// Number of landmarks picked for the ALT searches.
+const std::size_t kNumLandmarks = 16;
+
+// Number of random pairs of vertices the point-to-point searches are timed on.
+const std::size_t kNumPointToPointPairs = 16;
+
+// Number of random points the spatial queries on a Graph2d are timed on.
+const std::size_t kNumSpatialQueries = 1 << 14;
+
+// The process's peak resident set size only ever goes up, so it's reset before
+// each operation (Linux's clear_refs), and read back after it from the
+// process's status. Each record's peak_rss_kb is then the peak while its
+// operation ran, including the memory already held at the start (the graphs
+// themselves). Returns -1 where /proc isn't available.
+void reset_peak_rss() { std::ofstream("/proc/self/clear_refs") << "5"; }
+
+long peak_rss_kb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return std::stol(line.substr(6));  // in kB
+    }
+  }
+  return -1;
+}
+
+template <typename Operation>
+double time_seconds(Operation operation) {
+  auto start = std::chrono::steady_clock::now();
+  operation();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+bool selected(const std::string& generator, const std::string& representation,
+              const std::string& operation) {
+  return g_filter.empty() || generator.find(g_filter) != std::string::npos ||
+         representation.find(g_filter) != std::string::npos ||
+         operation.find(g_filter) != std::string::npos;
+}
+
+template <typename Operation>
+void run(const std::string& generator, const std::string& representation,
+         const std::string& operation, const CompactGraph& compact,
+         Operation op) {
+  if (!selected(generator, representation, operation)) return;
+  std::cerr << generator << " (V=" << compact.NumVertices() << ") "
+            << representation << ' ' << operation << "...\n";
+  reset_peak_rss();
+  double seconds = time_seconds(op);
+  g_results.push_back({generator, representation, operation,
+                       compact.NumVertices(), compact.NumEdges(), seconds,
+                       peak_rss_kb()});
+}
+
+template <typename MakeGraph>
+void bench_graph(const std::string& generator, MakeGraph make_graph) {
+  // Construction always runs, since everything else needs the graphs.
+  decltype(make_graph()) graph;
+  std::unique_ptr<CompactGraph> compact;
+  reset_peak_rss();
+  double build_seconds = time_seconds([&] { graph = make_graph(); });
+  long build_peak_rss_kb = peak_rss_kb();
+  reset_peak_rss();
+  double snapshot_seconds = time_seconds(
+      [&] { compact = std::make_unique<CompactGraph>(*graph); });
+  long snapshot_peak_rss_kb = peak_rss_kb();
+  const std::size_t num_vertices = compact->NumVertices();
+  if (selected(generator, "graph", "construction")) {
+    g_results.push_back({generator, "graph", "construction", num_vertices,
+                         compact->NumEdges(), build_seconds,
+                         build_peak_rss_kb});
+  }
+  if (selected(generator, "compact", "construction")) {
+    g_results.push_back({generator, "compact", "construction", num_vertices,
+                         compact->NumEdges(), snapshot_seconds,
+                         snapshot_peak_rss_kb});
+  }
+
+  const Graph* g = graph.get();
+  const CompactGraph* c = compact.get();
+  const Vertex* root = g->GetVertexPtr(0);
+  SearchState state(num_vertices);
+
+  state.Reset();
+  run(generator, "graph", "bfs", *c, [&] { graphlib::bfs(g, root, &state); });
+  state.Reset();
+  run(generator, "compact", "bfs", *c,
+      [&] { graphlib::bfs(c, root, &state); });
+  run(generator, "compact", "parallel_bfs", *c,
+      [&] { graphlib::parallel_bfs(c, root); });
+
+  run(generator, "compact", "connected_components", *c,
+      [&] { graphlib::connected_components(c); });
+  run(generator, "compact", "parallel_connected_components", *c,
+      [&] { graphlib::parallel_component_ids(c); });
+
+  state.Reset();
+  run(generator, "graph", "dfs", *c, [&] { graphlib::dfs_graph(g, &state); });
+  state.Reset();
+  run(generator, "compact", "dfs", *c,
+      [&] { graphlib::dfs_graph(c, &state); });
+  run(generator, "graph", "strong_components", *c,
+      [&] { graphlib::strong_components(g); });
+  run(generator, "compact", "strong_components", *c,
+      [&] { graphlib::strong_components(c); });
+  run(generator, "compact", "parallel_strong_components", *c,
+      [&] { graphlib::parallel_strong_component_ids(c); });
+
+  state.Reset();
+  run(generator, "graph", "dijkstra", *c,
+      [&] { graphlib::dijkstra(g, root, &state); });
+  state.Reset();
+  run(generator, "compact", "dijkstra", *c,
+      [&] { graphlib::dijkstra(c, root, &state); });
+  run(generator, "compact", "delta_stepping", *c,
+      [&] { graphlib::delta_stepping(c, root, &state); });
+
+  // Point-to-point searches, between a fixed sample of pairs of vertices.
+  std::vector<std::pair<const Vertex*, const Vertex*>> pairs;
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<graphlib::VertexId> vertex_distribution(
+      0, num_vertices - 1);
+  for (std::size_t i = 0; i != kNumPointToPointPairs; ++i) {
+    pairs.emplace_back(g->GetVertexPtr(vertex_distribution(rng)),
+                       g->GetVertexPtr(vertex_distribution(rng)));
+  }
+  run(generator, "compact", "point_to_point_dijkstra", *c, [&] {
+    for (const auto& pair : pairs) {
+      graphlib::astar(c, pair.first, &state, pair.second);
+    }
+  });
+  run(generator, "compact", "bidirectional_dijkstra", *c, [&] {
+    for (const auto& pair : pairs) {
+      graphlib::bidirectional_astar(c, pair.first, &state, pair.second);
+    }
+  });
+  std::vector<graphlib::PathQuery> batch;
+  for (std::size_t i = 0; i != kNumBatchPathQueries; ++i) {
+    batch.push_back({g->GetVertexPtr(i % kNumBatchPathSources * num_vertices /
+                                     kNumBatchPathSources),
+                     g->GetVertexPtr(vertex_distribution(rng))});
+  }
+  run(generator, "compact", "shortest_pos_weight_path", *c, [&] {
+    for (const graphlib::PathQuery& query : batch) {
+      graphlib::shortest_pos_weight_path(c, query.source_, query.destination_);
+    }
+  });
+  run(generator, "compact", "shortest_pos_weight_paths", *c,
+      [&] { graphlib::shortest_pos_weight_paths(c, batch); });
+  std::unique_ptr<graphlib::Landmarks> landmarks;
+  run(generator, "compact", "alt_landmarks", *c, [&] {
+    landmarks = std::make_unique<graphlib::Landmarks>(*c, kNumLandmarks);
+  });
+  if (landmarks) {
+    run(generator, "compact", "alt", *c, [&] {
+      for (const auto& pair : pairs) {
+        graphlib::astar(c, pair.first, &state, pair.second,
+                        std::cref(*landmarks));
+      }
+    });
+    run(generator, "compact", "bidirectional_alt", *c, [&] {
+      for (const auto& pair : pairs) {
+        graphlib::bidirectional_astar(c, pair.first, &state, pair.second,
+                                      std::cref(*landmarks));
+      }
+    });
+  }
+  if ((generator == "grid" || generator == "random_geometric") &&
+      num_vertices <= kMaxVerticesContractionHierarchy) {
+    std::unique_ptr<graphlib::ContractionHierarchy> hierarchy;
+    run(generator, "compact", "contraction_hierarchy", *c, [&] {
+      hierarchy = std::make_unique<graphlib::ContractionHierarchy>(*c);
+    });
+    if (hierarchy) {
+      graphlib::ContractionHierarchy::QueryState query_state(num_vertices);
+      run(generator, "compact", "contraction_hierarchy_query", *c, [&] {
+        for (const auto& pair : pairs) {
+          hierarchy->Query(pair.first, pair.second, &query_state);
+          hierarchy->GetPath(query_state);
+        }
+      });
+    }
+  }
+  if constexpr (std::is_same_v<decltype(graph), std::unique_ptr<Graph2d>>) {
+    run(generator, "graph", "astar", *c, [&] {
+      for (const auto& pair : pairs) {
+        graphlib::astar(graph.get(), pair.first, &state, pair.second);
+      }
+    });
+    run(generator, "graph", "bidirectional_astar", *c, [&] {
+      for (const auto& pair : pairs) {
+        graphlib::bidirectional_astar(graph.get(), pair.first, &state,
+                                      pair.second);
+      }
+    });
+    run(generator, "compact", "astar", *c, [&] {
+      for (const auto& pair : pairs) {
+        graphlib::astar(c, pair.first, &state, pair.second,
+                        graphlib::distance_2d_heuristic);
+      }
+    });
+    run(generator, "compact", "bidirectional_astar", *c, [&] {
+      for (const auto& pair : pairs) {
+        graphlib::bidirectional_astar(c, pair.first, &state, pair.second,
+                                      graphlib::distance_2d_heuristic);
+      }
+    });
+
+    // Spatial queries around random points, spread over the same square as
+    // the vertices.
+    std::vector<std::pair<double, double>> points;
+    std::uniform_real_distribution<double> coordinate_distribution(
+        0, std::sqrt(static_cast<double>(num_vertices)));
+    for (std::size_t i = 0; i != kNumSpatialQueries; ++i) {
+      points.emplace_back(coordinate_distribution(rng),
+                          coordinate_distribution(rng));
+    }
+    run(generator, "graph", "nearest_vertex", *c, [&] {
+      for (const auto& point : points) {
+        graph->NearestVertex(point.first, point.second);
+      }
+    });
+    run(generator, "graph", "nearest_vertices", *c, [&] {
+      for (const auto& point : points) {
+        graph->NearestVertices(point.first, point.second, 8);
+      }
+    });
+    run(generator, "graph", "vertices_within_radius", *c, [&] {
+      for (const auto& point : points) {
+        graph->VerticesWithinRadius(point.first, point.second, 2);
+      }
+    });
+  }
+
+  state.Reset();
+  run(generator, "graph", "bellman_ford", *c,
+      [&] { graphlib::bellman_ford(g, root, &state); });
+  state.Reset();
+  run(generator, "compact", "bellman_ford", *c,
+      [&] { graphlib::bellman_ford(c, root, &state); });
+
+  if (num_vertices <= kMaxVerticesFloydWarshallDense) {
+    run(generator, "graph", "floyd_warshall_dense", *c,
+        [&] { graphlib::floyd_warshall_dense(g); });
+    run(generator, "compact", "floyd_warshall_dense", *c,
+        [&] { graphlib::floyd_warshall_dense(c); });
+  }
+  if (num_vertices <= kMaxVerticesFloydWarshallMap) {
+    run(generator, "graph", "floyd_warshall", *c,
+        [&] { graphlib::floyd_warshall(g); });
+    run(generator, "compact", "floyd_warshall", *c,
+        [&] { graphlib::floyd_warshall(c); });
+  }
+
+  run(generator, "graph", "prim", *c, [&] { graphlib::prim_mst(g); });
+  run(generator, "compact", "prim", *c, [&] { graphlib::prim_mst(c); });
+  run(generator, "graph", "kruskal", *c, [&] { graphlib::kruskal_mst(g); });
+  run(generator, "compact", "kruskal", *c, [&] { graphlib::kruskal_mst(c); });
+  run(generator, "graph", "boruvka", *c, [&] { graphlib::boruvka_msf(g); });
+  run(generator, "compact", "boruvka", *c, [&] { graphlib::boruvka_msf(c); });
+  if constexpr (std::is_same_v<decltype(graph), std::unique_ptr<Graph2d>>) {
+    run(generator, "graph", "euclidean_mst", *c,
+        [&] { graphlib::euclidean_mst(graph.get()); });
+  }
+}
+
+std::string to_json(const std::vector<BenchResult>& results) {
+  std::ostringstream json;
+  json.precision(9);
+  json << "{\n  \"build_type\": \"" << GRAPHLIB_BUILD_TYPE << "\",\n";
+  json << "  \"results\": [";
+  for (std::size_t i = 0; i != results.size(); ++i) {
+    const BenchResult& r = results[i];
+    json << (i ? ",\n" : "\n") << "    {\"generator\": \"" << r.generator
+         << "\", \"representation\": \"" << r.representation
+         << "\", \"operation\": \"" << r.operation
+         << "\", \"vertices\": " << r.num_vertices
+         << ", \"edges\": " << r.num_edges << ", \"seconds\": " << r.seconds
+         << ", \"edges_per_sec\": "
+         << (r.seconds > 0 ? r.num_edges / r.seconds : 0)
+         << ", \"peak_rss_kb\": " << r.peak_rss_kb << '}';
+  }
+  json << "\n  ]\n}\n";
+  return json.str();
+}
+
+int main(int argc, char** argv) {
+  unsigned min_scale = 8, max_scale = 16;
+  for (int i = 1; i != argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg.rfind("--min-scale=", 0) == 0) {
+      min_scale = std::stoul(arg.substr(12));
+    } else if (arg.rfind("--max-scale=", 0) == 0) {
+      max_scale = std::stoul(arg.substr(12));
+    } else if (arg.rfind("--filter=", 0) == 0) {
+      g_filter = arg.substr(9);
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--min-scale=N] [--max-scale=N] [--filter=TEXT]\n";
+      return 1;
+    }
+  }
+
+  for (unsigned scale = min_scale; scale <= max_scale; scale += 2) {
+    const std::size_t n = std::size_t(1) << scale;
+    bench_graph("erdos_renyi", [n] {
+      return graphlib::erdos_renyi_graph(n, 4 * n, false, 1);
+    });
+    bench_graph("rmat",
+                [scale] { return graphlib::rmat_graph(scale, 4, false, 2); });
+    bench_graph("grid", [scale] {
+      return graphlib::grid_graph(std::size_t(1) << (scale / 2),
+                                  std::size_t(1) << (scale - scale / 2), 3);
+    });
+    bench_graph("random_geometric", [n] {
+      return graphlib::random_geometric_graph(
+          n, graphlib::random_geometric_radius(8), 4);
+    });
+  }
+
+  std::cout << to_json(g_results);
+}
@@ -4,26 +4,40 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
+#include <queue>
 #include <stack>
+#include <vector>
 
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
 #include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
+#include "graphlib/union_find.hpp"
 
+using graphlib::BfsTree;
+using graphlib::CompactGraph;
+using graphlib::ConnectedComponents;
 using graphlib::Graph;
+using graphlib::SearchState;
 using graphlib::Vertex;
 
 void start_error_check() {
   Vertex v1("A"), v2("B"), v3("C");
   Graph graph({v1, v2, v3}, false);
+  SearchState state(graph.NumVertices());
 
   std::cout << "Not expecting error...\n\n";
-  graphlib::bfs(&graph, graph.GetVertexPtr(v1));
+  graphlib::bfs(&graph, graph.GetVertexPtr(v1), &state);
 
   std::cout << "Not expecting error...\n\n";
-  graphlib::bfs(&graph, graph.GetVertexPtr(Vertex("A")));
+  state.Reset();
+  graphlib::bfs(&graph, graph.GetVertexPtr(Vertex("A")), &state);
 
   std::cout << "Expecting error...\n";
   try {
-    graphlib::bfs(&graph, graph.GetVertexPtr(Vertex("D")));
+    state.Reset();
+    graphlib::bfs(&graph, graph.GetVertexPtr(Vertex("D")), &state);
   } catch (std::runtime_error e) {
     std::cout << "Caught runtime exception:\n" << e.what();
   }
@@ -36,12 +50,15 @@ void bfs_traverse_check() {
       {A, {D, E}}, {B, {}}, {D, {E}}, {E, {C}}};
   Graph graph(input_al, false);
 
-  std::cout << "Untraversed graph\n" << graph.GetVertexSetStr() << '\n';
-  graphlib::bfs(&graph, graph.GetVertexPtr(A), graphlib::print_vertex, nullptr,
-                nullptr);
+  SearchState state(graph.NumVertices());
+
+  std::cout << "Untraversed graph\n" << graphlib::to_string(graph, state)
+            << '\n';
+  graphlib::bfs(&graph, graph.GetVertexPtr(A), &state, graphlib::print_vertex,
+                nullptr, nullptr);
   // Here we're expecting all vertices connected to Vertex A to be in state
   // PROCESSED (2).
-  std::cout << "\nTraversed graph\n" << graph.GetVertexSetStr();
+  std::cout << "\nTraversed graph\n" << graphlib::to_string(graph, state);
 }
 
 void print_shortest_unweighted_path() {
@@ -115,6 +132,126 @@ void bipartite_check() {
             << graphlib::is_bipartite(&nonbipartite_graph) << '\n';
 }
 
+// Check a parallel_bfs result against hop distances from a plain sequential
+// BFS, and check that every parent is one hop closer to the root along an edge.
+bool valid_bfs_tree(const CompactGraph& graph, graphlib::VertexId root,
+                    const BfsTree& tree) {
+  std::vector<int> hops(graph.NumVertices(), -1);
+  std::queue<graphlib::VertexId> q;
+  hops[root] = 0;
+  q.push(root);
+  while (!q.empty()) {
+    graphlib::VertexId v1 = q.front();
+    q.pop();
+    for (std::size_t e = graph.EdgeBegin(v1); e != graph.EdgeEnd(v1); ++e) {
+      if (hops[graph.GetTarget(e)] == -1) {
+        hops[graph.GetTarget(e)] = hops[v1] + 1;
+        q.push(graph.GetTarget(e));
+      }
+    }
+  }
+  if (tree.hops_ != hops) return false;
+
+  for (graphlib::VertexId v = 0;
+       v != static_cast<graphlib::VertexId>(graph.NumVertices()); ++v) {
+    graphlib::VertexId parent = tree.parent_[v];
+    if (v == root || hops[v] == -1) {
+      if (parent != graphlib::kNoVertex) return false;
+      continue;
+    }
+    if (parent == graphlib::kNoVertex || hops[parent] != hops[v] - 1) {
+      return false;
+    }
+    bool has_edge = false;
+    for (std::size_t e = graph.EdgeBegin(parent); e != graph.EdgeEnd(parent);
+         ++e) {
+      has_edge |= graph.GetTarget(e) == v;
+    }
+    if (!has_edge) return false;
+  }
+  return true;
+}
+
+void parallel_bfs_check() {
+  std::unique_ptr<Graph> social = graphlib::rmat_graph(14, 8, false, 1);
+  std::unique_ptr<Graph> directed =
+      graphlib::erdos_renyi_graph(1 << 14, 1 << 16, true, 2);
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(100, 200, 3);
+  for (const auto& graph : {social.get(), directed.get(), grid.get()}) {
+    CompactGraph compact(*graph);
+    const Vertex* root = graph->GetVertexPtr(0);
+    for (unsigned num_threads : {1u, 4u}) {
+      BfsTree tree = graphlib::parallel_bfs(&compact, root, num_threads);
+      std::cout << "V=" << compact.NumVertices() << " E=" << compact.NumEdges()
+                << " threads=" << num_threads
+                << " valid: " << valid_bfs_tree(compact, 0, tree) << '\n';
+    }
+  }
+
+  // Same result with a precomputed reverse graph.
+  CompactGraph compact(*directed);
+  CompactGraph reverse = compact.GetReverseGraph();
+  BfsTree tree = graphlib::parallel_bfs(&compact, directed->GetVertexPtr(0), 0,
+                                        &reverse);
+  std::cout << "given reverse graph valid: " << valid_bfs_tree(compact, 0, tree)
+            << '\n';
+}
+
+// The component ids parallel_component_ids should give: connected_components
+// lists components in order of their smallest VertexId. For a directed graph,
+// weak components come from a sequential UnionFind over every edge instead.
+std::vector<int> expected_component_ids(const CompactGraph& graph) {
+  std::vector<int> ids(graph.NumVertices(), -1);
+  if (!graph.IsDirected()) {
+    int id = 0;
+    for (const auto& component : graphlib::connected_components(&graph)) {
+      for (const Vertex* v : component) ids[v->id_] = id;
+      ++id;
+    }
+    return ids;
+  }
+
+  graphlib::UnionFind components(graph.NumVertices());
+  for (graphlib::VertexId v = 0;
+       v != static_cast<graphlib::VertexId>(graph.NumVertices()); ++v) {
+    for (std::size_t e = graph.EdgeBegin(v); e != graph.EdgeEnd(v); ++e) {
+      components.Union(v, graph.GetTarget(e));
+    }
+  }
+  std::vector<int> root_ids(graph.NumVertices(), -1);
+  int num_ids = 0;
+  for (graphlib::VertexId v = 0;
+       v != static_cast<graphlib::VertexId>(graph.NumVertices()); ++v) {
+    int& root_id = root_ids[components.Find(v)];
+    if (root_id == -1) root_id = num_ids++;
+    ids[v] = root_id;
+  }
+  return ids;
+}
+
+void parallel_components_check() {
+  std::unique_ptr<Graph> social = graphlib::rmat_graph(14, 4, false, 1);
+  // Below the giant component threshold, so many small components.
+  std::unique_ptr<Graph> sparse =
+      graphlib::erdos_renyi_graph(1 << 14, 1 << 12, false, 2);
+  std::unique_ptr<Graph> directed =
+      graphlib::erdos_renyi_graph(1 << 14, 1 << 14, true, 3);
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(100, 200, 4);
+  for (const auto& graph :
+       {social.get(), sparse.get(), directed.get(), grid.get()}) {
+    CompactGraph compact(*graph);
+    std::vector<int> expected = expected_component_ids(compact);
+    for (unsigned num_threads : {1u, 2u, 4u}) {
+      ConnectedComponents components =
+          graphlib::parallel_component_ids(&compact, num_threads);
+      std::cout << "V=" << compact.NumVertices() << " E=" << compact.NumEdges()
+                << " threads=" << num_threads
+                << " components=" << components.num_components_ << " matches: "
+                << (components.component_id_ == expected) << '\n';
+    }
+  }
+}
+
 int main() {
   std::cout << "\n============\n";
   std::cout << "START_ERROR_CHECK\n\n";
@@ -135,4 +272,12 @@ int main() {
   std::cout << "\n============\n";
   std::cout << "BIPARTITE_CHECK\n\n";
   bipartite_check();
+
+  std::cout << "\n============\n";
+  std::cout << "PARALLEL_BFS_CHECK\n\n";
+  parallel_bfs_check();
+
+  std::cout << "\n============\n";
+  std::cout << "PARALLEL_COMPONENTS_CHECK\n\n";
+  parallel_components_check();
 }
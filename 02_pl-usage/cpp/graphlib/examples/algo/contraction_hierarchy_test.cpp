@@ -0,0 +1,164 @@
+// Quick ad-hoc tests for contraction hierarchies, against Dijkstra's algorithm.
+
+#include "graphlib/algo/contraction_hierarchy.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stack>
+#include <stdexcept>
+#include <string>
+
+#include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
+#include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
+#include "path_checks.hpp"
+
+using graphlib::CompactGraph;
+using graphlib::ContractionHierarchy;
+using graphlib::Graph;
+using graphlib::SearchState;
+using graphlib::Vertex;
+
+void tiny_ewd_hierarchy() {
+  // "tiny_ewd" graph example provided in Sedgewick.
+  // See expected results in Sedgewick (p.653)
+  Vertex v0("0"), v1("1"), v2("2"), v3("3"), v4("4"), v5("5"), v6("6"), v7("7");
+  Graph::InputWeightedAL al = {{v0, {{v4, 0.38}, {v2, 0.26}}},
+                               {v1, {{v3, 0.29}}},
+                               {v2, {{v7, 0.34}}},
+                               {v3, {{v6, 0.52}}},
+                               {v4, {{v5, 0.35}, {v7, 0.37}}},
+                               {v5, {{v4, 0.35}, {v7, 0.28}, {v1, 0.32}}},
+                               {v6, {{v2, 0.4}, {v0, 0.58}, {v4, 0.93}}},
+                               {v7, {{v5, 0.28}, {v3, 0.39}}}};
+  Graph tiny_ewd(al, true);
+  ContractionHierarchy hierarchy(tiny_ewd);
+  std::cout << "shortcuts: " << hierarchy.NumShortcuts() << "\n\n";
+
+  for (const Vertex& destination : {v1, v3, v6}) {
+    std::cout << "Shortest weighted path from 0 to " << destination.name_
+              << ":\n";
+    print_path(graphlib::shortest_pos_weight_path(
+        &hierarchy, tiny_ewd.GetVertexPtr(v0),
+        tiny_ewd.GetVertexPtr(destination)));
+    std::cout << '\n';
+  }
+}
+
+// Queries between random pairs of vertices (reusing one QueryState) should find
+// the same distances as Dijkstra's algorithm, and unpack into paths of the
+// graph's own edges that are that long, from source to destination.
+void hierarchy_check(const std::string& name, const Graph& graph) {
+  ContractionHierarchy hierarchy(graph);
+  const graphlib::VertexId num_vertices = graph.NumVertices();
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<graphlib::VertexId> vertex_distribution(
+      0, num_vertices - 1);
+  SearchState reference(num_vertices);
+  ContractionHierarchy::QueryState state(num_vertices);
+  bool matches_dijkstra = true;
+  int unreachable = 0;
+  for (int query = 0; query != 200; ++query) {
+    const Vertex* root = graph.GetVertexPtr(vertex_distribution(rng));
+    const Vertex* destination =
+        query % 50 == 0 ? root : graph.GetVertexPtr(vertex_distribution(rng));
+    graphlib::dijkstra(&graph, root, &reference);
+    double expected = reference.dist_to_root_[destination->id_];
+    double dist = hierarchy.Query(root, destination, &state);
+    std::stack<const Vertex*> path = hierarchy.GetPath(state);
+
+    if (expected == std::numeric_limits<double>::infinity()) {
+      ++unreachable;
+      matches_dijkstra &= dist == expected && path.empty();
+    } else {
+      matches_dijkstra &= std::abs(dist - expected) < 1e-9 &&
+                          state.Distance() == dist &&
+                          path.top() == root &&
+                          std::abs(path_length(graph, path) - expected) < 1e-9;
+      while (path.size() > 1) path.pop();
+      matches_dijkstra &= path.top() == destination;
+    }
+  }
+  std::cout << name << ": V=" << num_vertices
+            << ", shortcuts: " << hierarchy.NumShortcuts()
+            << ", unreachable pairs: " << unreachable
+            << ", matches dijkstra: " << matches_dijkstra << '\n';
+}
+
+void random_hierarchies_check() {
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(60, 80, 3);
+  hierarchy_check("grid", *grid);
+  std::unique_ptr<graphlib::Graph2d> geometric =
+      graphlib::random_geometric_graph(
+          1 << 13, graphlib::random_geometric_radius(8), 5);
+  hierarchy_check("random geometric", *geometric);
+  std::unique_ptr<Graph> directed =
+      graphlib::erdos_renyi_graph(2000, 5000, true, 6);
+  hierarchy_check("directed erdos renyi", *directed);
+
+  // The CompactGraph constructor gives the same hierarchy.
+  CompactGraph compact(*grid);
+  ContractionHierarchy from_graph(*grid), from_compact(compact);
+  std::cout << "same shortcuts from compact graph: "
+            << (from_graph.NumShortcuts() == from_compact.NumShortcuts())
+            << "\n\n";
+}
+
+void negative_weight_check() {
+  Vertex v0("0"), v1("1");
+  Graph::InputWeightedAL al = {{v0, {{v1, -1}}}};
+  Graph graph(al, true);
+  std::cout << "Expecting error...\n";
+  try {
+    ContractionHierarchy hierarchy(graph);
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+}
+
+// Queries only take vertices of the hierarchy's own graph, and a QueryState of
+// its size.
+void query_error_check() {
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(4, 5, 1);
+  std::unique_ptr<Graph> other = graphlib::grid_graph(4, 5, 1);
+  ContractionHierarchy hierarchy(*grid);
+  ContractionHierarchy::QueryState state(hierarchy.NumVertices());
+  const Vertex* source = grid->GetVertexPtr(0);
+  Vertex outside("outside");
+  ContractionHierarchy::QueryState small_state(3);
+  auto expect_error = [](auto query) {
+    std::cout << "Expecting error...\n";
+    try {
+      query();
+    } catch (const std::runtime_error& e) {
+      std::cout << "Caught runtime exception:\n" << e.what();
+    }
+  };
+  expect_error([&] { hierarchy.Query(source, &outside, &state); });
+  expect_error(
+      [&] { hierarchy.Query(other->GetVertexPtr(0), source, &state); });
+  expect_error([&] { hierarchy.Query(source, source, &small_state); });
+}
+
+int main() {
+  std::cout << "\n=============\n";
+  std::cout << "TINY_EWD_HIERARCHY\n\n";
+  tiny_ewd_hierarchy();
+
+  std::cout << "\n=============\n";
+  std::cout << "RANDOM_HIERARCHIES_CHECK\n\n";
+  random_hierarchies_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "NEGATIVE_WEIGHT_CHECK\n\n";
+  negative_weight_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "QUERY_ERROR_CHECK\n\n";
+  query_error_check();
+}
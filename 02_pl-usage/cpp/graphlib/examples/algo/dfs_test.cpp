@@ -3,10 +3,22 @@
 #include "graphlib/algo/dfs.hpp"
 
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "graphlib/algo/bfs.hpp"
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
 #include "graphlib/graph.hpp"
+#include "graphlib/graph_builder.hpp"
+#include "graphlib/search_state.hpp"
 
+using graphlib::CompactGraph;
 using graphlib::Graph;
+using graphlib::SearchState;
 using graphlib::Vertex;
 
 void cycle_detection_check() {
@@ -74,6 +86,238 @@ void print_strong_components() {
   }
 }
 
+// A path far deeper than the call stack would allow a recursive DFS to go.
+// Searching from one end, vertex i is entered at time i + 1 and left at time
+// 2n - i.
+void deep_path_check() {
+  const int n = 1000000;
+  graphlib::GraphBuilder builder(true);
+  for (int i = 0; i != n; ++i) builder.AddVertex(std::to_string(i));
+  for (int i = 0; i + 1 != n; ++i) {
+    builder.AddEdge(std::to_string(i), std::to_string(i + 1));
+  }
+  std::unique_ptr<Graph> path = builder.Build();
+  CompactGraph compact(*path);
+
+  auto valid_times = [n](const SearchState& state) {
+    for (int i = 0; i != n; ++i) {
+      if (state.entry_time_[i] != i + 1 || state.exit_time_[i] != 2 * n - i) {
+        return false;
+      }
+    }
+    return true;
+  };
+  SearchState state(n);
+  graphlib::dfs_graph(path.get(), &state);
+  std::cout << "path of " << n << " vertices, entry/exit times valid: "
+            << valid_times(state);
+  state.Reset();
+  graphlib::dfs_graph(&compact, &state);
+  std::cout << ", compact valid: " << valid_times(state) << '\n';
+
+  std::cout << "strong components: "
+            << graphlib::strong_component_ids(path.get()).num_components_
+            << ", compact: "
+            << graphlib::strong_component_ids(&compact).num_components_
+            << '\n';
+}
+
+// Results of several algorithms built on BFS and DFS, to compare runs.
+struct DerivedResults {
+  bool cyclic, dag_cyclic, bipartite;
+  std::size_t num_topo_sorted, num_strong_components,
+      num_connected_components;
+
+  bool operator==(const DerivedResults& other) const {
+    return cyclic == other.cyclic && dag_cyclic == other.dag_cyclic &&
+           bipartite == other.bipartite &&
+           num_topo_sorted == other.num_topo_sorted &&
+           num_strong_components == other.num_strong_components &&
+           num_connected_components == other.num_connected_components;
+  }
+};
+
+// Callbacks may capture local state, and may stop a search early by returning
+// false. Since the algorithms built on the traversals keep no global state,
+// several of them can run at once.
+void callback_check() {
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(20, 30, 1);
+  CompactGraph compact_grid(*grid);
+
+  SearchState state(grid->NumVertices());
+  int num_vertices = 0, num_tree_edges = 0, num_back_edges = 0;
+  graphlib::dfs(
+      grid.get(), grid->GetVertexPtr(0), &state,
+      [&](const Vertex* v) { ++num_vertices; },
+      [&](const Vertex* v1, const Vertex* v2, double weight) {
+        if (state.parent_[v2->id_] == v1->id_) {
+          ++num_tree_edges;
+        } else {
+          ++num_back_edges;
+        }
+      });
+  std::cout << "grid dfs vertices: " << num_vertices
+            << ", tree edges: " << num_tree_edges
+            << ", back edges: " << num_back_edges << '\n';
+
+  int num_discovered = 0;
+  auto discover_ten = [&](const Vertex* v) { return ++num_discovered < 10; };
+  state.Reset();
+  graphlib::dfs_graph(&compact_grid, &state, discover_ten);
+  std::cout << "dfs stopped after " << num_discovered << " vertices";
+  num_discovered = 0;
+  state.Reset();
+  graphlib::bfs(&compact_grid, grid->GetVertexPtr(0), &state, discover_ten);
+  std::cout << ", bfs stopped after " << num_discovered << " vertices\n";
+
+  // A DAG with edges from each vertex to the next and to the seventh next.
+  graphlib::GraphBuilder builder(true);
+  for (int v = 0; v != 500; ++v) {
+    builder.AddEdge(std::to_string(v), std::to_string(v + 1));
+    builder.AddEdge(std::to_string(v), std::to_string(v + 7));
+  }
+  std::unique_ptr<Graph> dag = builder.Build();
+  std::unique_ptr<Graph> random =
+      graphlib::erdos_renyi_graph(1000, 1500, true, 2);
+
+  auto run_all = [&] {
+    return DerivedResults{graphlib::is_cyclic(random.get()),
+                          graphlib::is_cyclic(dag.get()),
+                          graphlib::is_bipartite(&compact_grid),
+                          graphlib::topological_sort(dag.get()).size(),
+                          graphlib::strong_components(random.get()).size(),
+                          graphlib::connected_components(grid.get()).size()};
+  };
+  DerivedResults expected = run_all();
+  std::cout << "random graph cyclic: " << expected.cyclic
+            << ", dag cyclic: " << expected.dag_cyclic
+            << ", grid bipartite: " << expected.bipartite
+            << ", strong components: " << expected.num_strong_components
+            << '\n';
+
+  std::vector<DerivedResults> results(4);
+  std::vector<std::thread> threads;
+  for (DerivedResults& result : results) {
+    threads.emplace_back([&] { result = run_all(); });
+  }
+  for (std::thread& thread : threads) thread.join();
+  bool all_match = true;
+  for (const DerivedResults& result : results) {
+    all_match = all_match && result == expected;
+  }
+  std::cout << "concurrent runs match: " << all_match << '\n';
+}
+
+// Two vertices are in the same strongly connected component iff each can reach
+// the other. Check strong_component_ids against reachability found by a BFS
+// from every vertex, and check that edges never lead to a lower component id.
+void strong_component_ids_check() {
+  std::unique_ptr<Graph> graph =
+      graphlib::erdos_renyi_graph(300, 450, true, 3);
+  CompactGraph compact(*graph);
+  const int n = graph->NumVertices();
+
+  graphlib::StrongComponents components =
+      graphlib::strong_component_ids(graph.get());
+  graphlib::StrongComponents compact_components =
+      graphlib::strong_component_ids(&compact);
+
+  std::vector<std::vector<bool>> reachable(n);
+  for (int v = 0; v != n; ++v) {
+    SearchState state(n);
+    graphlib::bfs(&compact, compact.GetVertexPtr(v), &state);
+    for (int u = 0; u != n; ++u) {
+      reachable[v].push_back(state.state_[u] !=
+                             graphlib::VertexState::UNDISCOVERED);
+    }
+  }
+  bool matches_reachability = true, topological = true;
+  for (int v = 0; v != n; ++v) {
+    for (int u = 0; u != n; ++u) {
+      bool same_component =
+          components.component_id_[v] == components.component_id_[u];
+      if (same_component != (reachable[v][u] && reachable[u][v])) {
+        matches_reachability = false;
+      }
+    }
+    for (std::size_t e = compact.EdgeBegin(v); e != compact.EdgeEnd(v); ++e) {
+      if (components.component_id_[compact.GetTarget(e)] <
+          components.component_id_[v]) {
+        topological = false;
+      }
+    }
+  }
+  std::cout << "components: " << components.num_components_
+            << ", matches reachability: " << matches_reachability
+            << ", topologically numbered: " << topological
+            << ", compact matches: "
+            << (compact_components.component_id_ ==
+                components.component_id_)
+            << '\n';
+}
+
+// Renumbers components in order of their smallest VertexId, as
+// parallel_strong_component_ids does.
+std::vector<int> canonical_component_ids(
+    const graphlib::StrongComponents& components) {
+  std::vector<int> new_id(components.num_components_, -1), ids;
+  int next_id = 0;
+  for (int id : components.component_id_) {
+    if (new_id[id] == -1) new_id[id] = next_id++;
+    ids.push_back(new_id[id]);
+  }
+  return ids;
+}
+
+// parallel_strong_component_ids should find the same components as Tarjan's
+// algorithm, whatever the number of threads. The graph has 20 blocks of 2000
+// vertices with random edges inside, and edges from each block to the next
+// only. There's a giant component in each block, so after the first is found by
+// forward-backward search, enough vertices are left for the coloring phase.
+void parallel_strong_components_check() {
+  std::mt19937_64 rng(5);
+  const int kNumBlocks = 20, kBlockSize = 2000;
+  std::uniform_int_distribution<int> vertex_distribution(0, kBlockSize - 1);
+  graphlib::GraphBuilder builder(true);
+  for (int v = 0; v != kNumBlocks * kBlockSize; ++v) {
+    builder.AddVertex(std::to_string(v));
+  }
+  for (int block = 0; block != kNumBlocks; ++block) {
+    for (int i = 0; i != 2 * kBlockSize; ++i) {
+      int v1 = block * kBlockSize + vertex_distribution(rng);
+      int v2 = block * kBlockSize + vertex_distribution(rng);
+      builder.AddEdge(std::to_string(v1), std::to_string(v2));
+      if (block + 1 != kNumBlocks && i % 10 == 0) {
+        builder.AddEdge(std::to_string(v1),
+                        std::to_string(v2 + kBlockSize));
+      }
+    }
+  }
+  std::unique_ptr<Graph> blocks = builder.Build();
+  CompactGraph compact(*blocks);
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(30, 30, 1);
+  CompactGraph compact_grid(*grid);
+
+  for (const CompactGraph* graph : {&compact, &compact_grid}) {
+    std::vector<int> expected =
+        canonical_component_ids(graphlib::strong_component_ids(graph));
+    bool all_match = true;
+    graphlib::SccPhaseTimings timings;
+    for (unsigned num_threads : {1, 2, 4}) {
+      graphlib::StrongComponents components =
+          graphlib::parallel_strong_component_ids(graph, num_threads, nullptr,
+                                                  &timings);
+      all_match = all_match && components.component_id_ == expected;
+    }
+    std::cout << "vertices: " << graph->NumVertices()
+              << ", found by trim: " << timings.trim_vertices_
+              << ", forward-backward: " << timings.forward_backward_vertices_
+              << ", coloring: " << timings.coloring_vertices_
+              << ", serial: " << timings.serial_vertices_
+              << "\nmatches tarjan: " << all_match << '\n';
+  }
+}
+
 int main() {
   std::cout << "============\n";
   std::cout << "CYCLE_DETECTION_CHECK\n\n";
@@ -86,4 +330,14 @@ int main() {
   std::cout << "============\n";
   std::cout << "PRINT_STRONG_COMPONENTS\n\n";
   print_strong_components();
+  strong_component_ids_check();
+  parallel_strong_components_check();
+
+  std::cout << "============\n";
+  std::cout << "DEEP_PATH_CHECK\n\n";
+  deep_path_check();
+
+  std::cout << "============\n";
+  std::cout << "CALLBACK_CHECK\n\n";
+  callback_check();
 }
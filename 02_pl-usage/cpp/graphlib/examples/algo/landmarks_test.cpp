@@ -0,0 +1,251 @@
+// Quick ad-hoc tests for ALT landmarks, against Dijkstra's algorithm.
+
+#include "graphlib/algo/landmarks.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
+#include "graphlib/graph.hpp"
+#include "graphlib/graph_builder.hpp"
+#include "graphlib/search_state.hpp"
+#include "path_checks.hpp"
+
+using graphlib::CompactGraph;
+using graphlib::Graph;
+using graphlib::LandmarkSelection;
+using graphlib::Landmarks;
+using graphlib::SearchState;
+using graphlib::Vertex;
+
+void tiny_ewd_landmarks() {
+  // "tiny_ewd" graph example provided in Sedgewick (p.653).
+  Vertex v0("0"), v1("1"), v2("2"), v3("3"), v4("4"), v5("5"), v6("6"), v7("7");
+  Graph::InputWeightedAL al = {{v0, {{v4, 0.38}, {v2, 0.26}}},
+                               {v1, {{v3, 0.29}}},
+                               {v2, {{v7, 0.34}}},
+                               {v3, {{v6, 0.52}}},
+                               {v4, {{v5, 0.35}, {v7, 0.37}}},
+                               {v5, {{v4, 0.35}, {v7, 0.28}, {v1, 0.32}}},
+                               {v6, {{v2, 0.4}, {v0, 0.58}, {v4, 0.93}}},
+                               {v7, {{v5, 0.28}, {v3, 0.39}}}};
+  Graph tiny_ewd(al, true);
+  for (LandmarkSelection selection :
+       {LandmarkSelection::FARTHEST, LandmarkSelection::AVOID}) {
+    Landmarks landmarks(tiny_ewd, 2, selection);
+    std::cout << (selection == LandmarkSelection::FARTHEST ? "farthest"
+                                                           : "avoid")
+              << " landmarks:";
+    for (graphlib::VertexId landmark : landmarks.GetLandmarks()) {
+      std::cout << ' ' << tiny_ewd.GetVertexPtr(landmark)->name_;
+    }
+    std::cout << '\n';
+  }
+
+  // With every vertex a landmark, the lower bounds are the exact distances.
+  Landmarks all(tiny_ewd, 100);
+  const Vertex* root = tiny_ewd.GetVertexPtr(v0);
+  std::cout << "landmarks: " << all.NumLandmarks() << '\n';
+  for (const Vertex& destination : {v1, v3, v6}) {
+    std::cout << "lower bound from 0 to " << destination.name_ << ": "
+              << all(root, tiny_ewd.GetVertexPtr(destination)) << '\n';
+  }
+
+  // With no landmarks, every bound is 0, also after a round trip to a file.
+  Landmarks none(tiny_ewd, 0);
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "graphlib_landmarks_none.bin")
+          .string();
+  graphlib::write_landmark_file(none, path);
+  Landmarks loaded(path, tiny_ewd);
+  std::remove(path.c_str());
+  std::cout << "no landmarks, lower bound from 0 to 6: "
+            << none(root, tiny_ewd.GetVertexPtr(v6))
+            << ", loaded: " << loaded.NumLandmarks() << " landmarks, bound "
+            << loaded(root, tiny_ewd.GetVertexPtr(v6)) << '\n';
+}
+
+// Bounds should never exceed the true distances, from random roots.
+void lower_bound_check(const std::string& name, const Graph& graph,
+                       const Landmarks& landmarks) {
+  const graphlib::VertexId num_vertices = graph.NumVertices();
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<graphlib::VertexId> vertex_distribution(
+      0, num_vertices - 1);
+  SearchState state(num_vertices);
+  bool admissible = true;
+  for (int query = 0; query != 10; ++query) {
+    const graphlib::VertexId root = vertex_distribution(rng);
+    graphlib::dijkstra(&graph, graph.GetVertexPtr(root), &state);
+    for (graphlib::VertexId v = 0; v != num_vertices; ++v) {
+      admissible &= landmarks.LowerBound(root, v) <=
+                    state.dist_to_root_[v] + 1e-9;
+    }
+  }
+  std::cout << name << " lower bounds admissible: " << admissible << '\n';
+}
+
+// ALT searches with both ways of picking landmarks, against plain Dijkstra.
+void alt_check(const std::string& name, const Graph& graph) {
+  CompactGraph compact(graph);
+  CompactGraph reverse = compact.GetReverseGraph();
+  point_to_point_check(name + " dijkstra", graph,
+                       [&](auto root, auto dest, auto state) {
+                         graphlib::astar(&compact, root, state, dest);
+                       });
+  for (LandmarkSelection selection :
+       {LandmarkSelection::FARTHEST, LandmarkSelection::AVOID}) {
+    Landmarks landmarks(compact, 16, selection);
+    const std::string alt =
+        name + (selection == LandmarkSelection::FARTHEST ? " farthest"
+                                                         : " avoid");
+    lower_bound_check(alt, graph, landmarks);
+    point_to_point_check(alt + " alt", graph,
+                         [&](auto root, auto dest, auto state) {
+                           graphlib::astar(&compact, root, state, dest,
+                                           std::cref(landmarks));
+                         });
+    point_to_point_check(
+        alt + " bidirectional alt", graph,
+        [&](auto root, auto dest, auto state) {
+          graphlib::bidirectional_astar(&compact, root, state, dest,
+                                        std::cref(landmarks), &reverse);
+        });
+  }
+  std::cout << '\n';
+}
+
+void random_graphs_check() {
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(60, 80, 3);
+  alt_check("grid", *grid);
+  std::unique_ptr<Graph> directed =
+      graphlib::erdos_renyi_graph(2000, 6000, true, 6);
+  alt_check("directed erdos renyi", *directed);
+
+  // The Graph overloads of astar take Landmarks too.
+  Landmarks landmarks(*grid, 8);
+  point_to_point_check("grid graph alt", *grid,
+                       [&](auto root, auto dest, auto state) {
+                         graphlib::astar(grid.get(), root, state, dest,
+                                         std::cref(landmarks));
+                       });
+}
+
+// Landmarks written to a file load back the same, but only for their graph.
+void landmark_file_check() {
+  std::unique_ptr<Graph> directed =
+      graphlib::erdos_renyi_graph(500, 1500, true, 2);
+  Landmarks landmarks(*directed, 4);
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "graphlib_landmarks_test.bin")
+          .string();
+  graphlib::write_landmark_file(landmarks, path);
+
+  Landmarks loaded(path, *directed);
+  bool same = loaded.NumLandmarks() == landmarks.NumLandmarks() &&
+              loaded.GetLandmarks() == landmarks.GetLandmarks() &&
+              loaded.IsDirected();
+  for (graphlib::VertexId v = 0; v != 500; ++v) {
+    for (std::size_t i = 0; i != landmarks.NumLandmarks(); ++i) {
+      same &= loaded.DistanceFrom(i, v) == landmarks.DistanceFrom(i, v) &&
+              loaded.DistanceTo(i, v) == landmarks.DistanceTo(i, v);
+    }
+  }
+  std::cout << "loaded landmarks match: " << same << '\n';
+
+  auto expect_error = [&path](const Graph& graph) {
+    std::cout << "Expecting error...\n";
+    try {
+      Landmarks wrong(path, graph);
+    } catch (const std::runtime_error& e) {
+      std::string what = e.what();
+      std::cout << "Caught runtime exception:\n"
+                << what.substr(0, what.find(" (")) << '\n';
+    }
+  };
+  std::unique_ptr<Graph> other =
+      graphlib::erdos_renyi_graph(500, 1500, true, 3);
+  expect_error(*other);
+
+  // Overwrites the 8 bytes at the given position of the file.
+  auto patch = [&path](std::streamoff position, std::uint64_t value) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(position);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  // A landmark count too large for the graph, and a landmark id out of range.
+  patch(32, std::uint64_t(1) << 61);
+  expect_error(*directed);
+  graphlib::write_landmark_file(landmarks, path);
+  patch(48, 500);
+  expect_error(*directed);
+  std::remove(path.c_str());
+}
+
+// Edges of weight 0 put a vertex at the same distance from the root as its
+// parent. AVOID should still pick distinct landmarks with admissible bounds.
+void zero_weight_check() {
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(20, 20, 4);
+  graphlib::GraphBuilder builder(false);
+  for (const auto& adjacency : grid->GetAdjacencyMap()) {
+    for (const auto& adj : adjacency.second) {
+      // About half the edges get weight 0.
+      const bool zero = (adjacency.first->id_ + adj.first->id_) % 2 == 0;
+      builder.AddEdge(adjacency.first->name_, adj.first->name_,
+                      zero ? 0 : adj.second);
+    }
+  }
+  std::unique_ptr<Graph> graph = builder.Build();
+  Landmarks landmarks(*graph, 16);
+  std::vector<graphlib::VertexId> sorted = landmarks.GetLandmarks();
+  std::sort(sorted.begin(), sorted.end());
+  std::cout << "landmarks: " << landmarks.NumLandmarks() << ", distinct: "
+            << (std::unique(sorted.begin(), sorted.end()) == sorted.end())
+            << '\n';
+  lower_bound_check("zero weights", *graph, landmarks);
+}
+
+void negative_weight_check() {
+  Vertex v0("0"), v1("1");
+  Graph::InputWeightedAL al = {{v0, {{v1, -1}}}};
+  Graph graph(al, true);
+  std::cout << "Expecting error...\n";
+  try {
+    Landmarks landmarks(graph, 1);
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+}
+
+int main() {
+  std::cout << "\n=============\n";
+  std::cout << "TINY_EWD_LANDMARKS\n\n";
+  tiny_ewd_landmarks();
+
+  std::cout << "\n=============\n";
+  std::cout << "RANDOM_GRAPHS_CHECK\n\n";
+  random_graphs_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "LANDMARK_FILE_CHECK\n\n";
+  landmark_file_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "ZERO_WEIGHT_CHECK\n\n";
+  zero_weight_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "NEGATIVE_WEIGHT_CHECK\n\n";
+  negative_weight_check();
+}
@@ -2,13 +2,24 @@
 
 #include "graphlib/algo/mst.hpp"
 
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
+#include "graphlib/geometry/graph_2d.hpp"
 #include "graphlib/graph.hpp"
 
+using graphlib::CompactGraph;
 using graphlib::Edge;
 using graphlib::Graph;
 using graphlib::Vertex;
+using graphlib::Vertex2d;
 
 void tiny_ewg_mst() {
   // "tiny_ewg" graph example provided in Sedgewick.
@@ -32,7 +43,6 @@ void tiny_ewg_mst() {
   std::cout << '\n';
 
   std::cout << "MST found by Kruskal's algorithm:\n";
-  tiny_ewg.ResetState();
   std::vector<Edge> kruskals_output = graphlib::kruskal_mst(&tiny_ewg);
   for (const auto& e : kruskals_output) {
     std::cout << graphlib::to_string(e);
@@ -40,8 +50,162 @@ void tiny_ewg_mst() {
   std::cout << '\n';
 }
 
+double total_weight(const std::vector<Edge>& edges) {
+  double weight = 0;
+  for (const Edge& e : edges) weight += e.weight_;
+  return weight;
+}
+
+bool same_edges(const std::vector<Edge>& lhs, const std::vector<Edge>& rhs) {
+  if (lhs.size() != rhs.size()) return false;
+  for (std::size_t i = 0; i != lhs.size(); ++i) {
+    if (lhs[i].v1_ != rhs[i].v1_ || lhs[i].v2_ != rhs[i].v2_ ||
+        lhs[i].weight_ != rhs[i].weight_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void large_mst_check() {
+  // Large enough for the edge sort to be split across threads.
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(300, 300, 1);
+  CompactGraph compact(*grid);
+
+  std::vector<Edge> one_thread = graphlib::kruskal_mst(&compact, 1);
+  std::vector<Edge> four_threads = graphlib::kruskal_mst(&compact, 4);
+  std::vector<Edge> graph_kruskal = graphlib::kruskal_mst(grid.get(), 4);
+  std::vector<Edge> prim = graphlib::prim_mst(&compact);
+  std::cout << "kruskal edges: " << one_thread.size()
+            << ", same for 1 and 4 threads: "
+            << same_edges(one_thread, four_threads)
+            << ", same for Graph and CompactGraph: "
+            << same_edges(one_thread, graph_kruskal) << '\n';
+  std::cout << "same weight as prim: "
+            << (std::abs(total_weight(one_thread) - total_weight(prim)) < 1e-6)
+            << '\n';
+
+  std::vector<Edge> boruvka = graphlib::boruvka_msf(&compact, 1);
+  std::cout << "boruvka edges: " << boruvka.size()
+            << ", same for 1 and 4 threads: "
+            << same_edges(boruvka, graphlib::boruvka_msf(&compact, 4))
+            << ", same for Graph and CompactGraph: "
+            << same_edges(boruvka, graphlib::boruvka_msf(grid.get(), 4))
+            << ", same weight as kruskal: "
+            << (std::abs(total_weight(boruvka) - total_weight(one_thread)) <
+                1e-6)
+            << '\n';
+
+  // A sparse random geometric graph has many components; Boruvka's algorithm
+  // should find the same spanning forest weight as Kruskal's.
+  std::unique_ptr<graphlib::Graph2d> geometric =
+      graphlib::random_geometric_graph(20000, 0.6, 2);
+  std::vector<Edge> geometric_kruskal = graphlib::kruskal_mst(geometric.get());
+  std::vector<Edge> geometric_boruvka = graphlib::boruvka_msf(geometric.get());
+  std::cout << "geometric forest edges: kruskal " << geometric_kruskal.size()
+            << ", boruvka " << geometric_boruvka.size() << ", same weight: "
+            << (std::abs(total_weight(geometric_kruskal) -
+                         total_weight(geometric_boruvka)) < 1e-6)
+            << '\n';
+
+  // Two components give a spanning forest.
+  Vertex a("a"), b("b"), c("c"), d("d");
+  Graph forest({{a, {{b, 1}}}, {c, {{d, 2}}}}, false);
+  std::cout << "spanning forest (kruskal):\n";
+  for (const auto& e : graphlib::kruskal_mst(&forest)) {
+    std::cout << graphlib::to_string(e);
+  }
+  std::cout << "spanning forest (boruvka):\n";
+  for (const auto& e : graphlib::boruvka_msf(&forest)) {
+    std::cout << graphlib::to_string(e);
+  }
+}
+
+// Weight of the Euclidean MST of the given points, by Prim's algorithm on the
+// complete graph (in O(n^2) time, without a heap).
+double brute_force_euclidean_mst_weight(
+    const std::vector<const Vertex2d*>& points) {
+  const std::size_t n = points.size();
+  std::vector<double> dist(n, std::numeric_limits<double>::infinity());
+  std::vector<bool> in_tree(n, false);
+  double weight = 0;
+  for (std::size_t added = 0; added != n; ++added) {
+    std::size_t next = 0;
+    while (in_tree[next]) ++next;
+    for (std::size_t i = next; i != n; ++i) {
+      if (!in_tree[i] && dist[i] < dist[next]) next = i;
+    }
+    in_tree[next] = true;
+    if (added) weight += dist[next];
+    for (std::size_t i = 0; i != n; ++i) {
+      dist[i] = std::min(dist[i], graphlib::distance_2d(*points[i],
+                                                        *points[next]));
+    }
+  }
+  return weight;
+}
+
+void euclidean_mst_check() {
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> real_distribution(-100, 100);
+  std::uniform_int_distribution<int> int_distribution(0, 12);
+  std::vector<Vertex2d> uniform, lattice, repeats, collinear, few;
+  for (int i = 0; i != 2000; ++i) {
+    uniform.emplace_back(real_distribution(rng), real_distribution(rng));
+  }
+  // Many points on a common circle, and many equal distances.
+  for (int i = 0; i != 30; ++i) {
+    for (int j = 0; j != 30; ++j) lattice.emplace_back(i, j);
+  }
+  // Many copies of the same points.
+  for (int i = 0; i != 500; ++i) {
+    repeats.emplace_back(int_distribution(rng), int_distribution(rng));
+  }
+  for (int i = 0; i != 50; ++i) {
+    double x = int_distribution(rng) + i / 50.0;
+    collinear.emplace_back(x, 2 * x + 1);
+  }
+  few.emplace_back(0, 0);
+  few.emplace_back(3, 4);
+
+  for (const auto& [name, vertices] :
+       {std::make_pair("uniform", &uniform),
+        std::make_pair("lattice", &lattice),
+        std::make_pair("repeats", &repeats),
+        std::make_pair("collinear", &collinear),
+        std::make_pair("two points", &few)}) {
+    std::vector<const Vertex2d*> points;
+    for (const Vertex2d& v : *vertices) points.push_back(&v);
+    std::vector<Edge> mst = graphlib::euclidean_mst(points);
+    std::cout << name << ": edges " << mst.size() << " of " << points.size()
+              << " points, same weight as brute force: "
+              << (std::abs(total_weight(mst) -
+                           brute_force_euclidean_mst_weight(points)) < 1e-6)
+              << '\n';
+  }
+
+  // On the vertices of a Graph2d, the same weight as Kruskal's algorithm on
+  // the complete graph.
+  graphlib::Graph2d complete(false);
+  for (int i = 0; i != 200; ++i) {
+    for (int j = 0; j != i; ++j) complete.AddEdge(uniform[i], uniform[j]);
+  }
+  std::cout << "graph2d: same weight as kruskal on complete graph: "
+            << (std::abs(total_weight(graphlib::euclidean_mst(&complete)) -
+                         total_weight(graphlib::kruskal_mst(&complete))) < 1e-6)
+            << "\n\n";
+}
+
 int main() {
   std::cout << "=============\n";
   std::cout << "TINY_EWG_MST\n\n";
   tiny_ewg_mst();
+
+  std::cout << "=============\n";
+  std::cout << "LARGE_MST_CHECK\n\n";
+  large_mst_check();
+
+  std::cout << "=============\n";
+  std::cout << "EUCLIDEAN_MST_CHECK\n\n";
+  euclidean_mst_check();
 }
@@ -2,11 +2,27 @@
 
 #include "graphlib/algo/weighted_paths.hpp"
 
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stack>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
 #include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
+#include "path_checks.hpp"
 
+using graphlib::CompactGraph;
+using graphlib::DenseDistanceMatrix;
 using graphlib::Graph;
+using graphlib::Graph2d;
+using graphlib::SearchState;
 using graphlib::Vertex;
 
 void tiny_ewd_dijkstras() {
@@ -25,10 +41,12 @@ void tiny_ewd_dijkstras() {
 
   std::cout << "Shortest paths parent tree:\n";
   std::cout << "search root: " << v0.name_ << '\n';
-  graphlib::dijkstra(&tiny_ewd, tiny_ewd.GetVertexPtr(v0));
+  SearchState state(tiny_ewd.NumVertices());
+  graphlib::dijkstra(&tiny_ewd, tiny_ewd.GetVertexPtr(v0), &state);
   for (const auto& v : tiny_ewd.GetAdjacencyMap()) {
     if (v.first != tiny_ewd.GetVertexPtr(v0)) {
-      std::cout << v.first->name_ << " parent: " << v.first->parent_->name_
+      std::cout << v.first->name_ << " parent: "
+                << tiny_ewd.GetVertexPtr(state.parent_[v.first->id_])->name_
                 << '\n';
     }
   }
@@ -87,10 +105,12 @@ void tiny_ewdn_bellman() {
 
   std::cout << "Shortest paths parent tree:\n";
   std::cout << "search root: " << v0.name_ << '\n';
-  graphlib::bellman_ford(&tiny_ewdn, tiny_ewdn.GetVertexPtr(v0));
+  SearchState state(tiny_ewdn.NumVertices());
+  graphlib::bellman_ford(&tiny_ewdn, tiny_ewdn.GetVertexPtr(v0), &state);
   for (const auto& v : tiny_ewdn.GetAdjacencyMap()) {
     if (v.first != tiny_ewdn.GetVertexPtr(v0)) {
-      std::cout << v.first->name_ << " parent: " << v.first->parent_->name_
+      std::cout << v.first->name_ << " parent: "
+                << tiny_ewdn.GetVertexPtr(state.parent_[v.first->id_])->name_
                 << '\n';
     }
   }
@@ -133,6 +153,246 @@ void floyd_warshall_test() {
   std::cout << '\n';
 }
 
+// The blocked Floyd-Warshall kernel should agree with Dijkstra's algorithm run
+// from every vertex, regardless of thread count (and on a vertex count that
+// isn't a multiple of the block size).
+void floyd_warshall_dense_check() {
+  std::unique_ptr<Graph> graph = graphlib::erdos_renyi_graph(300, 900, true, 1);
+  CompactGraph compact(*graph);
+  DenseDistanceMatrix one_thread = graphlib::floyd_warshall_dense(&compact, 1);
+  DenseDistanceMatrix four_threads =
+      graphlib::floyd_warshall_dense(graph.get(), 4);
+
+  bool matches_dijkstra = true, same_for_threads = true;
+  SearchState state(graph->NumVertices());
+  for (graphlib::VertexId v1 = 0; v1 != 300; ++v1) {
+    graphlib::dijkstra(&compact, compact.GetVertexPtr(v1), &state);
+    for (graphlib::VertexId v2 = 0; v2 != 300; ++v2) {
+      if (std::abs(one_thread.Get(v1, v2) - state.dist_to_root_[v2]) > 1e-9 &&
+          one_thread.Get(v1, v2) != state.dist_to_root_[v2]) {
+        matches_dijkstra = false;
+      }
+      if (one_thread.Get(v1, v2) != four_threads.Get(v1, v2)) {
+        same_for_threads = false;
+      }
+    }
+  }
+  std::cout << "matches dijkstra: " << matches_dijkstra
+            << ", same for 1 and 4 threads: " << same_for_threads << "\n\n";
+}
+
+void astar_check() {
+  std::unique_ptr<Graph2d> geometric = graphlib::random_geometric_graph(
+      1 << 14, graphlib::random_geometric_radius(8), 5);
+  const Graph2d* g = geometric.get();
+  CompactGraph compact(*geometric);
+
+  point_to_point_check("dijkstra", *g, [&](auto root, auto dest, auto state) {
+    graphlib::astar(static_cast<const Graph*>(g), root, state, dest);
+  });
+  point_to_point_check("astar", *g, [&](auto root, auto dest, auto state) {
+    graphlib::astar(g, root, state, dest);
+  });
+  point_to_point_check(
+      "compact astar", *g, [&](auto root, auto dest, auto state) {
+        graphlib::astar(&compact, root, state, dest,
+                        graphlib::distance_2d_heuristic);
+      });
+  point_to_point_check(
+      "bidirectional dijkstra", *g, [&](auto root, auto dest, auto state) {
+        graphlib::bidirectional_astar(static_cast<const Graph*>(g), root,
+                                      state, dest);
+      });
+  point_to_point_check(
+      "bidirectional astar", *g, [&](auto root, auto dest, auto state) {
+        graphlib::bidirectional_astar(g, root, state, dest);
+      });
+  point_to_point_check(
+      "compact bidirectional astar", *g,
+      [&](auto root, auto dest, auto state) {
+        graphlib::bidirectional_astar(&compact, root, state, dest,
+                                      graphlib::distance_2d_heuristic);
+      });
+
+  // Directed graphs need a backward search over the reverse graph.
+  std::unique_ptr<Graph> directed =
+      graphlib::erdos_renyi_graph(2000, 6000, true, 6);
+  std::unique_ptr<Graph> reverse = directed->GetReverseGraph();
+  CompactGraph compact_directed(*directed);
+  CompactGraph compact_reverse = compact_directed.GetReverseGraph();
+  point_to_point_check(
+      "directed bidirectional dijkstra", *directed,
+      [&](auto root, auto dest, auto state) {
+        graphlib::bidirectional_astar(directed.get(), root, state, dest);
+      });
+  point_to_point_check(
+      "given reverse graph", *directed, [&](auto root, auto dest, auto state) {
+        graphlib::bidirectional_astar(directed.get(), root, state, dest,
+                                      nullptr, reverse.get());
+      });
+  point_to_point_check(
+      "compact directed bidirectional dijkstra", *directed,
+      [&](auto root, auto dest, auto state) {
+        graphlib::bidirectional_astar(&compact_directed, root, state, dest,
+                                      nullptr, &compact_reverse);
+      });
+  std::cout << '\n';
+}
+
+// Batched queries (with repeated sources and destinations, a source that is
+// its own destination, and unreachable destinations) should give the same
+// distances as Dijkstra's algorithm run for one query at a time, and paths of
+// the graph that long, whatever the number of threads.
+void batch_paths_check() {
+  std::unique_ptr<Graph> graph =
+      graphlib::erdos_renyi_graph(2000, 5000, true, 8);
+  CompactGraph compact(*graph);
+  std::mt19937 rng(9);
+  std::uniform_int_distribution<graphlib::VertexId> vertex_distribution(
+      0, graph->NumVertices() - 1);
+  std::vector<const Vertex*> sources;
+  for (int i = 0; i != 20; ++i) {
+    sources.push_back(graph->GetVertexPtr(vertex_distribution(rng)));
+  }
+  std::vector<graphlib::PathQuery> queries;
+  for (int i = 0; i != 300; ++i) {
+    const Vertex* source = sources[i % sources.size()];
+    queries.push_back(
+        {source, i % 37 == 0 ? source
+                             : graph->GetVertexPtr(vertex_distribution(rng))});
+  }
+
+  SearchState reference(graph->NumVertices());
+  auto matches = [&](const std::vector<graphlib::PathResult>& results) {
+    bool same = results.size() == queries.size();
+    for (std::size_t i = 0; same && i != queries.size(); ++i) {
+      graphlib::dijkstra(graph.get(), queries[i].source_, &reference);
+      double expected =
+          reference.dist_to_root_[queries[i].destination_->id_];
+      if (expected == std::numeric_limits<double>::infinity()) {
+        same = results[i].path_.empty() && results[i].distance_ == expected;
+      } else {
+        same = std::abs(results[i].distance_ - expected) < 1e-9 &&
+               std::abs(path_length(*graph, results[i].path_) - expected) <
+                   1e-9 &&
+               results[i].path_.top() == queries[i].source_;
+      }
+    }
+    return same;
+  };
+  int unreachable = 0;
+  for (const graphlib::PathResult& result :
+       graphlib::shortest_pos_weight_paths(graph.get(), queries, 1)) {
+    unreachable += result.path_.empty();
+  }
+  std::cout << "queries: " << queries.size() << ", unreachable: " << unreachable
+            << '\n';
+  std::cout << "1 thread matches: "
+            << matches(graphlib::shortest_pos_weight_paths(graph.get(),
+                                                           queries, 1))
+            << ", 4 threads match: "
+            << matches(graphlib::shortest_pos_weight_paths(graph.get(),
+                                                           queries, 4))
+            << ", compact matches: "
+            << matches(graphlib::shortest_pos_weight_paths(&compact, queries))
+            << '\n';
+
+  // One source to many destinations.
+  std::vector<const Vertex*> destinations;
+  for (const graphlib::PathQuery& query : queries) {
+    if (query.source_ == sources[0]) {
+      destinations.push_back(query.destination_);
+    }
+  }
+  std::vector<graphlib::PathResult> results =
+      graphlib::shortest_pos_weight_paths(&compact, sources[0], destinations);
+  bool same = true;
+  for (std::size_t i = 0, j = 0; i != queries.size(); ++i) {
+    if (queries[i].source_ == sources[0]) {
+      same &= results[j++].distance_ ==
+              graphlib::shortest_pos_weight_paths(&compact, {queries[i]})[0]
+                  .distance_;
+    }
+  }
+  std::cout << "one source to " << destinations.size()
+            << " destinations matches: " << same << '\n';
+
+  Vertex stranger("stranger");
+  std::cout << "Expecting error...\n";
+  try {
+    graphlib::shortest_pos_weight_paths(graph.get(), {{&stranger, &stranger}});
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+}
+
+// Delta-stepping should find the same distances as Dijkstra's algorithm, and
+// a tree of shortest paths (each parent edge is tight, and the parents lead
+// back to the root), for any delta and number of threads.
+void delta_stepping_check(const std::string& name, const Graph& graph) {
+  CompactGraph compact(graph);
+  const graphlib::VertexId num_vertices = graph.NumVertices();
+  const Vertex* root = graph.GetVertexPtr(num_vertices / 3);
+  SearchState reference(num_vertices), state(num_vertices);
+  graphlib::dijkstra(&compact, root, &reference);
+
+  std::cout << name << ":";
+  for (double delta : {0.0, 0.05, 1e9}) {
+    for (unsigned num_threads : {1u, 3u}) {
+      graphlib::delta_stepping(&compact, root, &state, delta, num_threads);
+      bool valid = state.dist_to_root_ == reference.dist_to_root_;
+      for (graphlib::VertexId v = 0; valid && v != num_vertices; ++v) {
+        const graphlib::VertexId parent = state.parent_[v];
+        if (v == root->id_ || state.dist_to_root_[v] ==
+                                  std::numeric_limits<double>::infinity()) {
+          valid = parent == graphlib::kNoVertex;
+          continue;
+        }
+        valid = parent != graphlib::kNoVertex &&
+                graph.EdgeExists(*graph.GetVertexPtr(parent),
+                                 *graph.GetVertexPtr(v)) &&
+                std::abs(state.dist_to_root_[parent] +
+                         graph.EdgeWeight(*graph.GetVertexPtr(parent),
+                                          *graph.GetVertexPtr(v)) -
+                         state.dist_to_root_[v]) < 1e-9;
+        graphlib::VertexId u = v;
+        for (graphlib::VertexId steps = 0;
+             u != root->id_ && steps != num_vertices; ++steps) {
+          u = state.parent_[u];
+        }
+        valid = valid && u == root->id_;
+      }
+      std::cout << ' ' << valid;
+    }
+  }
+  std::cout << '\n';
+}
+
+void delta_stepping_checks() {
+  std::unique_ptr<Graph> directed =
+      graphlib::erdos_renyi_graph(3000, 12000, true, 10);
+  delta_stepping_check("directed erdos renyi", *directed);
+  std::unique_ptr<Graph> grid = graphlib::grid_graph(50, 60, 11);
+  delta_stepping_check("grid", *grid);
+  std::unique_ptr<Graph2d> geometric = graphlib::random_geometric_graph(
+      1 << 12, graphlib::random_geometric_radius(8), 12);
+  delta_stepping_check("random geometric", *geometric);
+  std::unique_ptr<Graph> rmat = graphlib::rmat_graph(12, 8, true, 13);
+  delta_stepping_check("directed rmat", *rmat);
+
+  Vertex v0("0"), v1("1");
+  Graph::InputWeightedAL al = {{v0, {{v1, -1}}}};
+  Graph negative(al, true);
+  CompactGraph compact(negative);
+  SearchState state(2);
+  std::cout << "Expecting error...\n";
+  try {
+    graphlib::delta_stepping(&compact, negative.GetVertexPtr(v0), &state);
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+}
+
 int main() {
   std::cout << "=============\n";
   std::cout << "TINY_EWD_DIJKSTRAS\n\n";
@@ -145,4 +405,20 @@ int main() {
   std::cout << "=============\n";
   std::cout << "FLOYD_WARSHALL_TEST\n\n";
   floyd_warshall_test();
+
+  std::cout << "=============\n";
+  std::cout << "FLOYD_WARSHALL_DENSE_CHECK\n\n";
+  floyd_warshall_dense_check();
+
+  std::cout << "=============\n";
+  std::cout << "ASTAR_CHECK\n\n";
+  astar_check();
+
+  std::cout << "=============\n";
+  std::cout << "BATCH_PATHS_CHECK\n\n";
+  batch_paths_check();
+
+  std::cout << "=============\n";
+  std::cout << "DELTA_STEPPING_CHECKS\n\n";
+  delta_stepping_checks();
 }
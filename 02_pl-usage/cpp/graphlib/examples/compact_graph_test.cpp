@@ -0,0 +1,215 @@
+// Quick ad-hoc tests for CompactGraph snapshots and the CompactGraph overloads
+// of graph algorithms. Outputs should match those of the corresponding Graph
+// examples.
+
+#include "graphlib/compact_graph.hpp"
+
+#include <iostream>
+#include <stack>
+
+#include "graphlib/algo/bfs.hpp"
+#include "graphlib/algo/dfs.hpp"
+#include "graphlib/algo/mst.hpp"
+#include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
+#include "path_checks.hpp"
+
+using graphlib::CompactGraph;
+using graphlib::Edge;
+using graphlib::Graph;
+using graphlib::SearchState;
+using graphlib::Vertex;
+
+void snapshot_check() {
+  // Example seen in comment at the top of graph.hpp (and compact_graph.hpp).
+  Vertex A("A"), B("B"), C("C"), D("D"), E("E");
+  Graph::InputUnweightedAL input_al = {
+      {A, {D, E}}, {B, {}}, {D, {E}}, {E, {C}}};
+  Graph graph(input_al, false);
+  CompactGraph compact(graph);
+
+  // Both representations should print the same adjacency lists.
+  std::cout << "graph\n" << graphlib::to_string(graph);
+  std::cout << "snapshot\n" << graphlib::to_string(compact);
+
+  std::cout << "offsets: ";
+  for (auto offset : compact.GetOffsets()) std::cout << offset << ' ';
+  std::cout << "\ntargets: ";
+  for (auto target : compact.GetTargets()) std::cout << target << ' ';
+  std::cout << "\n\n";
+
+  std::cout << "Expecting error...\n";
+  Graph other_graph({A}, false);
+  try {
+    compact.GetVertexId(other_graph.GetVertexPtr(A));
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+}
+
+void bfs_check() {
+  Vertex A("A"), B("B"), C("C"), D("D"), E("E"), F("F");
+  Graph::InputUnweightedAL input_al = {
+      {A, {D, E}}, {B, {F}}, {D, {E}}, {E, {C}}};
+  Graph graph(input_al, false);
+  CompactGraph compact(graph);
+
+  SearchState state(compact.NumVertices());
+  graphlib::bfs(&compact, graph.GetVertexPtr(A), &state,
+                graphlib::print_vertex);
+  // Expecting all vertices connected to Vertex A to be in state PROCESSED (2).
+  std::cout << graphlib::to_string(graph, state) << '\n';
+
+  std::cout << "Shortest unweighted path from A to C:\n";
+  print_path(graphlib::shortest_unweighted_path(&compact, graph.GetVertexPtr(A),
+                                                graph.GetVertexPtr(C)));
+
+  std::cout << "\nConnected components:\n";
+  int i = 1;
+  for (const auto& component : graphlib::connected_components(&compact)) {
+    std::cout << "Component " << i++ << ": ";
+    for (auto v : component) {
+      std::cout << v->name_ << " | ";
+    }
+    std::cout << '\n';
+  }
+
+  // A, D, and E form a triangle.
+  std::cout << "\nexpecting non bipartite:\n"
+            << graphlib::is_bipartite(&compact) << '\n';
+}
+
+void dfs_check() {
+  // Sedgewick p.589 (see dfs_test.cpp).
+  Vertex v0("0"), v1("1"), v2("2"), v3("3"), v4("4"), v5("5"), v6("6"), v7("7"),
+      v8("8"), v9("9"), v10("10"), v11("11"), v12("12");
+  Graph::InputUnweightedAL directed_al = {
+      {v0, {v2, v6}},      {v1, {v0}},          {v2, {v3, v4}}, {v3, {v2, v4}},
+      {v4, {v5, v6, v11}}, {v5, {v0, v3}},      {v6, {v7}},     {v7, {v8}},
+      {v8, {v7}},          {v9, {v6, v8, v12}}, {v10, {v9}},    {v11, {v9}},
+      {v12, {v10, v11}}};
+  Graph directed_graph(directed_al, true);
+  CompactGraph compact(directed_graph);
+
+  std::cout << "Expecting cyclic: " << graphlib::is_cyclic(&compact) << '\n';
+
+  std::cout << "Finding strongly connected components...\n";
+  int counter = 1;
+  for (const auto& component : graphlib::strong_components(&compact)) {
+    std::cout << "Component " << counter++ << ": ";
+    for (const Vertex* v : component) {
+      std::cout << v->name_ << " | ";
+    }
+    std::cout << '\n';
+  }
+  std::cout << '\n';
+
+  // Skiena DAG (see dfs_test.cpp), expecting G, A, B, C, F, E, D.
+  Vertex A("A"), B("B"), C("C"), D("D"), E("E"), F("F"), G("G");
+  Graph::InputUnweightedAL dag_al = {{A, {B, C}}, {B, {C, D}}, {C, {E, F}},
+                                     {D, {}},     {E, {D}},    {F, {E}},
+                                     {G, {A, F}}};
+  Graph dag(dag_al, true);
+  CompactGraph compact_dag(dag);
+  std::cout << "Finding topological sort...\n";
+  std::stack<const Vertex*> s = graphlib::topological_sort(&compact_dag);
+  while (!s.empty()) {
+    std::cout << s.top()->name_ << " | ";
+    s.pop();
+  }
+  std::cout << "\n";
+}
+
+void weighted_paths_check() {
+  // "tiny_ewd" graph example provided in Sedgewick (see
+  // weighted_paths_test.cpp).
+  Vertex v0("0"), v1("1"), v2("2"), v3("3"), v4("4"), v5("5"), v6("6"), v7("7");
+  Graph::InputWeightedAL al = {{v0, {{v4, 0.38}, {v2, 0.26}}},
+                               {v1, {{v3, 0.29}}},
+                               {v2, {{v7, 0.34}}},
+                               {v3, {{v6, 0.52}}},
+                               {v4, {{v5, 0.35}, {v7, 0.37}}},
+                               {v5, {{v4, 0.35}, {v7, 0.28}, {v1, 0.32}}},
+                               {v6, {{v2, 0.4}, {v0, 0.58}, {v4, 0.93}}},
+                               {v7, {{v5, 0.28}, {v3, 0.39}}}};
+  Graph tiny_ewd(al, true);
+  CompactGraph compact(tiny_ewd);
+
+  std::cout << "Shortest weighted path from 0 to 6 (Dijkstra):\n";
+  print_path(graphlib::shortest_pos_weight_path(
+      &compact, tiny_ewd.GetVertexPtr(v0), tiny_ewd.GetVertexPtr(v6)));
+
+  std::cout << "Shortest weighted path from 0 to 6 (Bellman-Ford):\n";
+  print_path(graphlib::shortest_weighted_path(
+      &compact, tiny_ewd.GetVertexPtr(v0), tiny_ewd.GetVertexPtr(v6)));
+  std::cout << '\n';
+
+  // See floyd_warshall_test in weighted_paths_test.cpp.
+  Vertex u1("1"), u2("2"), u3("3"), u4("4");
+  Graph::InputWeightedAL fw_al = {{u1, {{u3, -2}}},
+                                  {u2, {{u1, 4}, {u3, 3}}},
+                                  {u3, {{u4, 2}}},
+                                  {u4, {{u2, -1}}}};
+  Graph fw_graph(fw_al, true);
+  CompactGraph compact_fw(fw_graph);
+  auto dist_matrix = graphlib::floyd_warshall(&compact_fw);
+
+  std::cout << "  1  2  3  4\n";
+  std::cout << "  ==========\n";
+  for (const auto& i : dist_matrix) {
+    std::cout << i.first->name_ << "|";
+    for (const auto& j : i.second) {
+      std::cout << j.second << " ";
+    }
+    std::cout << '\n';
+  }
+}
+
+void mst_check() {
+  // "tiny_ewg" graph example provided in Sedgewick (see mst_test.cpp).
+  Vertex v0("0"), v1("1"), v2("2"), v3("3"), v4("4"), v5("5"), v6("6"), v7("7");
+  Graph::InputWeightedAL al = {
+      {v0, {{v7, 0.16}, {v4, 0.38}, {v2, 0.26}}},
+      {v1, {{v5, 0.32}, {v7, 0.19}, {v2, 0.36}, {v3, 0.29}}},
+      {v2, {{v3, 0.17}, {v7, 0.34}}},
+      {v3, {{v6, 0.52}}},
+      {v4, {{v5, 0.35}, {v7, 0.37}}},
+      {v5, {{v7, 0.28}}},
+      {v6, {{v2, 0.4}, {v0, 0.58}, {v4, 0.93}}}};
+  Graph tiny_ewg(al, false);
+  CompactGraph compact(tiny_ewg);
+
+  std::cout << "MST found by Prim's algorithm:\n";
+  for (const auto& e : graphlib::prim_mst(&compact)) {
+    std::cout << graphlib::to_string(e);
+  }
+  std::cout << '\n';
+
+  std::cout << "MST found by Kruskal's algorithm:\n";
+  for (const auto& e : graphlib::kruskal_mst(&compact)) {
+    std::cout << graphlib::to_string(e);
+  }
+}
+
+int main() {
+  std::cout << "\n=============\n";
+  std::cout << "SNAPSHOT_CHECK\n\n";
+  snapshot_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "BFS_CHECK\n\n";
+  bfs_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "DFS_CHECK\n\n";
+  dfs_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "WEIGHTED_PATHS_CHECK\n\n";
+  weighted_paths_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "MST_CHECK\n\n";
+  mst_check();
+}
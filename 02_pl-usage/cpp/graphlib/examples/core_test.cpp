@@ -18,18 +18,13 @@ void equality_op_overload() {
 void vertex_set_initializer() {
   Vertex v1("A"), v2("B"), v3("C"), v1_again("A"), v2_again("B");
 
-  // Initial states should be reset to UNDISCOVERED when passed into a graph.
-  v2.state_ = Vertex::State::PROCESSED;
-  v3.state_ = Vertex::State::DISCOVERED;
-
   // v1_again should be ignored.
   Graph graph({v1, v2, v3, v1_again}, false);
 
   // v2_again should be ignored.
   graph.AddVertex(v2_again);
 
-  // Check that only A, B, and C exist in the graph, all with state UNDISCOVERED
-  // (0).
+  // Check that only A, B, and C exist in the graph.
   std::cout << graph.GetVertexSetStr();
 }
 
@@ -5,12 +5,23 @@
 
 #include "graphlib/geometry/graph_2d.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "graphlib/algo/mst.hpp"
 #include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/geometry/delaunay.hpp"
+#include "graphlib/generators.hpp"
 #include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
 
 using graphlib::Edge;
 using graphlib::Graph2d;
@@ -45,7 +56,6 @@ void mst_check() {
   std::cout << '\n';
 
   std::cout << "MST found by Kruskal's algorithm:\n";
-  graph.ResetState();
   std::vector<Edge> kruskals_output = graphlib::kruskal_mst(&graph);
   for (const auto& e : kruskals_output) {
     std::cout << graphlib::to_string(e);
@@ -74,10 +84,12 @@ void dijkstras_check() {
 
   std::cout << "Shortest paths parent tree:\n";
   std::cout << "search root: " << v0.name_ << '\n';
-  graphlib::dijkstra(&graph, graph.GetVertexPtr(v0));
+  graphlib::SearchState state(graph.NumVertices());
+  graphlib::dijkstra(&graph, graph.GetVertexPtr(v0), &state);
   for (const auto& v : graph.GetAdjacencyMap()) {
     if (v.first != graph.GetVertexPtr(v0)) {
-      std::cout << v.first->name_ << " parent: " << v.first->parent_->name_
+      std::cout << v.first->name_ << " parent: "
+                << graph.GetVertexPtr(state.parent_[v.first->id_])->name_
                 << '\n';
     }
   }
@@ -120,6 +132,185 @@ void dijkstras_check() {
   std::cout << '\n';
 }
 
+// Every vertex of the graph, closest to (x, y) first, by brute force.
+std::vector<const Vertex2d*> by_distance(const Graph2d& graph, double x,
+                                         double y) {
+  std::vector<std::pair<double, graphlib::VertexId>> distances;
+  for (graphlib::VertexId v = 0;
+       v != static_cast<graphlib::VertexId>(graph.NumVertices()); ++v) {
+    auto p = static_cast<const Vertex2d*>(graph.GetVertexPtr(v));
+    distances.push_back(
+        {(p->x_ - x) * (p->x_ - x) + (p->y_ - y) * (p->y_ - y), v});
+  }
+  std::sort(distances.begin(), distances.end());
+  std::vector<const Vertex2d*> vertices;
+  for (const auto& d : distances) {
+    vertices.push_back(static_cast<const Vertex2d*>(
+        graph.GetVertexPtr(d.second)));
+  }
+  return vertices;
+}
+
+// Spatial queries should agree with brute force, for a graph whose vertices
+// were indexed in one batch, for one whose vertices were added one at a time
+// (some of them on top of each other, for ties), and for one constructed from
+// the same vertices.
+void spatial_index_check() {
+  std::unique_ptr<Graph2d> batch = graphlib::random_geometric_graph(5000, 1, 1);
+  Graph2d incremental(false);
+  std::vector<Vertex2d> vertices;
+  std::mt19937 rng(2);
+  std::uniform_int_distribution<int> coordinate_distribution(0, 40);
+  for (int i = 0; i != 1000; ++i) {
+    vertices.emplace_back(coordinate_distribution(rng) / 4.0,
+                          coordinate_distribution(rng) / 4.0);
+    incremental.AddVertex(vertices.back());
+  }
+  Graph2d constructed(vertices, false);
+
+  for (const Graph2d* graph : {batch.get(), &incremental, &constructed}) {
+    std::uniform_real_distribution<double> query_distribution(-5, 75);
+    bool nearest_matches = true, k_nearest_matches = true,
+         radius_matches = true;
+    for (int query = 0; query != 200; ++query) {
+      double x = query_distribution(rng), y = query_distribution(rng);
+      std::vector<const Vertex2d*> expected = by_distance(*graph, x, y);
+      nearest_matches &= graph->NearestVertex(x, y) == expected.front();
+
+      std::size_t k = query % 20;
+      k_nearest_matches &=
+          graph->NearestVertices(x, y, k) ==
+          std::vector<const Vertex2d*>(expected.begin(), expected.begin() + k);
+
+      double radius = query % 7;
+      std::vector<const Vertex2d*> within;
+      for (const Vertex2d* v : expected) {
+        if (std::pow(v->x_ - x, 2) + std::pow(v->y_ - y, 2) <=
+            radius * radius) {
+          within.push_back(v);
+        }
+      }
+      radius_matches &= graph->VerticesWithinRadius(x, y, radius) == within;
+    }
+    std::cout << "V=" << graph->NumVertices()
+              << " nearest matches: " << nearest_matches
+              << ", k nearest matches: " << k_nearest_matches
+              << ", within radius matches: " << radius_matches << '\n';
+  }
+
+  Graph2d empty(false);
+  std::cout << "nearest in empty graph: " << empty.NearestVertex(0, 0)
+            << "\n\n";
+}
+
+// Checks the triangulation of random points against the Delaunay condition by
+// brute force: every half-edge pairs up with its opposite, every triangle turns
+// the same way, and no point lies inside any triangle's circumcircle.
+void delaunay_check() {
+  std::mt19937 mt(7);
+  std::uniform_real_distribution<double> distribution(-10, 10);
+  std::vector<Vertex2d> vertices;
+  for (int i = 0; i != 300; ++i) {
+    vertices.emplace_back(distribution(mt), distribution(mt));
+  }
+  std::vector<const Vertex2d*> points;
+  for (const Vertex2d& v : vertices) points.push_back(&v);
+
+  graphlib::DelaunayTriangulation triangulation =
+      graphlib::delaunay_triangulation(points);
+  const std::vector<std::size_t>& triangles = triangulation.triangles_;
+  const std::vector<std::size_t>& halfedges = triangulation.halfedges_;
+
+  bool halfedges_match = true;
+  std::size_t hull_size = 0;
+  for (std::size_t e = 0; e != halfedges.size(); ++e) {
+    std::size_t opposite = halfedges[e];
+    if (opposite == graphlib::kNoHalfEdge) {
+      ++hull_size;
+      continue;
+    }
+    std::size_t next = e % 3 == 2 ? e - 2 : e + 1;
+    std::size_t opposite_next =
+        opposite % 3 == 2 ? opposite - 2 : opposite + 1;
+    halfedges_match &= halfedges[opposite] == e &&
+                       triangles[e] == triangles[opposite_next] &&
+                       triangles[next] == triangles[opposite];
+  }
+
+  bool same_orientation = true, empty_circumcircles = true;
+  int orientation = 0;
+  for (std::size_t t = 0; t != triangles.size(); t += 3) {
+    const Vertex2d* a = points[triangles[t]];
+    const Vertex2d* b = points[triangles[t + 1]];
+    const Vertex2d* c = points[triangles[t + 2]];
+    double cross = (b->x_ - a->x_) * (c->y_ - a->y_) -
+                   (b->y_ - a->y_) * (c->x_ - a->x_);
+    int sign = cross > 0 ? 1 : -1;
+    if (orientation == 0) orientation = sign;
+    same_orientation &= sign == orientation;
+
+    for (const Vertex2d* p : points) {
+      double ax = a->x_ - p->x_, ay = a->y_ - p->y_;
+      double bx = b->x_ - p->x_, by = b->y_ - p->y_;
+      double cx = c->x_ - p->x_, cy = c->y_ - p->y_;
+      double in_circle = (ax * ax + ay * ay) * (bx * cy - cx * by) -
+                         (bx * bx + by * by) * (ax * cy - cx * ay) +
+                         (cx * cx + cy * cy) * (ax * by - bx * ay);
+      empty_circumcircles &= in_circle * orientation < 1e-9;
+    }
+  }
+
+  std::cout << "triangles: " << triangles.size() / 3
+            << ", expected 2n - 2 - hull: "
+            << (triangles.size() / 3 == 2 * points.size() - 2 - hull_size)
+            << '\n';
+  std::cout << "halfedges match: " << halfedges_match
+            << ", same orientation: " << same_orientation
+            << ", empty circumcircles: " << empty_circumcircles << '\n';
+
+  std::vector<Vertex2d> line;
+  for (int i = 0; i != 10; ++i) line.emplace_back(i, 2 * i);
+  std::vector<const Vertex2d*> line_points;
+  for (const Vertex2d& v : line) line_points.push_back(&v);
+  std::cout << "triangles of collinear points: "
+            << graphlib::delaunay_triangulation(line_points).triangles_.size()
+            << "\n\n";
+}
+
+// The generator should connect exactly the pairs of points at most radius
+// apart (by brute force), for radii both much smaller and much larger than the
+// spacing of the points.
+void random_geometric_check() {
+  for (double radius : {1e-9, 0.001, 0.5, 1.5, 100.0}) {
+    std::unique_ptr<Graph2d> graph =
+        graphlib::random_geometric_graph(1024, radius, 3);
+    std::vector<const Vertex2d*> points;
+    for (graphlib::VertexId v = 0;
+         v != static_cast<graphlib::VertexId>(graph->NumVertices()); ++v) {
+      points.push_back(static_cast<const Vertex2d*>(graph->GetVertexPtr(v)));
+    }
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i != points.size(); ++i) {
+      for (std::size_t j = i + 1; j != points.size(); ++j) {
+        expected += graphlib::distance_2d(*points[i], *points[j]) <= radius;
+      }
+    }
+    std::cout << "radius " << radius << ": edges match brute force: "
+              << (graphlib::CompactGraph(*graph).NumEdges() == 2 * expected)
+              << '\n';
+  }
+
+  for (double radius : {0.0, -1.0, std::numeric_limits<double>::infinity()}) {
+    std::cout << "Expecting error...\n";
+    try {
+      graphlib::random_geometric_graph(16, radius, 3);
+    } catch (const std::runtime_error& e) {
+      std::cout << "Caught runtime exception:\n" << e.what();
+    }
+  }
+  std::cout << '\n';
+}
+
 int main() {
   std::cout << "=============\n";
   std::cout << "DISTANCE_TEST\n\n";
@@ -132,4 +323,16 @@ int main() {
   std::cout << "=============\n";
   std::cout << "DIJKSTRAS_CHECK\n\n";
   dijkstras_check();
+
+  std::cout << "=============\n";
+  std::cout << "SPATIAL_INDEX_CHECK\n\n";
+  spatial_index_check();
+
+  std::cout << "=============\n";
+  std::cout << "DELAUNAY_CHECK\n\n";
+  delaunay_check();
+
+  std::cout << "=============\n";
+  std::cout << "RANDOM_GEOMETRIC_CHECK\n\n";
+  random_geometric_check();
 }
@@ -0,0 +1,114 @@
+// Quick ad-hoc tests for GraphBuilder. Graphs built in bulk should be identical
+// to graphs built one edge at a time.
+
+#include "graphlib/graph_builder.hpp"
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/graph.hpp"
+
+using graphlib::CompactGraph;
+using graphlib::Graph;
+using graphlib::GraphBuilder;
+using graphlib::Vertex;
+
+// Compare both the printed adjacency lists and the vertex ids of two graphs.
+bool same_graph(const Graph& lhs, const Graph& rhs) {
+  if (graphlib::to_string(lhs) != graphlib::to_string(rhs) ||
+      lhs.NumVertices() != rhs.NumVertices()) {
+    return false;
+  }
+  for (graphlib::VertexId v = 0;
+       v != static_cast<graphlib::VertexId>(lhs.NumVertices()); ++v) {
+    if (*lhs.GetVertexPtr(v) != *rhs.GetVertexPtr(v)) return false;
+  }
+  return true;
+}
+
+bool same_snapshot(const CompactGraph& lhs, const CompactGraph& rhs) {
+  return lhs.GetOffsets() == rhs.GetOffsets() &&
+         lhs.GetTargets() == rhs.GetTargets() &&
+         lhs.GetWeights() == rhs.GetWeights();
+}
+
+void small_graph_check() {
+  // Example seen in comment at the top of graph.hpp ("rep3"), where B has no
+  // edges.
+  GraphBuilder builder(false);
+  builder.AddEdges({"A", "A", "D", "E"}, {"D", "E", "E", "C"});
+  builder.AddVertex("B");
+  std::unique_ptr<CompactGraph> compact;
+  std::unique_ptr<Graph> graph = builder.Build(&compact);
+
+  std::cout << "built\n" << graphlib::to_string(*graph);
+  std::cout << "built snapshot\n" << graphlib::to_string(*compact);
+  std::cout << "builder is empty afterwards: "
+            << (builder.NumVertices() == 0 && builder.NumPendingEdges() == 0)
+            << "\n\n";
+
+  // Duplicate edges keep the first weight given, like Graph::AddEdge.
+  GraphBuilder directed_builder(true);
+  directed_builder.AddEdges({"A", "B", "A"}, {"B", "A", "B"}, {1, 2, 3});
+  std::cout << "directed, expecting A -> B (1) and B -> A (2)\n"
+            << graphlib::to_string(*directed_builder.Build());
+
+  GraphBuilder undirected_builder(false);
+  undirected_builder.AddEdges({"A", "B", "A"}, {"B", "A", "A"}, {1, 2, 3});
+  std::cout << "undirected, expecting A - B (1) and A - A (3)\n"
+            << graphlib::to_string(*undirected_builder.Build());
+
+  std::cout << "Expecting error...\n";
+  try {
+    builder.AddEdges({"A", "B"}, {"C"});
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+}
+
+void random_graph_check(bool is_directed) {
+  std::mt19937 mt(is_directed ? 1 : 2);
+  std::uniform_int_distribution<int> vertex_distribution(0, 499);
+  std::uniform_int_distribution<int> weight_distribution(1, 9);
+
+  // Several batches with plenty of duplicate edges, compared against the same
+  // edges added one at a time.
+  GraphBuilder builder(is_directed);
+  Graph expected(is_directed);
+  for (int batch = 0; batch != 4; ++batch) {
+    std::vector<std::string> sources, dests;
+    std::vector<double> weights;
+    for (int i = 0; i != 1000; ++i) {
+      sources.push_back(std::to_string(vertex_distribution(mt)));
+      dests.push_back(std::to_string(vertex_distribution(mt)));
+      weights.push_back(weight_distribution(mt));
+      expected.AddEdge(Vertex(sources.back()), Vertex(dests.back()),
+                       weights.back());
+    }
+    builder.AddEdges(sources, dests, weights);
+  }
+
+  std::unique_ptr<CompactGraph> compact;
+  std::unique_ptr<Graph> graph = builder.Build(&compact);
+  std::cout << (is_directed ? "directed" : "undirected")
+            << " graph matches: " << same_graph(*graph, expected)
+            << ", snapshot matches: "
+            << same_snapshot(*compact, CompactGraph(expected))
+            << ", snapshot of built graph matches: "
+            << same_snapshot(*compact, CompactGraph(*graph)) << '\n';
+}
+
+int main() {
+  std::cout << "\n=============\n";
+  std::cout << "SMALL_GRAPH_CHECK\n\n";
+  small_graph_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "RANDOM_GRAPH_CHECK\n\n";
+  random_graph_check(true);
+  random_graph_check(false);
+}
@@ -0,0 +1,214 @@
+// Quick ad-hoc tests for writing binary graph files and loading them back as
+// MappedGraphs.
+
+#include "graphlib/graph_file.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stack>
+#include <string>
+
+#include "graphlib/algo/bfs.hpp"
+#include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
+#include "graphlib/geometry/graph_2d.hpp"
+#include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
+
+using graphlib::CompactGraph;
+using graphlib::Graph;
+using graphlib::Graph2d;
+using graphlib::MappedGraph;
+using graphlib::SearchState;
+using graphlib::Vertex;
+using graphlib::Vertex2d;
+
+const std::string g_path =
+    (std::filesystem::temp_directory_path() / "graphlib_graph_file_test.bin")
+        .string();
+
+void round_trip_check() {
+  // "tiny_ewd" graph example provided in Sedgewick (see
+  // weighted_paths_test.cpp).
+  Vertex v0("0"), v1("1"), v2("2"), v3("3"), v4("4"), v5("5"), v6("6"), v7("7");
+  Graph::InputWeightedAL al = {{v0, {{v4, 0.38}, {v2, 0.26}}},
+                               {v1, {{v3, 0.29}}},
+                               {v2, {{v7, 0.34}}},
+                               {v3, {{v6, 0.52}}},
+                               {v4, {{v5, 0.35}, {v7, 0.37}}},
+                               {v5, {{v4, 0.35}, {v7, 0.28}, {v1, 0.32}}},
+                               {v6, {{v2, 0.4}, {v0, 0.58}, {v4, 0.93}}},
+                               {v7, {{v5, 0.28}, {v3, 0.39}}}};
+  Graph tiny_ewd(al, true);
+  CompactGraph compact(tiny_ewd);
+  graphlib::write_graph_file(compact, g_path);
+
+  MappedGraph mapped(g_path);
+  std::cout << "snapshot\n" << graphlib::to_string(compact);
+  std::cout << "mapped\n" << graphlib::to_string(mapped);
+  std::cout << "matches: "
+            << (graphlib::to_string(compact) == graphlib::to_string(mapped))
+            << ", directed: " << mapped.IsDirected()
+            << ", has coordinates: " << mapped.HasCoordinates() << '\n';
+
+  std::cout << "id of 5: " << mapped.FindVertex("5")
+            << ", expecting same as snapshot: "
+            << compact.GetVertexId(tiny_ewd.GetVertexPtr(v5)) << '\n';
+  std::cout << "id of 8, expecting -1: " << mapped.FindVertex("8") << "\n\n";
+}
+
+void coordinates_check() {
+  Vertex2d v1(3, 0), v2(0, 4), v3(-1, -1);
+  Graph2d graph({{v1, {v2, v3}}, {v2, {v3}}}, false);
+  CompactGraph compact(graph);
+  graphlib::write_graph_file(compact, g_path);
+
+  MappedGraph mapped(g_path);
+  std::cout << graphlib::to_string(mapped);
+  std::cout << "has coordinates: " << mapped.HasCoordinates() << '\n';
+  for (graphlib::VertexId v = 0;
+       v != static_cast<graphlib::VertexId>(mapped.NumVertices()); ++v) {
+    std::cout << mapped.GetName(v) << ": x=" << mapped.GetX(v)
+              << " y=" << mapped.GetY(v) << '\n';
+  }
+  std::cout << '\n';
+}
+
+// The algorithms run on a CompactGraph viewing a MappedGraph should give the
+// same results as on the in-memory graph the file was written from.
+void algorithms_check() {
+  std::unique_ptr<Graph> graph =
+      graphlib::erdos_renyi_graph(2000, 8000, true, 4);
+  CompactGraph compact(*graph);
+  graphlib::write_graph_file(compact, g_path);
+  MappedGraph mapped(g_path);
+  CompactGraph view(mapped);
+  std::cout << "view matches mapped: "
+            << (graphlib::to_string(view) == graphlib::to_string(mapped))
+            << '\n';
+
+  const graphlib::Vertex* root = compact.GetVertexPtr(7);
+  const graphlib::Vertex* mapped_root =
+      view.GetVertexPtr(mapped.FindVertex(root->name_));
+  SearchState state(graph->NumVertices()), mapped_state(view.NumVertices());
+  graphlib::dijkstra(&compact, root, &state);
+  graphlib::dijkstra(&view, mapped_root, &mapped_state);
+  std::cout << "dijkstra distances match: "
+            << (state.dist_to_root_ == mapped_state.dist_to_root_) << '\n';
+
+  graphlib::BfsTree tree = graphlib::parallel_bfs(&compact, root);
+  graphlib::BfsTree mapped_tree = graphlib::parallel_bfs(&view, mapped_root);
+  std::cout << "bfs hops match: " << (tree.hops_ == mapped_tree.hops_) << '\n';
+
+  std::stack<const Vertex*> path = graphlib::shortest_pos_weight_path(
+      &compact, root, compact.GetVertexPtr(1234));
+  std::stack<const Vertex*> mapped_path = graphlib::shortest_pos_weight_path(
+      &view, mapped_root, view.GetVertexPtr(1234));
+  bool same_path = path.size() == mapped_path.size();
+  for (; same_path && !path.empty(); path.pop(), mapped_path.pop()) {
+    same_path = path.top()->name_ == mapped_path.top()->name_;
+  }
+  std::cout << "shortest path matches: " << same_path << '\n';
+
+  // Vertices of a file with coordinates are Vertex2ds, for astar.
+  std::unique_ptr<Graph2d> geometric = graphlib::random_geometric_graph(
+      1 << 12, graphlib::random_geometric_radius(8), 5);
+  CompactGraph compact_2d(*geometric);
+  graphlib::write_graph_file(compact_2d, g_path);
+  MappedGraph mapped_2d(g_path);
+  CompactGraph view_2d(mapped_2d);
+  SearchState state_2d(view_2d.NumVertices());
+  graphlib::dijkstra(&compact_2d, compact_2d.GetVertexPtr(0), &state_2d);
+  SearchState mapped_state_2d(view_2d.NumVertices());
+  graphlib::astar(&view_2d, view_2d.GetVertexPtr(0), &mapped_state_2d,
+                  view_2d.GetVertexPtr(99), graphlib::distance_2d_heuristic);
+  std::cout << "astar distance matches: "
+            << (std::abs(state_2d.dist_to_root_[99] -
+                         mapped_state_2d.dist_to_root_[99]) < 1e-9)
+            << "\n\n";
+}
+
+void error_check() {
+  std::cout << "Expecting error...\n";
+  try {
+    MappedGraph mapped(g_path + ".nonexistent");
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+
+  // A vertex count large enough for the file layout to wrap around.
+  Graph empty(true);
+  graphlib::write_graph_file(CompactGraph(empty), g_path);
+  std::fstream file(g_path, std::ios::binary | std::ios::in | std::ios::out);
+  const std::uint64_t num_vertices = std::uint64_t(1) << 62;
+  file.seekp(24);
+  file.write(reinterpret_cast<const char*>(&num_vertices),
+             sizeof(num_vertices));
+  file.close();
+  std::cout << "Expecting error...\n";
+  try {
+    MappedGraph mapped(g_path);
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+
+  // Corrupt arrays are only caught by Validate, which making a CompactGraph of
+  // the mapped graph runs: an edge target, then an entry of the name index, out
+  // of range. For this graph, the targets start at byte 80 (after the 48 byte
+  // header and 4 edge offsets), and the name index at byte 152 (after 3
+  // targets, padding, 3 weights and 4 name offsets).
+  Vertex v0("0"), v1("1"), v2("2");
+  Graph::InputWeightedAL al = {{v0, {{v1, 1}, {v2, 2}}}, {v1, {{v2, 3}}}};
+  Graph small(al, true);
+  for (std::streamoff position : {80, 152}) {
+    graphlib::write_graph_file(CompactGraph(small), g_path);
+    std::fstream corrupt(g_path,
+                         std::ios::binary | std::ios::in | std::ios::out);
+    const graphlib::VertexId invalid = 7;
+    corrupt.seekp(position);
+    corrupt.write(reinterpret_cast<const char*>(&invalid), sizeof(invalid));
+    corrupt.close();
+    MappedGraph mapped(g_path);
+    std::cout << "Expecting error...\n";
+    try {
+      CompactGraph view(mapped);
+    } catch (const std::runtime_error& e) {
+      std::cout << "Caught runtime exception:\n" << e.what();
+    }
+  }
+
+  std::ofstream(g_path, std::ios::binary | std::ios::trunc)
+      << "definitely not a graph file, but long enough to have a header";
+  std::cout << "Expecting error...\n";
+  try {
+    MappedGraph mapped(g_path);
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+}
+
+int main() {
+  std::cout << "\n=============\n";
+  std::cout << "ROUND_TRIP_CHECK\n\n";
+  round_trip_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "COORDINATES_CHECK\n\n";
+  coordinates_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "ALGORITHMS_CHECK\n\n";
+  algorithms_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "ERROR_CHECK\n\n";
+  error_check();
+
+  std::remove(g_path.c_str());
+}
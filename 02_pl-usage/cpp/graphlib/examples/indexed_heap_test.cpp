@@ -0,0 +1,170 @@
+// Quick ad-hoc tests for IndexedMinHeap, and for the algorithms built on it
+// against ones that aren't.
+
+#include "graphlib/indexed_heap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "graphlib/algo/mst.hpp"
+#include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/generators.hpp"
+#include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
+
+using graphlib::CompactGraph;
+using graphlib::Edge;
+using graphlib::Graph;
+using graphlib::IndexedMinHeap;
+using graphlib::SearchState;
+using graphlib::VertexId;
+
+// Push random keys, lower about half of them, then check that the heap pops
+// every VertexId in order of its final key.
+template <std::size_t Arity>
+bool heap_order_check(std::size_t n, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> key_distribution(0, 1);
+  std::vector<double> keys(n);
+  IndexedMinHeap<Arity> heap(n);
+  for (VertexId v = 0; v != static_cast<VertexId>(n); ++v) {
+    keys[v] = key_distribution(rng);
+    heap.Push(v, keys[v]);
+  }
+  for (VertexId v = 0; v != static_cast<VertexId>(n); v += 2) {
+    keys[v] *= key_distribution(rng);
+    heap.DecreaseKey(v, keys[v]);
+  }
+
+  std::vector<double> popped;
+  while (!heap.Empty()) {
+    double key = heap.TopKey();
+    VertexId v = heap.Pop();
+    if (key != keys[v] || heap.Contains(v)) return false;
+    popped.push_back(key);
+  }
+  return popped.size() == n && std::is_sorted(popped.begin(), popped.end());
+}
+
+void heap_check() {
+  std::cout << "arity 2 pops in order: " << heap_order_check<2>(1000, 1)
+            << '\n';
+  std::cout << "arity 4 pops in order: " << heap_order_check<4>(1000, 2)
+            << '\n';
+  std::cout << "arity 8 pops in order: " << heap_order_check<8>(1000, 3)
+            << '\n';
+
+  IndexedMinHeap<> cleared(3);
+  cleared.Push(0, 1);
+  cleared.Push(2, 3);
+  cleared.Clear();
+  cleared.Push(2, 2);
+  std::cout << "cleared heap reusable: "
+            << (!cleared.Contains(0) && cleared.Size() == 1 &&
+                cleared.Pop() == 2 && cleared.Empty())
+            << '\n';
+
+  IndexedMinHeap<> heap(2);
+  heap.Push(0, 1);
+  std::cout << "Expecting error...\n";
+  try {
+    heap.Push(0, 2);
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+  std::cout << "Expecting error...\n";
+  try {
+    heap.DecreaseKey(0, 2);
+  } catch (const std::runtime_error& e) {
+    std::cout << "Caught runtime exception:\n" << e.what();
+  }
+}
+
+// Dijkstra's algorithm (indexed heap) should agree with Bellman-Ford (FIFO
+// queue) on every distance.
+void dijkstra_check() {
+  std::unique_ptr<Graph> graph =
+      graphlib::erdos_renyi_graph(2000, 8000, true, 4);
+  CompactGraph compact(*graph);
+  const graphlib::Vertex* root = graph->GetVertexPtr(0);
+
+  SearchState dijkstra_state(graph->NumVertices());
+  SearchState compact_state(graph->NumVertices());
+  SearchState bellman_ford_state(graph->NumVertices());
+  graphlib::dijkstra(graph.get(), root, &dijkstra_state);
+  graphlib::dijkstra(&compact, root, &compact_state);
+  graphlib::bellman_ford(graph.get(), root, &bellman_ford_state);
+  std::cout << "dijkstra matches bellman_ford: "
+            << (dijkstra_state.dist_to_root_ ==
+                bellman_ford_state.dist_to_root_)
+            << ", compact dijkstra matches bellman_ford: "
+            << (compact_state.dist_to_root_ ==
+                bellman_ford_state.dist_to_root_)
+            << '\n';
+
+  // Every heap arity finds the same distances.
+  SearchState binary_state(graph->NumVertices());
+  SearchState wide_state(graph->NumVertices());
+  graphlib::dijkstra<2>(graph.get(), root, &binary_state);
+  graphlib::dijkstra<16>(&compact, root, &wide_state);
+  std::cout << "binary heap dijkstra matches bellman_ford: "
+            << (binary_state.dist_to_root_ == bellman_ford_state.dist_to_root_)
+            << ", 16-ary heap compact dijkstra matches bellman_ford: "
+            << (wide_state.dist_to_root_ == bellman_ford_state.dist_to_root_)
+            << '\n';
+}
+
+// Eager Prim's algorithm (indexed heap) should find a spanning tree of the same
+// weight as Kruskal's algorithm.
+void prim_check() {
+  std::unique_ptr<Graph> graph = graphlib::grid_graph(30, 40, 5);
+  CompactGraph compact(*graph);
+  auto total_weight = [](const std::vector<Edge>& edges) {
+    double weight = 0;
+    for (const Edge& e : edges) weight += e.weight_;
+    return weight;
+  };
+
+  std::vector<Edge> prim = graphlib::prim_mst(graph.get());
+  std::vector<Edge> compact_prim = graphlib::prim_mst(&compact);
+  std::vector<Edge> kruskal = graphlib::kruskal_mst(graph.get());
+  std::cout << "prim edges: " << prim.size()
+            << ", compact prim edges: " << compact_prim.size()
+            << ", kruskal edges: " << kruskal.size() << '\n';
+  std::cout << "same weight as kruskal: "
+            << (std::abs(total_weight(prim) - total_weight(kruskal)) < 1e-9)
+            << ", compact same weight as kruskal: "
+            << (std::abs(total_weight(compact_prim) - total_weight(kruskal)) <
+                1e-9)
+            << '\n';
+
+  std::vector<Edge> binary_prim = graphlib::prim_mst<2>(graph.get());
+  std::vector<Edge> wide_prim = graphlib::prim_mst<16>(&compact);
+  std::cout << "binary heap prim same weight as kruskal: "
+            << (std::abs(total_weight(binary_prim) - total_weight(kruskal)) <
+                1e-9)
+            << ", 16-ary heap compact prim same weight as kruskal: "
+            << (std::abs(total_weight(wide_prim) - total_weight(kruskal)) <
+                1e-9)
+            << '\n';
+}
+
+int main() {
+  std::cout << "\n=============\n";
+  std::cout << "HEAP_CHECK\n\n";
+  heap_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "DIJKSTRA_CHECK\n\n";
+  dijkstra_check();
+
+  std::cout << "\n=============\n";
+  std::cout << "PRIM_CHECK\n\n";
+  prim_check();
+}
@@ -0,0 +1,82 @@
+// Checks shared by the quick ad-hoc tests of shortest path algorithms.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stack>
+#include <string>
+
+#include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
+
+// Prints a path popped from the given stack, as "A -> B -> C".
+inline void print_path(std::stack<const graphlib::Vertex*> path) {
+  if (path.empty()) {
+    std::cout << "(no path)\n";
+    return;
+  }
+  while (path.size() > 1) {
+    std::cout << path.top()->name_ << " -> ";
+    path.pop();
+  }
+  std::cout << path.top()->name_ << '\n';
+}
+
+// Length of a path popped from the given stack, or -1 if it isn't a path of
+// the graph.
+inline double path_length(const graphlib::Graph& graph,
+                          std::stack<const graphlib::Vertex*> path) {
+  double length = 0;
+  while (path.size() > 1) {
+    const graphlib::Vertex* v1 = path.top();
+    path.pop();
+    if (!graph.EdgeExists(*v1, *path.top())) return -1;
+    length += graph.EdgeWeight(*v1, *path.top());
+  }
+  return length;
+}
+
+// Each point-to-point search should find a path as short as Dijkstra's
+// algorithm does, for random pairs of vertices. Also counts the vertices each
+// one settles.
+template <typename Search>
+void point_to_point_check(const std::string& name,
+                          const graphlib::Graph& graph, Search search) {
+  const graphlib::VertexId num_vertices = graph.NumVertices();
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<graphlib::VertexId> vertex_distribution(
+      0, num_vertices - 1);
+  graphlib::SearchState reference(num_vertices), state(num_vertices);
+  bool matches_dijkstra = true;
+  std::size_t settled = 0;
+  for (int query = 0; query != 20; ++query) {
+    const graphlib::Vertex* root =
+        graph.GetVertexPtr(vertex_distribution(rng));
+    const graphlib::Vertex* destination =
+        graph.GetVertexPtr(vertex_distribution(rng));
+    graphlib::dijkstra(&graph, root, &reference);
+    state.Reset();
+    search(root, destination, &state);
+
+    double expected = reference.dist_to_root_[destination->id_];
+    double dist = state.dist_to_root_[destination->id_];
+    if (expected == std::numeric_limits<double>::infinity()) {
+      matches_dijkstra &= dist == expected;
+    } else {
+      std::stack<const graphlib::Vertex*> path =
+          graphlib::get_path(&graph, state, root, destination);
+      matches_dijkstra &= std::abs(dist - expected) < 1e-9 &&
+                          std::abs(path_length(graph, path) - expected) < 1e-9;
+    }
+    for (graphlib::VertexState vertex_state : state.state_) {
+      settled += vertex_state == graphlib::VertexState::PROCESSED;
+    }
+  }
+  std::cout << name << " matches dijkstra: " << matches_dijkstra
+            << ", settled: " << settled << '\n';
+}
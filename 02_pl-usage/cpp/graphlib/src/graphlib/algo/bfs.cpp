@@ -1,116 +1,407 @@
 #include "graphlib/algo/bfs.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
-#include <queue>
+#include <memory>
+#include <random>
 
-namespace graphlib {
-
-void bfs(Graph* graph, const Vertex* search_root,
-         void (*process_vertex_early)(const Vertex* v),
-         void (*process_edge)(const Vertex* v1, const Vertex* v2,
-                              double weight),
-         void (*process_vertex_late)(const Vertex* v)) {
-  std::queue<const Vertex*> q;
-  q.push(search_root);
-
-  while (!q.empty()) {
-    const Vertex* v1 = q.front();
-    q.pop();
-
-    v1->state_ = Vertex::State::DISCOVERED;
-    if (process_vertex_early) {
-      process_vertex_early(v1);
-    }
+#include "graphlib/parallel.hpp"
+#include "graphlib/union_find.hpp"
 
-    for (auto& adj : graph->GetAdjacentSet(v1)) {
-      const Vertex* v2 = adj.first;
-      double weight = adj.second;
-      if (process_edge) {
-        process_edge(v1, v2, weight);
-      }
-      if (v2->state_ == Vertex::State::UNDISCOVERED) {
-        v2->state_ = Vertex::State::DISCOVERED;
-        v2->parent_ = v1;
-        q.push(v2);
-      }
-    }
+namespace graphlib {
 
-    if (process_vertex_late) {
-      process_vertex_late(v1);
-    }
-    v1->state_ = Vertex::State::PROCESSED;
-  }
+std::stack<const Vertex*> shortest_unweighted_path(const Graph* graph,
+                                                   const Vertex* search_root,
+                                                   const Vertex* destination) {
+  SearchState state(graph->NumVertices());
+  bfs(graph, search_root, &state);
+  return get_path(graph, state, graph->GetVertexPtr(*search_root),
+                  graph->GetVertexPtr(*destination));
 }
 
-std::stack<const Vertex*> shortest_unweighted_path(Graph* graph,
+std::stack<const Vertex*> shortest_unweighted_path(const CompactGraph* graph,
                                                    const Vertex* search_root,
                                                    const Vertex* destination) {
-  bfs(graph, search_root);
-  const Vertex* v = destination;
-  std::stack<const Vertex*> s;
-  s.push(v);
-
-  while (v != search_root) {
-    if (v) {
-      v = v->parent_;
-      s.push(v);
-    } else {
-      std::cerr << "No path between " << search_root->name_ << " and "
-                << destination->name_ << "\n\n";
-      return std::stack<const Vertex*>();
-    }
-  }
-  return s;
+  SearchState state(graph->NumVertices());
+  bfs(graph, search_root, &state);
+  return get_path(graph, state, search_root, destination);
 }
 
-std::vector<const Vertex*> g_component;
-
-std::vector<std::vector<const Vertex*>> connected_components(Graph* graph) {
-  g_component.clear();
+std::vector<std::vector<const Vertex*>> connected_components(
+    const Graph* graph) {
+  SearchState state(graph->NumVertices());
 
   std::vector<std::vector<const Vertex*>> components;
+  std::vector<const Vertex*> component;
   for (auto& p : graph->GetAdjacencyMap()) {
-    if (p.first->state_ == Vertex::State::UNDISCOVERED) {
-      bfs(graph, p.first, [](const Vertex* v) { g_component.push_back(v); });
-      components.push_back(g_component);
-      g_component.clear();
+    if (state.state_[p.first->id_] == VertexState::UNDISCOVERED) {
+      bfs(graph, p.first, &state,
+          [&](const Vertex* v) { component.push_back(v); });
+      components.push_back(component);
+      component.clear();
     }
   }
   return components;
 }
 
-bool g_is_bipartite = true;
-std::map<const Vertex*, int> g_color;  // "color" represented by 1 or -1
-
-bool is_bipartite(Graph* graph) {
-  g_is_bipartite = true;
-  g_color.clear();
-  for (const auto& p : graph->GetAdjacencyMap()) {
-    // We need to use a non-1 initial value to differentiate between tree edges
-    // and nondiscovery edges.
-    g_color[p.first] = 0;
-  }
+bool is_bipartite(const Graph* graph) {
+  // "Color" represented by 1 or -1, indexed by VertexId. We need to use a non-1
+  // initial value to differentiate between tree edges and nondiscovery edges.
+  std::vector<int> color(graph->NumVertices(), 0);
 
+  bool bipartite = true;
+  SearchState state(graph->NumVertices());
   for (auto& p : graph->GetAdjacencyMap()) {
-    if (p.first->state_ == Vertex::State::UNDISCOVERED) {
-      g_color.at(p.first) = 1;
-      bfs(graph, p.first, nullptr,
-          [](const Vertex* v1, const Vertex* v2, double weight) {
+    if (state.state_[p.first->id_] == VertexState::UNDISCOVERED) {
+      color[p.first->id_] = 1;
+      bfs(graph, p.first, &state, nullptr,
+          [&](const Vertex* v1, const Vertex* v2, double weight) {
             // Check for any nondiscovery edges that violate two-coloring.
-            if (g_color.at(v1) == g_color.at(v2)) {
-              std::cout << v1->name_ << " (color=" << g_color.at(v1) << ") and "
-                        << v2->name_ << " (color=" << g_color.at(v2)
-                        << ") violate bipartiteness\n";
-              g_is_bipartite = false;
+            if (color[v1->id_] == color[v2->id_]) {
+              std::cout << v1->name_ << " (color=" << color[v1->id_]
+                        << ") and " << v2->name_ << " (color="
+                        << color[v2->id_] << ") violate bipartiteness\n";
+              bipartite = false;
             }
 
             // Color any newly discovered Vertex to be the complement of its
             // parent.
-            g_color.at(v2) = -(g_color.at(v1));
+            color[v2->id_] = -color[v1->id_];
           });
     }
   }
-  return g_is_bipartite;
+  return bipartite;
+}
+
+std::vector<std::vector<const Vertex*>> connected_components(
+    const CompactGraph* graph) {
+  const VertexId num_vertices = graph->NumVertices();
+  std::vector<bool> discovered(num_vertices, false);
+
+  std::vector<std::vector<const Vertex*>> components;
+  std::vector<VertexId> q;  // reused across components as a FIFO queue
+  for (VertexId root = 0; root != num_vertices; ++root) {
+    if (discovered[root]) continue;
+
+    q.clear();
+    q.push_back(root);
+    discovered[root] = true;
+    for (std::size_t head = 0; head != q.size(); ++head) {
+      VertexId v1 = q[head];
+      for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1); ++e) {
+        VertexId v2 = graph->GetTarget(e);
+        if (!discovered[v2]) {
+          discovered[v2] = true;
+          q.push_back(v2);
+        }
+      }
+    }
+
+    components.emplace_back();
+    components.back().reserve(q.size());
+    for (VertexId v : q) {
+      components.back().push_back(graph->GetVertexPtr(v));
+    }
+  }
+  return components;
+}
+
+bool is_bipartite(const CompactGraph* graph) {
+  const VertexId num_vertices = graph->NumVertices();
+  std::vector<int> color(num_vertices, 0);  // 0 means undiscovered
+
+  bool bipartite = true;
+  std::vector<VertexId> q;
+  for (VertexId root = 0; root != num_vertices; ++root) {
+    if (color[root] != 0) continue;
+
+    q.clear();
+    q.push_back(root);
+    color[root] = 1;
+    for (std::size_t head = 0; head != q.size(); ++head) {
+      VertexId v1 = q[head];
+      for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1); ++e) {
+        VertexId v2 = graph->GetTarget(e);
+        if (color[v2] == 0) {
+          // Color any newly discovered vertex to be the complement of its
+          // parent.
+          color[v2] = -color[v1];
+          q.push_back(v2);
+        } else if (color[v2] == color[v1]) {
+          std::cout << graph->GetVertexPtr(v1)->name_ << " (color=" << color[v1]
+                    << ") and " << graph->GetVertexPtr(v2)->name_
+                    << " (color=" << color[v2] << ") violate bipartiteness\n";
+          bipartite = false;
+        }
+      }
+    }
+  }
+  return bipartite;
+}
+
+// Direction-optimizing heuristics (Beamer et al.): switch to bottom-up steps
+// once the edges out of the frontier outnumber 1/alpha of the edges out of
+// unexplored vertices, and back to top-down steps once the frontier is
+// shrinking and holds fewer than 1/beta of all vertices. Bottom-up steps are
+// only started while the frontier is growing: in the tail of a search over a
+// long, thin graph (e.g. a grid), few unexplored edges remain, but scanning
+// for the last few vertices bottom-up would still cost a pass over all of them.
+const std::size_t kBfsAlpha = 14, kBfsBeta = 24;
+
+// Smallest number of vertices (or frontier entries) worth handing to a thread.
+const std::size_t kBfsMinChunkSize = 1024;
+
+BfsTree parallel_bfs(const CompactGraph* graph, const Vertex* search_root,
+                     unsigned num_threads, const CompactGraph* reverse_graph) {
+  const VertexId root = graph->GetVertexId(search_root);
+  const std::size_t num_vertices = graph->NumVertices();
+  const std::size_t num_words = (num_vertices + 63) / 64;
+  if (num_threads == 0) num_threads = default_num_threads();
+
+  // Bottom-up steps need the incoming edges of each vertex.
+  std::unique_ptr<CompactGraph> built_reverse_graph;
+  const CompactGraph* in_graph = graph;
+  if (graph->IsDirected()) {
+    if (!reverse_graph) {
+      built_reverse_graph =
+          std::make_unique<CompactGraph>(graph->GetReverseGraph());
+      reverse_graph = built_reverse_graph.get();
+    }
+    in_graph = reverse_graph;
+  }
+
+  // A vertex is discovered once it has a parent. Top-down steps race to claim
+  // undiscovered vertices, so parents are atomic; hops are only written by the
+  // thread that set the parent. The root is its own parent until the end.
+  std::vector<std::atomic<VertexId>> parents(num_vertices);
+  BfsTree tree;
+  tree.hops_.assign(num_vertices, -1);
+  parallel_for(0, num_vertices, num_threads, kBfsMinChunkSize,
+               [&](std::size_t begin, std::size_t end, unsigned) {
+                 for (std::size_t v = begin; v != end; ++v) {
+                   parents[v].store(kNoVertex, std::memory_order_relaxed);
+                 }
+               });
+  parents[root].store(root, std::memory_order_relaxed);
+  tree.hops_[root] = 0;
+
+  // The frontier is a list of vertices during top-down steps, and a bitmap
+  // during bottom-up steps.
+  std::vector<VertexId> frontier = {root};
+  std::vector<std::uint64_t> frontier_bits, next_bits;
+  bool bottom_up = false;
+  std::size_t frontier_size = 1, previous_frontier_size = 0;
+  std::size_t frontier_edges = graph->Degree(root);
+  std::size_t unexplored_edges = graph->NumEdges() - frontier_edges;
+
+  // Per-thread results of each step.
+  std::vector<std::vector<VertexId>> next_frontiers(num_threads);
+  std::vector<std::size_t> found_vertices(num_threads);
+  std::vector<std::size_t> found_edges(num_threads);
+
+  for (int hops = 1; frontier_size != 0; ++hops) {
+    if (!bottom_up && frontier_size > previous_frontier_size &&
+        frontier_edges > unexplored_edges / kBfsAlpha) {
+      bottom_up = true;
+      frontier_bits.assign(num_words, 0);
+      next_bits.resize(num_words);
+      for (VertexId v : frontier) {
+        frontier_bits[v / 64] |= std::uint64_t(1) << (v % 64);
+      }
+    } else if (bottom_up && frontier_size < num_vertices / kBfsBeta &&
+               frontier_size < previous_frontier_size) {
+      bottom_up = false;
+      frontier.clear();
+      for (std::size_t w = 0; w != num_words; ++w) {
+        for (std::uint64_t bits = frontier_bits[w]; bits; bits &= bits - 1) {
+          std::size_t bit = 0;
+          while (!((bits >> bit) & 1)) ++bit;
+          frontier.push_back(static_cast<VertexId>(w * 64 + bit));
+        }
+      }
+    }
+
+    std::fill(found_vertices.begin(), found_vertices.end(), 0);
+    std::fill(found_edges.begin(), found_edges.end(), 0);
+    if (bottom_up) {
+      // Each thread owns whole words of the next frontier's bitmap, so it can
+      // write them without synchronization.
+      parallel_for(
+          0, num_words, num_threads, kBfsMinChunkSize / 64,
+          [&](std::size_t begin, std::size_t end, unsigned thread) {
+            for (std::size_t w = begin; w != end; ++w) {
+              std::uint64_t bits = 0;
+              const std::size_t last = std::min(num_vertices, 64 * w + 64);
+              for (std::size_t v = 64 * w; v != last; ++v) {
+                if (parents[v].load(std::memory_order_relaxed) != kNoVertex) {
+                  continue;
+                }
+                for (std::size_t e = in_graph->EdgeBegin(v);
+                     e != in_graph->EdgeEnd(v); ++e) {
+                  VertexId u = in_graph->GetTarget(e);
+                  if ((frontier_bits[u / 64] >> (u % 64)) & 1) {
+                    parents[v].store(u, std::memory_order_relaxed);
+                    tree.hops_[v] = hops;
+                    bits |= std::uint64_t(1) << (v % 64);
+                    ++found_vertices[thread];
+                    found_edges[thread] += graph->Degree(v);
+                    break;
+                  }
+                }
+              }
+              next_bits[w] = bits;
+            }
+          });
+      frontier_bits.swap(next_bits);
+    } else {
+      parallel_for(
+          0, frontier.size(), num_threads, kBfsMinChunkSize,
+          [&](std::size_t begin, std::size_t end, unsigned thread) {
+            std::vector<VertexId>& next = next_frontiers[thread];
+            next.clear();
+            for (std::size_t i = begin; i != end; ++i) {
+              VertexId v = frontier[i];
+              for (std::size_t e = graph->EdgeBegin(v); e != graph->EdgeEnd(v);
+                   ++e) {
+                VertexId u = graph->GetTarget(e);
+                VertexId no_parent = kNoVertex;
+                if (parents[u].load(std::memory_order_relaxed) == kNoVertex &&
+                    parents[u].compare_exchange_strong(
+                        no_parent, v, std::memory_order_relaxed)) {
+                  tree.hops_[u] = hops;
+                  next.push_back(u);
+                  found_edges[thread] += graph->Degree(u);
+                }
+              }
+            }
+            found_vertices[thread] = next.size();
+          });
+      frontier.clear();
+      for (std::vector<VertexId>& next : next_frontiers) {
+        frontier.insert(frontier.end(), next.begin(), next.end());
+        next.clear();
+      }
+    }
+
+    previous_frontier_size = frontier_size;
+    frontier_size = 0;
+    frontier_edges = 0;
+    for (unsigned t = 0; t != num_threads; ++t) {
+      frontier_size += found_vertices[t];
+      frontier_edges += found_edges[t];
+    }
+    unexplored_edges -= frontier_edges;
+  }
+
+  tree.parent_.resize(num_vertices);
+  for (std::size_t v = 0; v != num_vertices; ++v) {
+    tree.parent_[v] = parents[v].load(std::memory_order_relaxed);
+  }
+  tree.parent_[root] = kNoVertex;
+  return tree;
+}
+
+// Afforest parameters: the number of edges of each vertex merged before looking
+// for the giant component, and the number of vertices sampled to find it.
+const std::size_t kAfforestNeighborRounds = 2;
+const std::size_t kAfforestNumSamples = 1024;
+
+ConnectedComponents parallel_component_ids(const CompactGraph* graph,
+                                           unsigned num_threads) {
+  const std::size_t num_vertices = graph->NumVertices();
+  if (num_threads == 0) num_threads = default_num_threads();
+  ConcurrentUnionFind components(num_vertices);
+
+  // Merge the first few edges of each vertex, one round at a time, so that the
+  // merges of each round spread across the whole graph.
+  for (std::size_t round = 0; round != kAfforestNeighborRounds; ++round) {
+    parallel_for(0, num_vertices, num_threads, kBfsMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t v = begin; v != end; ++v) {
+                     if (graph->Degree(v) > round) {
+                       components.Union(
+                           v, graph->GetTarget(graph->EdgeBegin(v) + round));
+                     }
+                   }
+                 });
+  }
+
+  // The most common subset among a random sample of vertices is most likely the
+  // giant component, if there is one.
+  VertexId giant = kNoVertex;
+  if (!graph->IsDirected() && num_vertices != 0) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<VertexId> vertex_distribution(
+        0, num_vertices - 1);
+    std::vector<VertexId> samples(kAfforestNumSamples);
+    for (VertexId& sample : samples) {
+      sample = components.Find(vertex_distribution(rng));
+    }
+    std::sort(samples.begin(), samples.end());
+    std::size_t most_count = 0;
+    for (std::size_t i = 0, j; i != samples.size(); i = j) {
+      for (j = i; j != samples.size() && samples[j] == samples[i]; ++j) {
+      }
+      if (j - i > most_count) {
+        most_count = j - i;
+        giant = samples[i];
+      }
+    }
+  }
+
+  parallel_for(0, num_vertices, num_threads, kBfsMinChunkSize,
+               [&](std::size_t begin, std::size_t end, unsigned) {
+                 for (std::size_t v = begin; v != end; ++v) {
+                   if (components.Find(v) == giant) continue;
+                   for (std::size_t e =
+                            graph->EdgeBegin(v) + kAfforestNeighborRounds;
+                        e < graph->EdgeEnd(v); ++e) {
+                     components.Union(v, graph->GetTarget(e));
+                   }
+                 }
+               });
+
+  // Each subset is now named by its smallest VertexId. Number these roots in
+  // order, counting them per chunk first; parallel_for splits the vertices the
+  // same way both times. Then each vertex takes its root's number.
+  std::vector<VertexId> roots(num_vertices);
+  std::vector<int> chunk_roots(num_threads + 1, 0);
+  parallel_for(0, num_vertices, num_threads, kBfsMinChunkSize,
+               [&](std::size_t begin, std::size_t end, unsigned thread) {
+                 int num_roots = 0;
+                 for (std::size_t v = begin; v != end; ++v) {
+                   roots[v] = components.Find(v);
+                   if (roots[v] == static_cast<VertexId>(v)) ++num_roots;
+                 }
+                 chunk_roots[thread + 1] = num_roots;
+               });
+  for (unsigned t = 0; t != num_threads; ++t) {
+    chunk_roots[t + 1] += chunk_roots[t];
+  }
+
+  ConnectedComponents result;
+  result.component_id_.resize(num_vertices);
+  parallel_for(0, num_vertices, num_threads, kBfsMinChunkSize,
+               [&](std::size_t begin, std::size_t end, unsigned thread) {
+                 int next_id = chunk_roots[thread];
+                 for (std::size_t v = begin; v != end; ++v) {
+                   if (roots[v] == static_cast<VertexId>(v)) {
+                     result.component_id_[v] = next_id++;
+                   }
+                 }
+               });
+  parallel_for(0, num_vertices, num_threads, kBfsMinChunkSize,
+               [&](std::size_t begin, std::size_t end, unsigned) {
+                 for (std::size_t v = begin; v != end; ++v) {
+                   if (roots[v] != static_cast<VertexId>(v)) {
+                     result.component_id_[v] = result.component_id_[roots[v]];
+                   }
+                 }
+               });
+  result.num_components_ = chunk_roots[num_threads];
+  return result;
 }
 
 void print_vertex(const Vertex* v) {
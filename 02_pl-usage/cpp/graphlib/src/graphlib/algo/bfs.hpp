@@ -1,31 +1,162 @@
 #pragma once
 
+#include "graphlib/algo/callbacks.hpp"
+#include "graphlib/compact_graph.hpp"
 #include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
 
+#include <cstddef>
+#include <queue>
 #include <stack>
 #include <vector>
 
 namespace graphlib {
 
 // Traditional BFS algorithm. Results in a complete BFS search tree encoded in
-// the parent members of each Vertex.
-void bfs(Graph* graph, const Vertex* search_root,
-         void (*process_vertex_early)(const Vertex* v) = nullptr,
-         void (*process_edge)(const Vertex* v1, const Vertex* v2,
-                              double weight) = nullptr,
-         void (*process_vertex_late)(const Vertex* v) = nullptr);
+// the given SearchState. The SearchState may be reused across several searches,
+// in which case vertices discovered by earlier searches are not visited again.
+//
+// The callbacks are called as process_vertex_early(v), process_edge(v1, v2,
+// weight), and process_vertex_late(v), with const Vertex* arguments. See
+// callbacks.hpp for what may be passed.
+template <typename ProcessVertexEarly = std::nullptr_t,
+          typename ProcessEdge = std::nullptr_t,
+          typename ProcessVertexLate = std::nullptr_t>
+void bfs(const Graph* graph, const Vertex* search_root, SearchState* state,
+         ProcessVertexEarly process_vertex_early = nullptr,
+         ProcessEdge process_edge = nullptr,
+         ProcessVertexLate process_vertex_late = nullptr) {
+  std::queue<const Vertex*> q;
+  q.push(graph->GetVertexPtr(*search_root));
+
+  while (!q.empty()) {
+    const Vertex* v1 = q.front();
+    q.pop();
+
+    state->state_[v1->id_] = VertexState::DISCOVERED;
+    if (!invoke_callback(process_vertex_early, v1)) return;
+
+    for (auto& adj : graph->GetAdjacentSet(v1)) {
+      const Vertex* v2 = adj.first;
+      double weight = adj.second;
+      if (!invoke_callback(process_edge, v1, v2, weight)) return;
+      if (state->state_[v2->id_] == VertexState::UNDISCOVERED) {
+        state->state_[v2->id_] = VertexState::DISCOVERED;
+        state->parent_[v2->id_] = v1->id_;
+        q.push(v2);
+      }
+    }
+
+    if (!invoke_callback(process_vertex_late, v1)) return;
+    state->state_[v1->id_] = VertexState::PROCESSED;
+  }
+}
 
 // Repeatedly pop the stack returned by this function to obtain shortest
 // unweighted path.
-std::stack<const Vertex*> shortest_unweighted_path(Graph* graph,
+std::stack<const Vertex*> shortest_unweighted_path(const Graph* graph,
                                                    const Vertex* search_root,
                                                    const Vertex* destination);
 
 // Connected components (not strong).
-std::vector<std::vector<const Vertex*>> connected_components(Graph* graph);
+std::vector<std::vector<const Vertex*>> connected_components(
+    const Graph* graph);
 
 // Check if a graph is two-colorable.
-bool is_bipartite(Graph* graph);
+bool is_bipartite(const Graph* graph);
+
+// CompactGraph overloads of the above.
+template <typename ProcessVertexEarly = std::nullptr_t,
+          typename ProcessEdge = std::nullptr_t,
+          typename ProcessVertexLate = std::nullptr_t>
+void bfs(const CompactGraph* graph, const Vertex* search_root,
+         SearchState* state, ProcessVertexEarly process_vertex_early = nullptr,
+         ProcessEdge process_edge = nullptr,
+         ProcessVertexLate process_vertex_late = nullptr) {
+  std::queue<VertexId> q;
+  q.push(graph->GetVertexId(search_root));
+
+  while (!q.empty()) {
+    VertexId v1 = q.front();
+    q.pop();
+
+    state->state_[v1] = VertexState::DISCOVERED;
+    if (!invoke_callback(process_vertex_early, graph->GetVertexPtr(v1))) {
+      return;
+    }
+
+    for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1); ++e) {
+      VertexId v2 = graph->GetTarget(e);
+      if (!invoke_callback(process_edge, graph->GetVertexPtr(v1),
+                           graph->GetVertexPtr(v2), graph->GetWeight(e))) {
+        return;
+      }
+      if (state->state_[v2] == VertexState::UNDISCOVERED) {
+        state->state_[v2] = VertexState::DISCOVERED;
+        state->parent_[v2] = v1;
+        q.push(v2);
+      }
+    }
+
+    if (!invoke_callback(process_vertex_late, graph->GetVertexPtr(v1))) {
+      return;
+    }
+    state->state_[v1] = VertexState::PROCESSED;
+  }
+}
+
+std::stack<const Vertex*> shortest_unweighted_path(const CompactGraph* graph,
+                                                   const Vertex* search_root,
+                                                   const Vertex* destination);
+std::vector<std::vector<const Vertex*>> connected_components(
+    const CompactGraph* graph);
+bool is_bipartite(const CompactGraph* graph);
+
+// Result of parallel_bfs, indexed by VertexId: the number of hops (edges) on a
+// shortest path from the search root (-1 if there is no path), and the parent
+// in the BFS search tree (kNoVertex for the search root and unreached
+// vertices).
+struct BfsTree {
+  std::vector<int> hops_;
+  std::vector<VertexId> parent_;
+};
+
+// Multithreaded BFS for unweighted reachability and hop distances, without
+// callbacks. The graph is explored one level at a time. Each level is expanded
+// either top-down (frontier vertices claim their undiscovered neighbors) or,
+// once the frontier gets large, bottom-up (undiscovered vertices look for a
+// parent in a bitmap of the frontier), as in Beamer et al.'s
+// "direction-optimizing" BFS.
+//
+// Bottom-up steps follow incoming edges. For a directed graph, pass its reverse
+// (see CompactGraph::GetReverseGraph) if it's already at hand; otherwise one is
+// built. Uses num_threads threads, or one per hardware thread if 0.
+BfsTree parallel_bfs(const CompactGraph* graph, const Vertex* search_root,
+                     unsigned num_threads = 0,
+                     const CompactGraph* reverse_graph = nullptr);
+
+// Result of parallel_component_ids: the component of each Vertex, indexed by
+// VertexId, numbered from 0 in order of each component's smallest VertexId
+// (the order connected_components lists them in).
+struct ConnectedComponents {
+  std::vector<int> component_id_;
+  int num_components_;
+};
+
+// Multithreaded connected components, without callbacks. Instead of searching
+// from each vertex in turn, the edges are merged into a ConcurrentUnionFind by
+// all threads at once, following Sutton et al.'s "Afforest": first only the
+// first two edges of each vertex, which is usually enough to gather most of the
+// vertices into one giant component. A sample of vertices tells which one it
+// is, and the remaining edges of its vertices are skipped, since each of them
+// is also stored in the other direction, where it's merged from the other end
+// unless that end has joined the giant component too.
+//
+// For a directed graph, this finds the weakly connected components (edge
+// directions are ignored), and no edges can be skipped. Uses num_threads
+// threads, or one per hardware thread if 0.
+ConnectedComponents parallel_component_ids(const CompactGraph* graph,
+                                           unsigned num_threads = 0);
 
 // Misc common vertex and edge processing functions
 void print_vertex(const Vertex* v);
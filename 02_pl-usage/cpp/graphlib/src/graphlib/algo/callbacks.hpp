@@ -0,0 +1,53 @@
+/*
+Helpers for the callbacks ("hooks") taken by the traversals in bfs.hpp and
+dfs.hpp, following Skiena's pattern of building algorithms on top of a common
+traversal by processing vertices and edges as they're found.
+
+The traversals are templates over the types of their callbacks, so a callback
+can be any callable: a function pointer, a function object holding state of its
+own, or a capturing lambda. This means algorithms built on a traversal can keep
+their state in local variables (and so be reentrant), and calls to the
+callbacks can be inlined.
+
+A hook that isn't needed is passed as nullptr (the default). This is detected at
+compile time, and the call is left out of the traversal entirely. A callback
+may also return a bool, in which case returning false terminates the search
+early.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace graphlib {
+
+// Whether a callback of type Callback is just a placeholder for a hook that
+// isn't needed.
+template <typename Callback>
+constexpr bool kIsNoCallback =
+    std::is_same_v<std::decay_t<Callback>, std::nullptr_t>;
+
+// Calls callback(args...) unless it's a placeholder (or a null function
+// pointer), and returns whether the search should go on: false only if the
+// callback returned false.
+template <typename Callback, typename... Args>
+bool invoke_callback(Callback& callback, Args&&... args) {
+  if constexpr (kIsNoCallback<Callback>) {
+    return true;
+  } else {
+    if constexpr (std::is_pointer_v<Callback>) {
+      if (!callback) return true;
+    }
+    using Result = decltype(callback(std::forward<Args>(args)...));
+    if constexpr (std::is_same_v<Result, bool>) {
+      return callback(std::forward<Args>(args)...);
+    } else {
+      callback(std::forward<Args>(args)...);
+      return true;
+    }
+  }
+}
+
+}  // namespace graphlib
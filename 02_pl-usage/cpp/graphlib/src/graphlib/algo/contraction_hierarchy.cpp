@@ -0,0 +1,401 @@
+#include "graphlib/algo/contraction_hierarchy.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace graphlib {
+
+const std::size_t kNoHierarchyEdge = static_cast<std::size_t>(-1);
+
+// Most vertices a witness search settles before giving up (and letting the
+// shortcut it was checking be added).
+const std::size_t kWitnessSettleLimit = 100;
+
+class ContractionHierarchy::Builder {
+ public:
+  Builder(const CompactGraph& graph, ContractionHierarchy* hierarchy);
+
+  // Contracts every vertex, and lays out the edges for queries.
+  void Run();
+
+ private:
+  // Adds an edge (or shortcut) unless there's already one at least as short
+  // between the same vertices, which it otherwise replaces.
+  void AddEdge(const HierarchyEdge& edge);
+
+  // Finds the shortcuts that contracting v would take, into shortcuts_.
+  void FindShortcuts(VertexId v);
+
+  // Priority of v in the contraction order (lower goes first), given its
+  // shortcuts from FindShortcuts. Twice the edge difference, plus the number
+  // of contracted neighbors, plus the level of v: one more than the highest
+  // level among its contracted neighbors, which keeps the hierarchy (and so
+  // the queries' searches) shallow.
+  double Priority(VertexId v) const;
+
+  // Dijkstra's algorithm from source over the vertices other than skipped, up
+  // to distance limit, into witness_dist_. Gives up after kWitnessSettleLimit
+  // vertices, or once num_targets vertices marked in is_target_ are settled.
+  // ResetWitness undoes it.
+  void WitnessSearch(VertexId source, VertexId skipped, double limit,
+                     std::size_t num_targets);
+  void ResetWitness();
+
+  ContractionHierarchy* hierarchy_;
+  std::vector<HierarchyEdge>& edges_;
+  const std::size_t num_vertices_;
+
+  // The graph left to contract: the edges out of and into each uncontracted
+  // vertex, from and to other uncontracted vertices.
+  std::vector<std::vector<SearchEdge>> out_, in_;
+  std::vector<HierarchyEdge> shortcuts_;
+
+  std::vector<bool> contracted_;
+  std::vector<bool> stale_;  // whether a neighbor was contracted since
+  std::vector<int> deleted_neighbors_, levels_;
+
+  std::vector<double> witness_dist_;
+  std::vector<VertexId> witness_touched_;
+  std::vector<bool> is_target_;
+  IndexedMinHeap<> witness_heap_;
+};
+
+ContractionHierarchy::Builder::Builder(const CompactGraph& graph,
+                                       ContractionHierarchy* hierarchy)
+    : hierarchy_(hierarchy),
+      edges_(hierarchy->edges_),
+      num_vertices_(graph.NumVertices()),
+      out_(num_vertices_),
+      in_(num_vertices_),
+      contracted_(num_vertices_, false),
+      stale_(num_vertices_, false),
+      deleted_neighbors_(num_vertices_, 0),
+      levels_(num_vertices_, 0),
+      witness_dist_(num_vertices_, std::numeric_limits<double>::infinity()),
+      is_target_(num_vertices_, false),
+      witness_heap_(num_vertices_) {
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices_); ++v) {
+    for (std::size_t e = graph.EdgeBegin(v); e != graph.EdgeEnd(v); ++e) {
+      if (graph.GetWeight(e) < 0) {
+        throw std::runtime_error(
+            "ContractionHierarchy::ContractionHierarchy error! Negative edge "
+            "weight.\n");
+      }
+      if (graph.GetTarget(e) != v) {
+        AddEdge({v, graph.GetTarget(e), graph.GetWeight(e), kNoHierarchyEdge,
+                 kNoHierarchyEdge});
+      }
+    }
+  }
+}
+
+void ContractionHierarchy::Builder::AddEdge(const HierarchyEdge& edge) {
+  const std::size_t index = edges_.size();
+  for (SearchEdge& out : out_[edge.from_]) {
+    if (out.target_ != edge.to_) continue;
+    if (out.weight_ <= edge.weight_) return;
+    for (SearchEdge& in : in_[edge.to_]) {
+      if (in.edge_ == out.edge_) in = {edge.from_, edge.weight_, index};
+    }
+    out = {edge.to_, edge.weight_, index};
+    edges_.push_back(edge);
+    return;
+  }
+  out_[edge.from_].push_back({edge.to_, edge.weight_, index});
+  in_[edge.to_].push_back({edge.from_, edge.weight_, index});
+  edges_.push_back(edge);
+}
+
+void ContractionHierarchy::Builder::WitnessSearch(VertexId source,
+                                                  VertexId skipped,
+                                                  double limit,
+                                                  std::size_t num_targets) {
+  witness_dist_[source] = 0;
+  witness_touched_.push_back(source);
+  witness_heap_.Push(source, 0);
+  std::size_t settled = 0;
+  while (!witness_heap_.Empty() && witness_heap_.TopKey() <= limit &&
+         settled++ != kWitnessSettleLimit && num_targets != 0) {
+    const VertexId v1 = witness_heap_.Pop();
+    num_targets -= is_target_[v1];
+    for (const SearchEdge& out : out_[v1]) {
+      const VertexId v2 = out.target_;
+      const double dist = witness_dist_[v1] + out.weight_;
+      if (v2 == skipped || dist >= witness_dist_[v2]) continue;
+      if (witness_dist_[v2] == std::numeric_limits<double>::infinity()) {
+        witness_touched_.push_back(v2);
+      }
+      witness_dist_[v2] = dist;
+      witness_heap_.PushOrDecreaseKey(v2, dist);
+    }
+  }
+}
+
+void ContractionHierarchy::Builder::ResetWitness() {
+  while (!witness_heap_.Empty()) witness_heap_.Pop();
+  for (VertexId v : witness_touched_) {
+    witness_dist_[v] = std::numeric_limits<double>::infinity();
+  }
+  witness_touched_.clear();
+}
+
+void ContractionHierarchy::Builder::FindShortcuts(VertexId v) {
+  shortcuts_.clear();
+  for (const SearchEdge& out : out_[v]) is_target_[out.target_] = true;
+  for (const SearchEdge& in : in_[v]) {
+    const VertexId u = in.target_;
+    double max_out = -1;
+    for (const SearchEdge& out : out_[v]) {
+      if (out.target_ != u) max_out = std::max(max_out, out.weight_);
+    }
+    if (max_out < 0) continue;
+
+    // A shortcut u -> v -> x is needed unless there's a path from u to x
+    // that avoids v and is no longer.
+    WitnessSearch(u, v, in.weight_ + max_out, out_[v].size());
+    for (const SearchEdge& out : out_[v]) {
+      const double dist = in.weight_ + out.weight_;
+      if (out.target_ != u && witness_dist_[out.target_] > dist) {
+        shortcuts_.push_back({u, out.target_, dist, in.edge_, out.edge_});
+      }
+    }
+    ResetWitness();
+  }
+  for (const SearchEdge& out : out_[v]) is_target_[out.target_] = false;
+}
+
+double ContractionHierarchy::Builder::Priority(VertexId v) const {
+  const double edge_difference =
+      static_cast<double>(shortcuts_.size()) -
+      static_cast<double>(in_[v].size() + out_[v].size());
+  return 2 * edge_difference + deleted_neighbors_[v] + levels_[v];
+}
+
+void ContractionHierarchy::Builder::Run() {
+  IndexedMinHeap<> order(num_vertices_);
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices_); ++v) {
+    FindShortcuts(v);
+    order.Push(v, Priority(v));
+  }
+
+  // Contracting a vertex changes the priorities of its neighbors, so they're
+  // marked stale, and rechecked lazily: a stale vertex that comes to the top
+  // of the queue goes back in if its priority went up past the next one's.
+  std::vector<std::vector<SearchEdge>> up(num_vertices_), down(num_vertices_);
+  std::size_t rank = 0;
+  while (!order.Empty()) {
+    const VertexId v = order.Pop();
+    FindShortcuts(v);
+    if (stale_[v]) {
+      stale_[v] = false;
+      const double priority = Priority(v);
+      if (!order.Empty() && priority > order.TopKey()) {
+        order.Push(v, priority);
+        continue;
+      }
+    }
+
+    for (const HierarchyEdge& shortcut : shortcuts_) AddEdge(shortcut);
+    hierarchy_->ranks_[v] = rank++;
+    contracted_[v] = true;
+    // The edges left at v all lead to vertices contracted later, i.e. up in
+    // rank. Those vertices drop their edges to v.
+    up[v] = std::move(out_[v]);
+    down[v] = std::move(in_[v]);
+    auto is_contracted = [&](const SearchEdge& edge) {
+      return contracted_[edge.target_];
+    };
+    for (const std::vector<SearchEdge>* edges : {&up[v], &down[v]}) {
+      for (const SearchEdge& edge : *edges) {
+        const VertexId neighbor = edge.target_;
+        stale_[neighbor] = true;
+        ++deleted_neighbors_[neighbor];
+        levels_[neighbor] = std::max(levels_[neighbor], levels_[v] + 1);
+        for (auto* list : {&out_[neighbor], &in_[neighbor]}) {
+          list->erase(std::remove_if(list->begin(), list->end(), is_contracted),
+                      list->end());
+        }
+      }
+    }
+  }
+
+  auto flatten = [&](const std::vector<std::vector<SearchEdge>>& lists,
+                     std::vector<std::size_t>* offsets,
+                     std::vector<SearchEdge>* edges) {
+    offsets->assign(1, 0);
+    for (const std::vector<SearchEdge>& list : lists) {
+      edges->insert(edges->end(), list.begin(), list.end());
+      offsets->push_back(edges->size());
+      for (const SearchEdge& edge : list) {
+        hierarchy_->num_shortcuts_ +=
+            edges_[edge.edge_].first_ != kNoHierarchyEdge;
+      }
+    }
+  };
+  flatten(up, &hierarchy_->up_offsets_, &hierarchy_->up_edges_);
+  flatten(down, &hierarchy_->down_offsets_, &hierarchy_->down_edges_);
+}
+
+ContractionHierarchy::QueryState::Side::Side(std::size_t num_vertices)
+    : dist_(num_vertices, std::numeric_limits<double>::infinity()),
+      parent_edge_(num_vertices, kNoHierarchyEdge),
+      heap_(num_vertices) {}
+
+ContractionHierarchy::QueryState::QueryState(std::size_t num_vertices)
+    : forward_(num_vertices), backward_(num_vertices) {}
+
+ContractionHierarchy::ContractionHierarchy(const Graph& graph)
+    : ContractionHierarchy(CompactGraph(graph)) {}
+
+ContractionHierarchy::ContractionHierarchy(const CompactGraph& graph)
+    : ranks_(graph.NumVertices()) {
+  vertices_.reserve(graph.NumVertices());
+  for (VertexId v = 0; v != static_cast<VertexId>(graph.NumVertices()); ++v) {
+    vertices_.push_back(graph.GetVertexPtr(v));
+  }
+  Builder(graph, this).Run();
+}
+
+void ContractionHierarchy::SettleNext(QueryState* state, bool forward) const {
+  QueryState::Side& side = forward ? state->forward_ : state->backward_;
+  QueryState::Side& other = forward ? state->backward_ : state->forward_;
+  const std::vector<std::size_t>& offsets =
+      forward ? up_offsets_ : down_offsets_;
+  const std::vector<SearchEdge>& edges = forward ? up_edges_ : down_edges_;
+  const std::vector<std::size_t>& stall_offsets =
+      forward ? down_offsets_ : up_offsets_;
+  const std::vector<SearchEdge>& stall_edges =
+      forward ? down_edges_ : up_edges_;
+
+  const VertexId v1 = side.heap_.Pop();
+  const double dist = side.dist_[v1];
+  // Stall-on-demand: if a higher-ranked vertex this side has reached has a
+  // shorter way down to v1, no shortest path goes up through v1.
+  for (std::size_t i = stall_offsets[v1]; i != stall_offsets[v1 + 1]; ++i) {
+    if (side.dist_[stall_edges[i].target_] + stall_edges[i].weight_ < dist) {
+      return;
+    }
+  }
+
+  for (std::size_t i = offsets[v1]; i != offsets[v1 + 1]; ++i) {
+    const VertexId v2 = edges[i].target_;
+    const double dist_v2 = dist + edges[i].weight_;
+    if (dist_v2 >= side.dist_[v2]) continue;
+    if (side.dist_[v2] == std::numeric_limits<double>::infinity() &&
+        other.dist_[v2] == std::numeric_limits<double>::infinity()) {
+      state->touched_.push_back(v2);
+    }
+    side.dist_[v2] = dist_v2;
+    side.parent_edge_[v2] = edges[i].edge_;
+    side.heap_.PushOrDecreaseKey(v2, dist_v2);
+    if (dist_v2 + other.dist_[v2] < state->distance_) {
+      state->distance_ = dist_v2 + other.dist_[v2];
+      state->meeting_vertex_ = v2;
+    }
+  }
+}
+
+double ContractionHierarchy::Query(const Vertex* source,
+                                   const Vertex* destination,
+                                   QueryState* state) const {
+  for (const Vertex* v : {source, destination}) {
+    if (static_cast<std::size_t>(v->id_) >= NumVertices() ||
+        vertices_[v->id_] != v) {
+      throw std::runtime_error(
+          "ContractionHierarchy::Query error! Given Vertex not in the "
+          "hierarchy's graph.\n");
+    }
+  }
+  if (state->forward_.dist_.size() != NumVertices()) {
+    throw std::runtime_error(
+        "ContractionHierarchy::Query error! QueryState is for a different "
+        "number of vertices.\n");
+  }
+
+  for (QueryState::Side* side : {&state->forward_, &state->backward_}) {
+    while (!side->heap_.Empty()) side->heap_.Pop();
+    for (VertexId v : state->touched_) {
+      side->dist_[v] = std::numeric_limits<double>::infinity();
+    }
+  }
+  state->touched_.clear();
+
+  const VertexId s = source->id_, t = destination->id_;
+  state->source_ = source;
+  state->destination_ = destination;
+  state->forward_.dist_[s] = 0;
+  state->forward_.heap_.Push(s, 0);
+  state->backward_.dist_[t] = 0;
+  state->backward_.heap_.Push(t, 0);
+  state->touched_.push_back(s);
+  state->touched_.push_back(t);
+  state->meeting_vertex_ = s == t ? s : kNoVertex;
+  state->distance_ = s == t ? 0 : std::numeric_limits<double>::infinity();
+
+  // A side is done once its closest vertex is no closer than the shortest
+  // path found so far. Until both are, take the closer of the two.
+  while (true) {
+    const bool forward = !state->forward_.heap_.Empty() &&
+                         state->forward_.heap_.TopKey() < state->distance_;
+    const bool backward = !state->backward_.heap_.Empty() &&
+                          state->backward_.heap_.TopKey() < state->distance_;
+    if (!forward && !backward) break;
+    SettleNext(state, forward && (!backward ||
+                                  state->forward_.heap_.TopKey() <=
+                                      state->backward_.heap_.TopKey()));
+  }
+  return state->distance_;
+}
+
+std::stack<const Vertex*> ContractionHierarchy::GetPath(
+    const QueryState& state) const {
+  if (state.meeting_vertex_ == kNoVertex) return std::stack<const Vertex*>();
+
+  // Edges from the source up to the meeting vertex, then down to the
+  // destination.
+  std::vector<std::size_t> path_edges;
+  for (VertexId v = state.meeting_vertex_; v != state.source_->id_;) {
+    path_edges.push_back(state.forward_.parent_edge_[v]);
+    v = edges_[path_edges.back()].from_;
+  }
+  std::reverse(path_edges.begin(), path_edges.end());
+  for (VertexId v = state.meeting_vertex_; v != state.destination_->id_;) {
+    path_edges.push_back(state.backward_.parent_edge_[v]);
+    v = edges_[path_edges.back()].to_;
+  }
+
+  // Unpack each shortcut into the two edges it stands for, depth first.
+  std::vector<VertexId> path = {state.source_->id_};
+  std::vector<std::size_t> pending;
+  for (std::size_t e : path_edges) {
+    pending.push_back(e);
+    while (!pending.empty()) {
+      const HierarchyEdge& edge = edges_[pending.back()];
+      pending.pop_back();
+      if (edge.first_ == kNoHierarchyEdge) {
+        path.push_back(edge.to_);
+      } else {
+        pending.push_back(edge.second_);
+        pending.push_back(edge.first_);
+      }
+    }
+  }
+
+  std::stack<const Vertex*> s;
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    s.push(vertices_[*it]);
+  }
+  return s;
+}
+
+std::stack<const Vertex*> shortest_pos_weight_path(
+    const ContractionHierarchy* hierarchy, const Vertex* search_root,
+    const Vertex* destination) {
+  ContractionHierarchy::QueryState state(hierarchy->NumVertices());
+  hierarchy->Query(search_root, destination, &state);
+  return hierarchy->GetPath(state);
+}
+
+}  // namespace graphlib
@@ -0,0 +1,160 @@
+/*
+A "ContractionHierarchy" preprocesses a static graph with non-negative edge
+weights so that shortest paths between any two vertices can be found by
+searching only a tiny part of it, instead of rerunning Dijkstra's algorithm
+from scratch for every query (Geisberger et al.).
+
+Preprocessing "contracts" the vertices one at a time, from least to most
+important: a contracted vertex v is removed from the graph, and wherever the
+only shortest path from a remaining neighbor u to another remaining neighbor x
+went through v, a "shortcut" edge (u, x) is added in its place, with the length
+of the path u -> v -> x. To decide whether a shortcut is needed, a "witness
+search" (a Dijkstra search from u that avoids v, cut off after a hundred
+settled vertices) looks for another path that's at least as short; if it gives
+up early, the shortcut is just added anyway, which is never wrong. The order of
+contraction is picked greedily by a priority queue, favoring vertices whose
+contraction adds few shortcuts for the edges it removes (the "edge
+difference"), and vertices in areas with few contracted neighbors yet, so that
+contraction proceeds evenly over the graph. Each vertex's rank is its position
+in the order.
+
+Every shortest path in the graph then has an equally short counterpart, made of
+original edges and shortcuts, that first only goes up in rank and then only
+goes down. A query is a bidirectional Dijkstra search that follows only edges
+going up in rank: forward from the source, and backward (along incoming edges)
+from the destination. The two searches meet at the highest-ranked vertex of the
+path. On road-like graphs, each side settles a few hundred vertices, whatever
+the size of the graph, so a query takes microseconds. Each search also skips
+("stalls") vertices it has reached by a path that's beaten by one coming down
+from a higher-ranked vertex, since no shortest path can go through them.
+Graphs without this kind of hierarchy (e.g. random graphs with no geometry to
+them) end up with a dense core of shortcuts, and take far longer to preprocess.
+
+The edges that go up in rank out of each vertex, and the ones coming down into
+it, are kept in two compressed sparse row arrays (as in CompactGraph) for the
+queries. Each shortcut remembers the two edges it replaced, so a path of
+shortcuts can be "unpacked" back into a path of the graph's own edges.
+
+A ContractionHierarchy refers to the Vertex instances owned by its source Graph
+(and uses its VertexIds), so the source Graph must outlive it. It's read-only
+once built, so any number of threads can query it at once, each with its own
+QueryState.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <stack>
+#include <vector>
+
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/graph.hpp"
+#include "graphlib/indexed_heap.hpp"
+
+namespace graphlib {
+
+class ContractionHierarchy {
+ public:
+  // Per-query state (distances, search tree edges, and heaps of both sides of
+  // the search), reused across queries. Only the parts of it touched by a
+  // query are reset by the next one, so a query doesn't take O(V) time.
+  class QueryState {
+   public:
+    explicit QueryState(std::size_t num_vertices);
+
+    // Distance from the source to the destination found by the last query
+    // (infinite if there's no path).
+    double Distance() const { return distance_; }
+
+   private:
+    friend class ContractionHierarchy;
+
+    // Search state of one side of the query.
+    struct Side {
+      explicit Side(std::size_t num_vertices);
+
+      std::vector<double> dist_;
+      std::vector<std::size_t> parent_edge_;  // edge the search came in on
+      IndexedMinHeap<> heap_;
+    };
+
+    Side forward_, backward_;
+    std::vector<VertexId> touched_;  // vertices to reset before the next query
+    const Vertex* source_ = nullptr;
+    const Vertex* destination_ = nullptr;
+    VertexId meeting_vertex_ = kNoVertex;
+    double distance_ = std::numeric_limits<double>::infinity();
+  };
+
+  // Preprocesses the given graph, whose edge weights must be non-negative.
+  explicit ContractionHierarchy(const Graph& graph);
+  explicit ContractionHierarchy(const CompactGraph& graph);
+
+  std::size_t NumVertices() const { return vertices_.size(); }
+
+  // Number of shortcut edges added by preprocessing.
+  std::size_t NumShortcuts() const { return num_shortcuts_; }
+
+  // Rank of the given vertex in the contraction order (0 was contracted
+  // first).
+  std::size_t GetRank(VertexId v) const { return ranks_[v]; }
+
+  // Returns the distance of a shortest path from source to destination
+  // (infinite if there's none). The search is left in the given QueryState,
+  // for GetPath. Throws if source or destination isn't a Vertex of the graph
+  // the hierarchy was built from, or if the QueryState is for another size.
+  double Query(const Vertex* source, const Vertex* destination,
+               QueryState* state) const;
+
+  // Repeatedly pop the returned stack to obtain the shortest path found by the
+  // last query run on the given QueryState, in terms of the graph's own edges.
+  // The stack is empty if there is no path.
+  std::stack<const Vertex*> GetPath(const QueryState& state) const;
+
+ private:
+  // Contracts the vertices of a graph, filling in the members below.
+  class Builder;
+
+  // An edge of the graph, or a shortcut standing for the path first_ then
+  // second_ (both indices into edges_).
+  struct HierarchyEdge {
+    VertexId from_, to_;
+    double weight_;
+    std::size_t first_, second_;
+  };
+
+  // An edge as listed under one of its ends: the vertex at its other end, its
+  // weight, and its index in edges_.
+  struct SearchEdge {
+    VertexId target_;
+    double weight_;
+    std::size_t edge_;
+  };
+
+  // Settles the top vertex of the given side of the query, relaxing its edges
+  // up in rank unless it's stalled.
+  void SettleNext(QueryState* state, bool forward) const;
+
+  std::vector<const Vertex*> vertices_;  // id -> Vertex
+  std::vector<std::size_t> ranks_;
+
+  std::vector<HierarchyEdge> edges_;
+  std::size_t num_shortcuts_ = 0;
+
+  // Edges out of each vertex to higher-ranked vertices (followed by forward
+  // searches), and edges into each vertex from higher-ranked vertices
+  // (followed backward by backward searches), in CSR form.
+  std::vector<std::size_t> up_offsets_, down_offsets_;  // size V + 1
+  std::vector<SearchEdge> up_edges_, down_edges_;
+};
+
+// Repeatedly pop the stack returned by this function to obtain the shortest
+// path from search_root to destination, found with the given contraction
+// hierarchy. Queries run often should reuse a QueryState instead (see
+// ContractionHierarchy::Query).
+std::stack<const Vertex*> shortest_pos_weight_path(
+    const ContractionHierarchy* hierarchy, const Vertex* search_root,
+    const Vertex* destination);
+
+}  // namespace graphlib
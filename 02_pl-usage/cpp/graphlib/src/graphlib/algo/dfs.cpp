@@ -1,109 +1,36 @@
 #include "graphlib/algo/dfs.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <stack>
+#include <utility>
+#include <vector>
 
-namespace graphlib {
-
-// Time intervals can give us valuable information about the structure of the
-// DFS search tree (see Skiena).
-int g_time = 0;
-
-// Allow for early search termination.
-bool g_finished = false;
-
-void dfs_helper(Graph* graph, const Vertex* v1,
-                void (*process_vertex_early)(const Vertex* v),
-                void (*process_edge)(const Vertex* v1, const Vertex* v2,
-                                     double weight),
-                void (*process_vertex_late)(const Vertex* v)) {
-  if (g_finished) return;
-
-  v1->state_ = Vertex::State::DISCOVERED;
-  v1->entry_time_ = ++g_time;
-  if (process_vertex_early) {
-    process_vertex_early(v1);
-  }
-
-  for (auto& adj : graph->GetAdjacentSet(v1)) {
-    const Vertex* v2 = adj.first;
-    double weight = adj.second;
-
-    if (v2->state_ == Vertex::State::UNDISCOVERED) {
-      // Tree edge.
-      v2->parent_ = v1;
-      if (process_edge) {
-        process_edge(v1, v2, weight);
-      }
-      dfs_helper(graph, v2, process_vertex_early, process_edge,
-                 process_vertex_late);
-    } else if ((v2->state_ == Vertex::State::DISCOVERED && v1->parent_ != v2) ||
-               graph->IsDirected()) {
-      // If undirected, we ignore this edge if it's merely the reverse of an
-      // already processed edge. Reverse edges also be thought of as "cycles" of
-      // only two vertices and hold no meaning for undirected graphs. If this is
-      // not a reverse edge, this *must* be a (newly discovered) back edge.
-
-      // If directed, this can be a back, forward, or cross edge.
-
-      if (process_edge) {
-        process_edge(v1, v2, weight);
-      }
-    }
-
-    if (g_finished) return;
-  }
-
-  if (process_vertex_late) {
-    process_vertex_late(v1);
-  }
-  v1->exit_time_ = ++g_time;
-  v1->state_ = Vertex::State::PROCESSED;
-}
-
-void dfs(Graph* graph, const Vertex* search_root,
-         void (*process_vertex_early)(const Vertex* v),
-         void (*process_edge)(const Vertex* v1, const Vertex* v2,
-                              double weight),
-         void (*process_vertex_late)(const Vertex* v)) {
-  g_time = 0;
-  g_finished = false;
-
-  dfs_helper(graph, search_root, process_vertex_early, process_edge,
-             process_vertex_late);
-}
-
-void dfs_graph(Graph* graph, void (*process_vertex_early)(const Vertex* v),
-               void (*process_edge)(const Vertex* v1, const Vertex* v2,
-                                    double weight),
-               void (*process_vertex_late)(const Vertex* v)) {
-  g_time = 0;
-  g_finished = false;
+#include "graphlib/parallel.hpp"
 
-  for (auto& p : graph->GetAdjacencyMap()) {
-    if (p.first->state_ == Vertex::State::UNDISCOVERED) {
-      dfs_helper(graph, p.first, process_vertex_early, process_edge,
-                 process_vertex_late);
-    }
-  }
-}
+namespace graphlib {
 
 // The four basic edge types as seen in Skiena.
 enum class EdgeType { TREE, BACK, FORWARD, CROSS, UNCLASSIFIED };
 
-EdgeType classify_edge(const Vertex* v1, const Vertex* v2) {
+EdgeType classify_edge(const SearchState& state, const Vertex* v1,
+                       const Vertex* v2) {
   // Note that undirected graphs can only have tree or back edges.
-  if (v2->parent_ == v1) return EdgeType::TREE;
-  if (v2->state_ == Vertex::State::DISCOVERED) return EdgeType::BACK;
+  if (state.parent_[v2->id_] == v1->id_) return EdgeType::TREE;
+  if (state.state_[v2->id_] == VertexState::DISCOVERED) return EdgeType::BACK;
 
   // Additional possible edge types for directed graphs.
-  if (v2->state_ == Vertex::State::PROCESSED &&
-      v2->entry_time_ > v1->entry_time_) {
+  if (state.state_[v2->id_] == VertexState::PROCESSED &&
+      state.entry_time_[v2->id_] > state.entry_time_[v1->id_]) {
     return EdgeType::FORWARD;
   }
-  if (v2->state_ == Vertex::State::PROCESSED &&
-      v2->entry_time_ < v1->entry_time_) {
+  if (state.state_[v2->id_] == VertexState::PROCESSED &&
+      state.entry_time_[v2->id_] < state.entry_time_[v1->id_]) {
     return EdgeType::CROSS;
   }
 
@@ -112,76 +39,582 @@ EdgeType classify_edge(const Vertex* v1, const Vertex* v2) {
   return EdgeType::UNCLASSIFIED;
 }
 
-bool g_cyclic = false;
+bool is_cyclic(const Graph* graph) {
+  SearchState state(graph->NumVertices());
 
-bool is_cyclic(Graph* graph) {
-  g_cyclic = false;
+  bool cyclic = false;
+  dfs_graph(graph, &state, nullptr,
+            [&](const Vertex* v1, const Vertex* v2, double weight) {
+              if (state.state_[v2->id_] == VertexState::DISCOVERED &&
+                  state.parent_[v1->id_] != v2->id_) {
+                // Found back edge, forming a cycle.
+                cyclic = true;
+              }
+              return !cyclic;
+            });
+  return cyclic;
+}
 
-  for (auto& p : graph->GetAdjacencyMap()) {
-    if (p.first->state_ == Vertex::State::UNDISCOVERED) {
-      dfs(graph, p.first, nullptr,
-          [](const Vertex* v1, const Vertex* v2, double weight) {
-            if (v2->state_ == Vertex::State::DISCOVERED && v1->parent_ != v2) {
-              // Found back edge, forming a cycle.
-              g_cyclic = true;
-              g_finished = true;
-            }
-          });
-    }
-    if (g_cyclic) break;
-  }
+bool is_cyclic(const CompactGraph* graph) {
+  SearchState state(graph->NumVertices());
 
-  return g_cyclic;
+  bool cyclic = false;
+  dfs_graph(graph, &state, nullptr,
+            [&](const Vertex* v1, const Vertex* v2, double weight) {
+              if (state.state_[v2->id_] == VertexState::DISCOVERED &&
+                  state.parent_[v1->id_] != v2->id_) {
+                // Found back edge, forming a cycle.
+                cyclic = true;
+              }
+              return !cyclic;
+            });
+  return cyclic;
 }
 
-std::stack<const Vertex*> g_topo_stack;
-
-std::stack<const Vertex*>& topological_sort(Graph* graph) {
+std::stack<const Vertex*> topological_sort(const Graph* graph) {
   if (!graph->IsDirected()) {
     std::cerr << "Warning: tried to perform topological sort on a non-DAG!\n\n";
   }
 
-  while (!g_topo_stack.empty()) {
-    g_topo_stack.pop();
+  SearchState state(graph->NumVertices());
+  std::stack<const Vertex*> topo_stack;
+  dfs_graph(graph, &state, nullptr,
+            [&](const Vertex* v1, const Vertex* v2, double weight) {
+              if (classify_edge(state, v1, v2) == EdgeType::BACK) {
+                std::cerr << "Warning: tried to perform topological sort on a "
+                             "non-DAG!\n\n";
+              }
+            },
+            [&](const Vertex* v) { topo_stack.push(v); });
+  return topo_stack;
+}
+
+std::stack<const Vertex*> topological_sort(const CompactGraph* graph) {
+  if (!graph->IsDirected()) {
+    std::cerr << "Warning: tried to perform topological sort on a non-DAG!\n\n";
   }
 
-  dfs_graph(graph, nullptr,
-            [](const Vertex* v1, const Vertex* v2, double weight) {
-              if (classify_edge(v1, v2) == EdgeType::BACK) {
+  SearchState state(graph->NumVertices());
+  std::stack<const Vertex*> topo_stack;
+  dfs_graph(graph, &state, nullptr,
+            [&](const Vertex* v1, const Vertex* v2, double weight) {
+              if (state.state_[v2->id_] == VertexState::DISCOVERED) {
                 std::cerr << "Warning: tried to perform topological sort on a "
                              "non-DAG!\n\n";
               }
             },
-            [](const Vertex* v) { g_topo_stack.push(v); });
+            [&](const Vertex* v) { topo_stack.push(v); });
+  return topo_stack;
+}
+
+// Tarjan's algorithm finds the strongly connected components in a single DFS.
+// Every vertex gets a discovery index, and a "low-link": the smallest index
+// reachable from its DFS subtree through at most one back (or cross) edge to a
+// vertex whose component isn't complete yet. A vertex whose low-link is its own
+// index is the root (first discovered vertex) of a component, and that
+// component is made up of the vertices discovered after it that are still on
+// the Tarjan stack when it's finished.
+//
+// Each frame keeps its vertex's index, so only the low-links need an array.
+// For a back or cross edge to v2, low[v2] is used in place of v2's index. This
+// can give smaller low-links, but never smaller than the index of the root of
+// the component of v2, which (since that component isn't complete) is on the
+// DFS stack, so components are found exactly as with indices.
+//
+// Components are completed in reverse topological order of the condensation
+// (a component is completed only after every component it has an edge into),
+// so numbering them backwards yields a topological order.
+const int kUnvisited = -1;
+
+// Turns the completion order of each vertex's component into component ids
+// numbered in topological order.
+void number_components_topologically(StrongComponents* components) {
+  for (int& id : components->component_id_) {
+    id = components->num_components_ - 1 - id;
+  }
+}
+
+StrongComponents strong_component_ids(const Graph* graph) {
+  const std::size_t num_vertices = graph->NumVertices();
+  StrongComponents components;
+  components.component_id_.assign(num_vertices, kUnvisited);
+  components.num_components_ = 0;
+  std::vector<int> low(num_vertices, kUnvisited);
+  std::vector<VertexId> tarjan_stack;
+  int next_index = 0;
+
+  using AdjacentIterator =
+      decltype(graph->GetAdjacentSet(graph->GetVertexPtr(0)).begin());
+  struct Frame {
+    Frame(const Vertex* v, int index, AdjacentIterator next_edge,
+          AdjacentIterator end)
+        : v(v), index(index), next_edge(next_edge), end(end) {}
+    const Vertex* v;
+    int index;
+    AdjacentIterator next_edge, end;
+  };
+  std::vector<Frame> stack;
+  auto discover = [&](const Vertex* v) {
+    low[v->id_] = next_index;
+    tarjan_stack.push_back(v->id_);
+    const auto& adjacent_set = graph->GetAdjacentSet(v);
+    stack.emplace_back(v, next_index++, adjacent_set.begin(),
+                       adjacent_set.end());
+  };
 
-  return g_topo_stack;
+  for (auto& p : graph->GetAdjacencyMap()) {
+    if (low[p.first->id_] != kUnvisited) continue;
+    discover(p.first);
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+      const VertexId v1 = frame.v->id_;
+      bool descended = false;
+      while (frame.next_edge != frame.end) {
+        const VertexId v2 = frame.next_edge->first->id_;
+        if (low[v2] == kUnvisited) {
+          discover(frame.next_edge++->first);  // invalidates frame
+          descended = true;
+          break;
+        }
+        if (components.component_id_[v2] == kUnvisited) {
+          low[v1] = std::min(low[v1], low[v2]);
+        }
+        ++frame.next_edge;
+      }
+      if (descended) continue;
+
+      const int index = frame.index;
+      stack.pop_back();
+      if (low[v1] == index) {
+        VertexId v;
+        do {
+          v = tarjan_stack.back();
+          tarjan_stack.pop_back();
+          components.component_id_[v] = components.num_components_;
+        } while (v != v1);
+        ++components.num_components_;
+      }
+      if (!stack.empty()) {
+        const VertexId parent = stack.back().v->id_;
+        low[parent] = std::min(low[parent], low[v1]);
+      }
+    }
+  }
+
+  number_components_topologically(&components);
+  return components;
+}
+
+// Tarjan's algorithm, as above, over the vertices of a CompactGraph for which
+// is_active(v) holds (edges to other vertices are ignored). Calls
+// add_to_component(v, root) for each vertex v of each component, where root is
+// the vertex first discovered in the component and is added last. Once a
+// vertex's component is complete its low-link is set to kCompleted, which
+// leaves the low-links of vertices with edges into it unchanged.
+const int kCompleted = std::numeric_limits<int>::max();
+
+template <typename IsActive, typename AddToComponent>
+void tarjan_helper(const CompactGraph* graph, IsActive is_active,
+                   AddToComponent add_to_component) {
+  const VertexId num_vertices = graph->NumVertices();
+  std::vector<int> low(num_vertices, kUnvisited);
+  std::vector<VertexId> tarjan_stack;
+  int next_index = 0;
+
+  struct Frame {
+    Frame(VertexId v, int index, std::size_t next_edge, std::size_t end)
+        : v(v), index(index), next_edge(next_edge), end(end) {}
+    VertexId v;
+    int index;
+    std::size_t next_edge, end;
+  };
+  std::vector<Frame> stack;
+  auto discover = [&](VertexId v) {
+    low[v] = next_index;
+    tarjan_stack.push_back(v);
+    stack.emplace_back(v, next_index++, graph->EdgeBegin(v),
+                       graph->EdgeEnd(v));
+  };
+
+  for (VertexId root = 0; root != num_vertices; ++root) {
+    if (low[root] != kUnvisited || !is_active(root)) continue;
+    discover(root);
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+      const VertexId v1 = frame.v;
+      bool descended = false;
+      while (frame.next_edge != frame.end) {
+        const VertexId v2 = graph->GetTarget(frame.next_edge++);
+        if (low[v2] == kUnvisited) {
+          if (!is_active(v2)) continue;
+          discover(v2);  // invalidates frame
+          descended = true;
+          break;
+        }
+        low[v1] = std::min(low[v1], low[v2]);
+      }
+      if (descended) continue;
+
+      const int index = frame.index;
+      stack.pop_back();
+      if (low[v1] == index) {
+        VertexId v;
+        do {
+          v = tarjan_stack.back();
+          tarjan_stack.pop_back();
+          low[v] = kCompleted;
+          add_to_component(v, v1);
+        } while (v != v1);
+      }
+      if (!stack.empty()) {
+        const VertexId parent = stack.back().v;
+        low[parent] = std::min(low[parent], low[v1]);
+      }
+    }
+  }
+}
+
+StrongComponents strong_component_ids(const CompactGraph* graph) {
+  StrongComponents components;
+  components.component_id_.assign(graph->NumVertices(), kUnvisited);
+  components.num_components_ = 0;
+  tarjan_helper(
+      graph, [](VertexId v) { return true; },
+      [&](VertexId v, VertexId root) {
+        components.component_id_[v] = components.num_components_;
+        if (v == root) ++components.num_components_;
+      });
+  number_components_topologically(&components);
+  return components;
 }
 
-std::stack<Vertex> g_kosaraju_stack;
-std::vector<const Vertex*> g_strong_component;
+// Lists the vertices of each component, in order of VertexId.
+std::vector<std::vector<const Vertex*>> group_by_component(
+    const StrongComponents& components,
+    const std::vector<const Vertex*>& vertices) {
+  std::vector<std::vector<const Vertex*>> grouped(components.num_components_);
+  for (std::size_t v = 0; v != vertices.size(); ++v) {
+    grouped[components.component_id_[v]].push_back(vertices[v]);
+  }
+  return grouped;
+}
 
-// Kosaraju's algorithm.
-std::vector<std::vector<const Vertex*>> strong_components(Graph* graph) {
-  std::vector<std::vector<const Vertex*>> components;
+std::vector<std::vector<const Vertex*>> strong_components(const Graph* graph) {
+  std::vector<const Vertex*> vertices(graph->NumVertices());
+  for (VertexId v = 0; v != static_cast<VertexId>(vertices.size()); ++v) {
+    vertices[v] = graph->GetVertexPtr(v);
+  }
+  return group_by_component(strong_component_ids(graph), vertices);
+}
 
-  std::unique_ptr<Graph> reverse = graph->GetReverseGraph();
-  dfs_graph(reverse.get(), nullptr, nullptr,
-            [](const Vertex* v) { g_kosaraju_stack.push(*v); });
+std::vector<std::vector<const Vertex*>> strong_components(
+    const CompactGraph* graph) {
+  std::vector<const Vertex*> vertices(graph->NumVertices());
+  for (VertexId v = 0; v != static_cast<VertexId>(vertices.size()); ++v) {
+    vertices[v] = graph->GetVertexPtr(v);
+  }
+  return group_by_component(strong_component_ids(graph), vertices);
+}
 
-  while (!g_kosaraju_stack.empty()) {
-    const Vertex* v = graph->GetVertexPtr(g_kosaraju_stack.top());
-    g_kosaraju_stack.pop();
-    if (v->state_ == Vertex::State::UNDISCOVERED) {
-      dfs_helper(graph, v,
-                 [](const Vertex* v) { g_strong_component.push_back(v); },
-                 nullptr, nullptr);
+// Smallest number of vertices worth handing to a thread in the parallel phases,
+// and the number of vertices left below which the remaining components are
+// found with Tarjan's algorithm instead (each parallel round has overhead that
+// only pays off on many vertices).
+const std::size_t kSccMinChunkSize = 1024;
+const std::size_t kSccSerialCutoff = 1 << 14;
+
+// Expands a frontier level by level on num_threads threads until it's empty.
+// expand(v, next) is called once per frontier vertex v, and pushes the vertices
+// it claims for the next level onto next (a per-thread list).
+template <typename Expand>
+void scc_expand_levels(std::vector<VertexId> frontier, unsigned num_threads,
+                       Expand expand) {
+  std::vector<std::vector<VertexId>> nexts(num_threads);
+  while (!frontier.empty()) {
+    parallel_for(0, frontier.size(), num_threads, kSccMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned thread) {
+                   for (std::size_t i = begin; i != end; ++i) {
+                     expand(frontier[i], nexts[thread]);
+                   }
+                 });
+    frontier.clear();
+    for (std::vector<VertexId>& next : nexts) {
+      frontier.insert(frontier.end(), next.begin(), next.end());
+      next.clear();
     }
-    if (!g_strong_component.empty()) {
-      components.push_back(g_strong_component);
+  }
+}
+
+// The vertices in [0, num_vertices) for which predicate(v) holds, in order.
+template <typename Predicate>
+std::vector<VertexId> scc_filter_vertices(std::size_t num_vertices,
+                                          unsigned num_threads,
+                                          Predicate predicate) {
+  std::vector<std::vector<VertexId>> chunks(num_threads);
+  parallel_for(0, num_vertices, num_threads, kSccMinChunkSize,
+               [&](std::size_t begin, std::size_t end, unsigned thread) {
+                 for (std::size_t v = begin; v != end; ++v) {
+                   if (predicate(v)) chunks[thread].push_back(v);
+                 }
+               });
+  std::vector<VertexId> vertices;
+  for (const std::vector<VertexId>& chunk : chunks) {
+    vertices.insert(vertices.end(), chunk.begin(), chunk.end());
+  }
+  return vertices;
+}
+
+double scc_seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+StrongComponents parallel_strong_component_ids(
+    const CompactGraph* graph, unsigned num_threads,
+    const CompactGraph* reverse_graph, SccPhaseTimings* timings) {
+  using Clock = std::chrono::steady_clock;
+  const std::size_t num_vertices = graph->NumVertices();
+  if (num_threads == 0) num_threads = default_num_threads();
+  SccPhaseTimings phase_timings;
+  Clock::time_point phase_start = Clock::now();
+
+  // Incoming edges are needed for trimming and for backward searches.
+  std::unique_ptr<CompactGraph> built_reverse_graph;
+  const CompactGraph* in_graph = graph;
+  if (graph->IsDirected()) {
+    if (!reverse_graph) {
+      built_reverse_graph =
+          std::make_unique<CompactGraph>(graph->GetReverseGraph());
+      reverse_graph = built_reverse_graph.get();
+    }
+    in_graph = reverse_graph;
+  }
+
+  // A vertex is active until its component is found. It then gets a label: a
+  // vertex of its component, the same for the whole component.
+  std::vector<std::atomic<VertexId>> label(num_vertices);
+  auto is_active = [&](VertexId v) {
+    return label[v].load(std::memory_order_relaxed) == kNoVertex;
+  };
+  auto claim = [&](VertexId v, VertexId component) {
+    VertexId no_label = kNoVertex;
+    return label[v].compare_exchange_strong(no_label, component,
+                                            std::memory_order_relaxed);
+  };
+  parallel_for(0, num_vertices, num_threads, kSccMinChunkSize,
+               [&](std::size_t begin, std::size_t end, unsigned) {
+                 for (std::size_t v = begin; v != end; ++v) {
+                   label[v].store(kNoVertex, std::memory_order_relaxed);
+                 }
+               });
+  phase_timings.setup_seconds_ = scc_seconds_since(phase_start);
+
+  // Trim: a vertex with no incoming or no outgoing edges from other active
+  // vertices is a component on its own. Removing it can leave its neighbors
+  // without any, so the counts of active neighbors are kept up to date and
+  // vertices are removed level by level as their counts hit zero.
+  phase_start = Clock::now();
+  std::vector<std::atomic<int>> num_in(num_vertices), num_out(num_vertices);
+  parallel_for(0, num_vertices, num_threads, kSccMinChunkSize,
+               [&](std::size_t begin, std::size_t end, unsigned) {
+                 for (std::size_t v = begin; v != end; ++v) {
+                   num_in[v].store(in_graph->Degree(v),
+                                   std::memory_order_relaxed);
+                   num_out[v].store(graph->Degree(v),
+                                    std::memory_order_relaxed);
+                 }
+               });
+  std::vector<VertexId> trimmed =
+      scc_filter_vertices(num_vertices, num_threads, [&](VertexId v) {
+        return graph->Degree(v) == 0 || in_graph->Degree(v) == 0;
+      });
+  for (VertexId v : trimmed) label[v].store(v, std::memory_order_relaxed);
+  scc_expand_levels(
+      std::move(trimmed), num_threads,
+      [&](VertexId v, std::vector<VertexId>& next) {
+        for (std::size_t e = graph->EdgeBegin(v); e != graph->EdgeEnd(v);
+             ++e) {
+          VertexId w = graph->GetTarget(e);
+          if (num_in[w].fetch_sub(1, std::memory_order_relaxed) == 1 &&
+              claim(w, w)) {
+            next.push_back(w);
+          }
+        }
+        for (std::size_t e = in_graph->EdgeBegin(v); e != in_graph->EdgeEnd(v);
+             ++e) {
+          VertexId w = in_graph->GetTarget(e);
+          if (num_out[w].fetch_sub(1, std::memory_order_relaxed) == 1 &&
+              claim(w, w)) {
+            next.push_back(w);
+          }
+        }
+      });
+  std::vector<VertexId> active = scc_filter_vertices(
+      num_vertices, num_threads, [&](VertexId v) { return is_active(v); });
+  phase_timings.trim_vertices_ = num_vertices - active.size();
+  phase_timings.trim_seconds_ = scc_seconds_since(phase_start);
+
+  // Forward-backward: the component of a pivot is the set of vertices both
+  // reachable from it and reaching it. Real graphs tend to have one giant
+  // component, which the vertex with the most edges in and out likely lies in.
+  phase_start = Clock::now();
+  if (!active.empty()) {
+    VertexId pivot = active.front();
+    std::size_t best = 0;
+    for (VertexId v : active) {
+      std::size_t score = std::size_t(graph->Degree(v)) * in_graph->Degree(v);
+      if (score > best) {
+        best = score;
+        pivot = v;
+      }
     }
-    g_strong_component.clear();
+
+    // Inactive vertices start out marked as reached both ways, so that the
+    // searches pass them by without having to look up their labels.
+    const std::uint8_t kForward = 1, kBackward = 2;
+    std::vector<std::atomic<std::uint8_t>> reached(num_vertices);
+    parallel_for(0, num_vertices, num_threads, kSccMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t v = begin; v != end; ++v) {
+                     reached[v].store(is_active(v) ? 0 : kForward | kBackward,
+                                      std::memory_order_relaxed);
+                   }
+                 });
+    auto search = [&](const CompactGraph* edges, std::uint8_t direction) {
+      reached[pivot].fetch_or(direction, std::memory_order_relaxed);
+      scc_expand_levels(
+          {pivot}, num_threads, [&](VertexId v, std::vector<VertexId>& next) {
+            for (std::size_t e = edges->EdgeBegin(v); e != edges->EdgeEnd(v);
+                 ++e) {
+              VertexId w = edges->GetTarget(e);
+              if (!(reached[w].load(std::memory_order_relaxed) & direction) &&
+                  !(reached[w].fetch_or(direction, std::memory_order_relaxed) &
+                    direction)) {
+                next.push_back(w);
+              }
+            }
+          });
+    };
+    search(graph, kForward);
+    search(in_graph, kBackward);
+    parallel_for(0, active.size(), num_threads, kSccMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t i = begin; i != end; ++i) {
+                     if (reached[active[i]].load(std::memory_order_relaxed) ==
+                         (kForward | kBackward)) {
+                       label[active[i]].store(pivot,
+                                              std::memory_order_relaxed);
+                     }
+                   }
+                 });
+    const std::size_t num_active = active.size();
+    active = scc_filter_vertices(num_vertices, num_threads,
+                                 [&](VertexId v) { return is_active(v); });
+    phase_timings.forward_backward_vertices_ = num_active - active.size();
+  }
+  phase_timings.forward_backward_seconds_ = scc_seconds_since(phase_start);
+
+  // Coloring: each active vertex takes the largest VertexId among the active
+  // vertices that reach it (propagated forward until nothing changes). A vertex
+  // with its own id as color is reached by no larger vertex, and its component
+  // is the set of vertices of its color that reach it, found by a backward
+  // search restricted to that color. Different colors never share a vertex, so
+  // each search runs on a single thread without synchronization.
+  //
+  // A vertex is queued for the next level when its color is raised, unless it
+  // already is. Its queued flag is cleared (before reading its color) when it's
+  // expanded, so a raise concurrent with the expansion either is seen by it or
+  // queues the vertex again. This needs sequentially consistent ordering.
+  phase_start = Clock::now();
+  std::vector<std::atomic<VertexId>> color(num_vertices);
+  std::vector<std::atomic<bool>> queued(num_vertices);
+  while (active.size() > kSccSerialCutoff) {
+    parallel_for(0, active.size(), num_threads, kSccMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t i = begin; i != end; ++i) {
+                     color[active[i]].store(active[i],
+                                            std::memory_order_relaxed);
+                     queued[active[i]].store(true, std::memory_order_relaxed);
+                   }
+                 });
+    scc_expand_levels(
+        active, num_threads, [&](VertexId v, std::vector<VertexId>& next) {
+          queued[v].store(false);
+          const VertexId c = color[v].load();
+          for (std::size_t e = graph->EdgeBegin(v); e != graph->EdgeEnd(v);
+               ++e) {
+            VertexId w = graph->GetTarget(e);
+            if (!is_active(w)) continue;
+            VertexId old_color = color[w].load(std::memory_order_relaxed);
+            while (old_color < c &&
+                   !color[w].compare_exchange_weak(old_color, c)) {
+            }
+            if (old_color < c && !queued[w].exchange(true)) {
+              next.push_back(w);
+            }
+          }
+        });
+
+    std::vector<VertexId> roots =
+        scc_filter_vertices(num_vertices, num_threads, [&](VertexId v) {
+          return is_active(v) && color[v].load(std::memory_order_relaxed) == v;
+        });
+    std::vector<std::size_t> found(num_threads, 0);
+    parallel_for(
+        0, roots.size(), num_threads, 1,
+        [&](std::size_t begin, std::size_t end, unsigned thread) {
+          std::vector<VertexId> q;
+          for (std::size_t i = begin; i != end; ++i) {
+            const VertexId root = roots[i];
+            label[root].store(root, std::memory_order_relaxed);
+            q.assign(1, root);
+            for (std::size_t head = 0; head != q.size(); ++head) {
+              VertexId v = q[head];
+              for (std::size_t e = in_graph->EdgeBegin(v);
+                   e != in_graph->EdgeEnd(v); ++e) {
+                VertexId w = in_graph->GetTarget(e);
+                if (is_active(w) &&
+                    color[w].load(std::memory_order_relaxed) == root) {
+                  label[w].store(root, std::memory_order_relaxed);
+                  q.push_back(w);
+                }
+              }
+            }
+            found[thread] += q.size();
+          }
+        });
+    for (std::size_t n : found) phase_timings.coloring_vertices_ += n;
+    active = scc_filter_vertices(num_vertices, num_threads,
+                                 [&](VertexId v) { return is_active(v); });
+  }
+  phase_timings.coloring_seconds_ = scc_seconds_since(phase_start);
+
+  // Whatever is left is found serially.
+  phase_start = Clock::now();
+  phase_timings.serial_vertices_ = active.size();
+  if (!active.empty()) {
+    tarjan_helper(graph, is_active, [&](VertexId v, VertexId root) {
+      label[v].store(root, std::memory_order_relaxed);
+    });
+  }
+  phase_timings.serial_seconds_ = scc_seconds_since(phase_start);
+
+  // Number the components in order of their smallest VertexId, so that the
+  // result doesn't depend on how components were found.
+  phase_start = Clock::now();
+  StrongComponents components;
+  components.component_id_.assign(num_vertices, kUnvisited);
+  components.num_components_ = 0;
+  std::vector<int> label_id(num_vertices, kUnvisited);
+  for (std::size_t v = 0; v != num_vertices; ++v) {
+    int& id = label_id[label[v].load(std::memory_order_relaxed)];
+    if (id == kUnvisited) id = components.num_components_++;
+    components.component_id_[v] = id;
   }
+  phase_timings.numbering_seconds_ = scc_seconds_since(phase_start);
 
+  if (timings) *timings = phase_timings;
   return components;
 }
 
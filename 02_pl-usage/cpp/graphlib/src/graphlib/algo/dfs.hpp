@@ -1,43 +1,303 @@
-// The current DFS implementation (see dfs.cpp) is recursive with several global
-// variables storing the information of interest. That is why several of the
-// functions here return by reference.
+// The DFS implementation is iterative, with an explicit stack, so search depth
+// is only limited by memory. Like BFS, it takes its callbacks as template
+// parameters (see callbacks.hpp), so the algorithms built on it keep their
+// state in local variables and can be run concurrently.
 
 #pragma once
 
 #include "graphlib/algo/bfs.hpp"
+#include "graphlib/algo/callbacks.hpp"
+#include "graphlib/compact_graph.hpp"
 #include "graphlib/graph.hpp"
+#include "graphlib/search_state.hpp"
 
+#include <cstddef>
 #include <stack>
+#include <vector>
 
 namespace graphlib {
 
-// Traditional DFS algorithm. Results in a complete DFS search tree encoded in
-// the parent members of each Vertex.
-void dfs(Graph* graph, const Vertex* search_root,
-         void (*process_vertex_early)(const Vertex* v) = nullptr,
-         void (*process_edge)(const Vertex* v1, const Vertex* v2,
-                              double weight) = nullptr,
-         void (*process_vertex_late)(const Vertex* v) = nullptr);
+// DFS from root, which must be undiscovered. Returns false if a callback
+// terminated the search.
+//
+// Time intervals can give us valuable information about the structure of the
+// DFS search tree (see Skiena). These are kept in the SearchState.
+//
+// Rather than recursing once per tree edge (which overflows the call stack on
+// deep graphs, e.g. long paths), the search keeps an explicit stack of frames,
+// each holding a vertex and the position of the next edge to look at in its
+// adjacent set. Callbacks are made at exactly the same points as in a recursive
+// DFS:
+//
+//   dfs(v1):
+//     discover v1 (entry time, process_vertex_early)
+//     for each edge (v1, v2):
+//       if v2 is undiscovered: set parent, process_edge, dfs(v2)
+//       else if not a reverse tree edge (or directed): process_edge
+//     process_vertex_late, exit time
+template <typename ProcessVertexEarly, typename ProcessEdge,
+          typename ProcessVertexLate>
+bool dfs_helper(const Graph* graph, const Vertex* root, SearchState* state,
+                ProcessVertexEarly& process_vertex_early,
+                ProcessEdge& process_edge,
+                ProcessVertexLate& process_vertex_late) {
+  using AdjacentIterator = decltype(graph->GetAdjacentSet(root).begin());
+  // Frames are constructed in place (see emplace_back below): building one in a
+  // temporary and copying it onto the stack stalls on store forwarding.
+  struct Frame {
+    Frame(const Vertex* v, AdjacentIterator next_edge, AdjacentIterator end)
+        : v(v), next_edge(next_edge), end(end) {}
+    const Vertex* v;
+    AdjacentIterator next_edge, end;
+  };
+  std::vector<Frame> stack;
+  auto discover = [&](const Vertex* v) {
+    state->state_[v->id_] = VertexState::DISCOVERED;
+    state->entry_time_[v->id_] = ++state->time_;
+    const auto& adjacent_set = graph->GetAdjacentSet(v);
+    stack.emplace_back(v, adjacent_set.begin(), adjacent_set.end());
+    return invoke_callback(process_vertex_early, v);
+  };
+
+  if (!discover(root)) return false;
+  while (!stack.empty()) {
+    // Scan the edges of the vertex on top of the stack until a tree edge is
+    // found (then descend) or there are no edges left (then finish the vertex).
+    Frame& frame = stack.back();
+    const Vertex* v1 = frame.v;
+    bool descended = false;
+    while (frame.next_edge != frame.end) {
+      const Vertex* v2 = frame.next_edge->first;
+      double weight = frame.next_edge->second;
+      ++frame.next_edge;
+
+      if (state->state_[v2->id_] == VertexState::UNDISCOVERED) {
+        // Tree edge.
+        state->parent_[v2->id_] = v1->id_;
+        if (!invoke_callback(process_edge, v1, v2, weight)) return false;
+        if (!discover(v2)) return false;  // invalidates frame
+        descended = true;
+        break;
+      } else if ((state->state_[v2->id_] == VertexState::DISCOVERED &&
+                  state->parent_[v1->id_] != v2->id_) ||
+                 graph->IsDirected()) {
+        // If undirected, we ignore this edge if it's merely the reverse of an
+        // already processed edge. Reverse edges also be thought of as "cycles"
+        // of only two vertices and hold no meaning for undirected graphs. If
+        // this is not a reverse edge, this *must* be a (newly discovered) back
+        // edge.
+
+        // If directed, this can be a back, forward, or cross edge.
+
+        if (!invoke_callback(process_edge, v1, v2, weight)) return false;
+      }
+    }
+    if (descended) continue;
+
+    if (!invoke_callback(process_vertex_late, v1)) return false;
+    state->exit_time_[v1->id_] = ++state->time_;
+    state->state_[v1->id_] = VertexState::PROCESSED;
+    stack.pop_back();
+  }
+  return true;
+}
+
+// Traditional DFS algorithm. Results in a complete DFS search tree (including
+// DFS time intervals) encoded in the given SearchState.
+//
+// The callbacks are called as process_vertex_early(v), process_edge(v1, v2,
+// weight), and process_vertex_late(v), with const Vertex* arguments. See
+// callbacks.hpp for what may be passed.
+template <typename ProcessVertexEarly = std::nullptr_t,
+          typename ProcessEdge = std::nullptr_t,
+          typename ProcessVertexLate = std::nullptr_t>
+void dfs(const Graph* graph, const Vertex* search_root, SearchState* state,
+         ProcessVertexEarly process_vertex_early = nullptr,
+         ProcessEdge process_edge = nullptr,
+         ProcessVertexLate process_vertex_late = nullptr) {
+  dfs_helper(graph, graph->GetVertexPtr(*search_root), state,
+             process_vertex_early, process_edge, process_vertex_late);
+}
 
 // DFS that traverses entire Graph (possibly disconnected, so no specified
 // search root).
-void dfs_graph(Graph* graph,
-               void (*process_vertex_early)(const Vertex* v) = nullptr,
-               void (*process_edge)(const Vertex* v1, const Vertex* v2,
-                                    double weight) = nullptr,
-               void (*process_vertex_late)(const Vertex* v) = nullptr);
+template <typename ProcessVertexEarly = std::nullptr_t,
+          typename ProcessEdge = std::nullptr_t,
+          typename ProcessVertexLate = std::nullptr_t>
+void dfs_graph(const Graph* graph, SearchState* state,
+               ProcessVertexEarly process_vertex_early = nullptr,
+               ProcessEdge process_edge = nullptr,
+               ProcessVertexLate process_vertex_late = nullptr) {
+  for (auto& p : graph->GetAdjacencyMap()) {
+    if (state->state_[p.first->id_] == VertexState::UNDISCOVERED &&
+        !dfs_helper(graph, p.first, state, process_vertex_early, process_edge,
+                    process_vertex_late)) {
+      return;
+    }
+  }
+}
 
-bool is_cyclic(Graph* graph);
+bool is_cyclic(const Graph* graph);
 
 // Repeatedly pop the stack returned by this function to obtain topological
 // sort of a DAG. Useful for scheduling problems and optimizations of other
 // algorithms on DAGs.
-std::stack<const Vertex*>& topological_sort(Graph* graph);
+std::stack<const Vertex*> topological_sort(const Graph* graph);
+
+// Result of strong_component_ids: the strongly connected component of each
+// Vertex, indexed by VertexId, with components numbered from 0.
+struct StrongComponents {
+  std::vector<int> component_id_;
+  int num_components_;
+};
 
 // For directed graphs, a strongly connected component is one where every Vertex
 // can reach every other Vertex and vice versa. Strongly connected components
 // highlight significant groupings in a network of relationships.
-std::vector<std::vector<const Vertex*>> strong_components(Graph* graph);
+//
+// Uses Tarjan's algorithm: a single iterative DFS over the graph itself (no
+// reversed copy), with O(V) extra memory. Components are numbered in a
+// topological order of the condensation (the DAG of components), i.e. every
+// edge between two components goes from a lower id to a higher one.
+StrongComponents strong_component_ids(const Graph* graph);
+
+// The strongly connected components listed as groups of vertices, in order of
+// component id (see above). Within a component, vertices are in order of
+// VertexId.
+std::vector<std::vector<const Vertex*>> strong_components(
+    const Graph* graph);
+
+// CompactGraph overloads of the above. See the Graph overload of dfs_helper.
+template <typename ProcessVertexEarly, typename ProcessEdge,
+          typename ProcessVertexLate>
+bool dfs_helper(const CompactGraph* graph, VertexId root, SearchState* state,
+                ProcessVertexEarly& process_vertex_early,
+                ProcessEdge& process_edge,
+                ProcessVertexLate& process_vertex_late) {
+  struct Frame {
+    Frame(VertexId v, std::size_t next_edge, std::size_t end)
+        : v(v), next_edge(next_edge), end(end) {}
+    VertexId v;
+    std::size_t next_edge, end;
+  };
+  std::vector<Frame> stack;
+  auto discover = [&](VertexId v) {
+    state->state_[v] = VertexState::DISCOVERED;
+    state->entry_time_[v] = ++state->time_;
+    stack.emplace_back(v, graph->EdgeBegin(v), graph->EdgeEnd(v));
+    return invoke_callback(process_vertex_early, graph->GetVertexPtr(v));
+  };
+
+  if (!discover(root)) return false;
+  while (!stack.empty()) {
+    Frame& frame = stack.back();
+    const VertexId v1 = frame.v;
+    bool descended = false;
+    while (frame.next_edge != frame.end) {
+      std::size_t e = frame.next_edge++;
+      VertexId v2 = graph->GetTarget(e);
+
+      if (state->state_[v2] == VertexState::UNDISCOVERED) {
+        state->parent_[v2] = v1;
+        if (!invoke_callback(process_edge, graph->GetVertexPtr(v1),
+                             graph->GetVertexPtr(v2), graph->GetWeight(e))) {
+          return false;
+        }
+        if (!discover(v2)) return false;  // invalidates frame
+        descended = true;
+        break;
+      } else if ((state->state_[v2] == VertexState::DISCOVERED &&
+                  state->parent_[v1] != v2) ||
+                 graph->IsDirected()) {
+        if (!invoke_callback(process_edge, graph->GetVertexPtr(v1),
+                             graph->GetVertexPtr(v2), graph->GetWeight(e))) {
+          return false;
+        }
+      }
+    }
+    if (descended) continue;
+
+    if (!invoke_callback(process_vertex_late, graph->GetVertexPtr(v1))) {
+      return false;
+    }
+    state->exit_time_[v1] = ++state->time_;
+    state->state_[v1] = VertexState::PROCESSED;
+    stack.pop_back();
+  }
+  return true;
+}
+
+template <typename ProcessVertexEarly = std::nullptr_t,
+          typename ProcessEdge = std::nullptr_t,
+          typename ProcessVertexLate = std::nullptr_t>
+void dfs(const CompactGraph* graph, const Vertex* search_root,
+         SearchState* state, ProcessVertexEarly process_vertex_early = nullptr,
+         ProcessEdge process_edge = nullptr,
+         ProcessVertexLate process_vertex_late = nullptr) {
+  dfs_helper(graph, graph->GetVertexId(search_root), state,
+             process_vertex_early, process_edge, process_vertex_late);
+}
+
+template <typename ProcessVertexEarly = std::nullptr_t,
+          typename ProcessEdge = std::nullptr_t,
+          typename ProcessVertexLate = std::nullptr_t>
+void dfs_graph(const CompactGraph* graph, SearchState* state,
+               ProcessVertexEarly process_vertex_early = nullptr,
+               ProcessEdge process_edge = nullptr,
+               ProcessVertexLate process_vertex_late = nullptr) {
+  for (VertexId v = 0; v != static_cast<VertexId>(graph->NumVertices()); ++v) {
+    if (state->state_[v] == VertexState::UNDISCOVERED &&
+        !dfs_helper(graph, v, state, process_vertex_early, process_edge,
+                    process_vertex_late)) {
+      return;
+    }
+  }
+}
+
+bool is_cyclic(const CompactGraph* graph);
+std::stack<const Vertex*> topological_sort(const CompactGraph* graph);
+StrongComponents strong_component_ids(const CompactGraph* graph);
+std::vector<std::vector<const Vertex*>> strong_components(
+    const CompactGraph* graph);
+
+// Where parallel_strong_component_ids spent its time, phase by phase: the
+// wall-clock seconds taken, and the number of vertices whose component was
+// found.
+struct SccPhaseTimings {
+  double setup_seconds_ = 0;  // building the reverse graph, if not given
+  double trim_seconds_ = 0;
+  double forward_backward_seconds_ = 0;
+  double coloring_seconds_ = 0;
+  double serial_seconds_ = 0;
+  double numbering_seconds_ = 0;
+  std::size_t trim_vertices_ = 0;
+  std::size_t forward_backward_vertices_ = 0;
+  std::size_t coloring_vertices_ = 0;
+  std::size_t serial_vertices_ = 0;
+};
+
+// Multithreaded strongly connected components, for large graphs. Finds the
+// same components as strong_component_ids, in phases (as in Slota et al.'s
+// "Multistep" method):
+//   - Trim: vertices without incoming or outgoing edges (repeatedly, as
+//     others are removed) are components on their own.
+//   - Forward-backward: the component of a well-connected pivot (likely the
+//     giant component) is the intersection of the vertices it reaches and the
+//     vertices reaching it, both found by parallel BFS.
+//   - Coloring: the largest VertexId reaching each vertex is propagated in
+//     parallel, which splits the rest into independent subproblems.
+//   - Once few vertices are left, Tarjan's algorithm finishes serially.
+//
+// Components are numbered in order of their smallest VertexId (not
+// topologically), so the result doesn't depend on the number of threads.
+// Backward searches follow incoming edges; for a directed graph, pass its
+// reverse if it's already at hand, otherwise one is built. Uses num_threads
+// threads, or one per hardware thread if 0. If timings isn't null, the time
+// spent in each phase is stored there.
+StrongComponents parallel_strong_component_ids(
+    const CompactGraph* graph, unsigned num_threads = 0,
+    const CompactGraph* reverse_graph = nullptr,
+    SccPhaseTimings* timings = nullptr);
 
 // Forward declarations for functions common to BFS.
 void print_vertex(const Vertex* v);
@@ -0,0 +1,335 @@
+#include "graphlib/algo/landmarks.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include "graphlib/algo/weighted_paths.hpp"
+#include "graphlib/search_state.hpp"
+
+namespace graphlib {
+
+const char kLandmarkFileMagic[8] = {'L', 'A', 'N', 'D', 'M', 'A', 'R', 'K'};
+const std::uint32_t kLandmarkFileVersion = 1;
+
+// Written in native byte order, so reads back differently on a host with the
+// other byte order.
+const std::uint32_t kLandmarkFileByteOrder = 0x01020304;
+
+// Header flags.
+const std::uint32_t kLandmarkFileDirected = 1 << 0;
+
+struct LandmarkFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t flags;
+  std::uint32_t reserved;
+  std::uint64_t num_vertices;
+  std::uint64_t num_landmarks;
+  std::uint64_t graph_checksum;
+};
+
+// FNV-1a hash of the graph's CSR arrays, so that landmarks aren't loaded for a
+// graph with different edges or weights than the one they were computed for.
+std::uint64_t landmark_graph_checksum(const CompactGraph& graph) {
+  std::uint64_t hash = 14695981039346656037ull;
+  auto add = [&hash](const void* data, std::size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i != size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+  };
+  const std::uint64_t is_directed = graph.IsDirected();
+  add(&is_directed, sizeof(is_directed));
+  add(graph.GetOffsets().data(),
+      sizeof(std::size_t) * (graph.NumVertices() + 1));
+  add(graph.GetTargets().data(), sizeof(VertexId) * graph.NumEdges());
+  add(graph.GetWeights().data(), sizeof(double) * graph.NumEdges());
+  return hash;
+}
+
+// Lower bound on the distance from v1 to v2, given the rows of v1 and v2 in
+// the tables of distances from and to k landmarks. Differences between
+// infinite distances (for vertices a landmark can't reach, or be reached from)
+// give no bound.
+double landmark_lower_bound(const double* from_v1, const double* from_v2,
+                            const double* to_v1, const double* to_v2,
+                            std::size_t k) {
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  double bound = 0;
+  for (std::size_t i = 0; i != k; ++i) {
+    const double forward = from_v2[i] - from_v1[i];
+    const double backward = to_v1[i] - to_v2[i];
+    if (forward > bound && forward != kInfinity) bound = forward;
+    if (backward > bound && backward != kInfinity) bound = backward;
+  }
+  return bound;
+}
+
+// The vertex with the largest of the given distances (infinite counting as
+// largest) that isn't a landmark yet, preferring smaller VertexIds.
+VertexId farthest_landmark_candidate(const std::vector<double>& dist,
+                                     const std::vector<bool>& is_landmark) {
+  VertexId farthest = kNoVertex;
+  for (VertexId v = 0; v != static_cast<VertexId>(dist.size()); ++v) {
+    if (!is_landmark[v] &&
+        (farthest == kNoVertex || dist[v] > dist[farthest])) {
+      farthest = v;
+    }
+  }
+  return farthest;
+}
+
+Landmarks::Landmarks(const Graph& graph, std::size_t num_landmarks,
+                     LandmarkSelection selection)
+    : Landmarks(CompactGraph(graph), num_landmarks, selection) {}
+
+Landmarks::Landmarks(const CompactGraph& graph, std::size_t num_landmarks,
+                     LandmarkSelection selection)
+    : num_vertices_(graph.NumVertices()),
+      is_directed_(graph.IsDirected()),
+      graph_checksum_(landmark_graph_checksum(graph)) {
+  for (double weight : graph.GetWeights()) {
+    if (weight < 0) {
+      throw std::runtime_error(
+          "Landmarks::Landmarks error! Negative edge weight.\n");
+    }
+  }
+  const std::size_t k = std::min(num_landmarks, num_vertices_);
+  if (k == 0) return;
+
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  std::unique_ptr<CompactGraph> reverse;
+  if (is_directed_) {
+    reverse = std::make_unique<CompactGraph>(graph.GetReverseGraph());
+    to_.assign(num_vertices_ * k, kInfinity);
+  }
+  from_.assign(num_vertices_ * k, kInfinity);
+  std::vector<bool> is_landmark(num_vertices_, false);
+  SearchState state(num_vertices_);
+
+  // Fills in the distances between a new landmark and every vertex.
+  auto add_landmark = [&](VertexId landmark) {
+    const std::size_t i = landmarks_.size();
+    landmarks_.push_back(landmark);
+    is_landmark[landmark] = true;
+    state.Reset();
+    dijkstra(&graph, graph.GetVertexPtr(landmark), &state);
+    for (std::size_t v = 0; v != num_vertices_; ++v) {
+      from_[v * k + i] = state.dist_to_root_[v];
+    }
+    if (is_directed_) {
+      state.Reset();
+      dijkstra(reverse.get(), graph.GetVertexPtr(landmark), &state);
+      for (std::size_t v = 0; v != num_vertices_; ++v) {
+        to_[v * k + i] = state.dist_to_root_[v];
+      }
+    }
+  };
+  auto lower_bound = [&](VertexId v1, VertexId v2) {
+    const std::vector<double>& to = is_directed_ ? to_ : from_;
+    return landmark_lower_bound(from_.data() + v1 * k, from_.data() + v2 * k,
+                                to.data() + v1 * k, to.data() + v2 * k,
+                                landmarks_.size());
+  };
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<VertexId> vertex_distribution(
+      0, num_vertices_ - 1);
+  if (selection == LandmarkSelection::FARTHEST) {
+    state.Reset();
+    dijkstra(&graph, graph.GetVertexPtr(vertex_distribution(rng)), &state);
+    VertexId next =
+        farthest_landmark_candidate(state.dist_to_root_, is_landmark);
+    std::vector<double> min_dist(num_vertices_, kInfinity);
+    while (true) {
+      add_landmark(next);
+      if (landmarks_.size() == k) break;
+      const std::size_t last = landmarks_.size() - 1;
+      for (std::size_t v = 0; v != num_vertices_; ++v) {
+        min_dist[v] = std::min(min_dist[v], from_[v * k + last]);
+      }
+      next = farthest_landmark_candidate(min_dist, is_landmark);
+    }
+    return;
+  }
+
+  std::vector<VertexId> order;
+  std::vector<double> size(num_vertices_);
+  std::vector<bool> has_landmark(num_vertices_);
+  std::vector<std::size_t> child_offsets(num_vertices_ + 1);
+  std::vector<VertexId> children;
+  while (landmarks_.size() != k) {
+    VertexId root = vertex_distribution(rng);
+    while (is_landmark[root]) root = vertex_distribution(rng);
+    state.Reset();
+    dijkstra(&graph, graph.GetVertexPtr(root), &state);
+    const std::vector<double>& dist = state.dist_to_root_;
+
+    // Children lists of the shortest path tree.
+    std::fill(child_offsets.begin(), child_offsets.end(), 0);
+    for (VertexId v = 0; v != static_cast<VertexId>(num_vertices_); ++v) {
+      if (v != root && dist[v] != kInfinity) {
+        ++child_offsets[state.parent_[v] + 1];
+      }
+    }
+    for (std::size_t v = 0; v != num_vertices_; ++v) {
+      child_offsets[v + 1] += child_offsets[v];
+    }
+    children.resize(child_offsets.back());
+    std::vector<std::size_t> next_child(child_offsets.begin(),
+                                        child_offsets.end() - 1);
+    for (VertexId v = 0; v != static_cast<VertexId>(num_vertices_); ++v) {
+      if (v != root && dist[v] != kInfinity) {
+        children[next_child[state.parent_[v]]++] = v;
+      }
+    }
+
+    // Sizes of the subtrees, from the leaves up. Taking the tree in breadth
+    // first order puts every vertex after its parent, even a child at the same
+    // distance over an edge of weight 0 (which sorting by distance doesn't).
+    order.assign(1, root);
+    for (std::size_t i = 0; i != order.size(); ++i) {
+      const VertexId v = order[i];
+      order.insert(order.end(), children.begin() + child_offsets[v],
+                   children.begin() + child_offsets[v + 1]);
+    }
+    for (VertexId v : order) {
+      size[v] = dist[v] - lower_bound(root, v);
+      has_landmark[v] = is_landmark[v];
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      if (*it == root) continue;
+      const VertexId parent = state.parent_[*it];
+      size[parent] += size[*it];
+      has_landmark[parent] = has_landmark[parent] || has_landmark[*it];
+    }
+
+    // Walk down into the heaviest subtree without a landmark, to a leaf.
+    VertexId v = root;
+    while (true) {
+      VertexId heaviest = kNoVertex;
+      for (std::size_t c = child_offsets[v]; c != child_offsets[v + 1]; ++c) {
+        const VertexId child = children[c];
+        if (!has_landmark[child] &&
+            (heaviest == kNoVertex || size[child] > size[heaviest])) {
+          heaviest = child;
+        }
+      }
+      if (heaviest == kNoVertex) break;
+      v = heaviest;
+    }
+    add_landmark(v);
+  }
+}
+
+Landmarks::Landmarks(const std::string& path, const Graph& graph)
+    : Landmarks(path, CompactGraph(graph)) {}
+
+Landmarks::Landmarks(const std::string& path, const CompactGraph& graph) {
+  auto fail = [&path](const std::string& reason) {
+    throw std::runtime_error("Landmarks::Landmarks error! " + reason + " (" +
+                             path + ")\n");
+  };
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) fail("Could not open file");
+  const std::uint64_t file_size = in.tellg();
+  in.seekg(0);
+
+  LandmarkFileHeader header;
+  if (file_size < sizeof(header) ||
+      !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, kLandmarkFileMagic, sizeof(header.magic)) !=
+          0) {
+    fail("Not a landmark file");
+  }
+  if (header.byte_order != kLandmarkFileByteOrder) {
+    fail("Landmark file was written with a different byte order");
+  }
+  if (header.version != kLandmarkFileVersion) {
+    fail("Unsupported landmark file version " +
+         std::to_string(header.version));
+  }
+  num_vertices_ = header.num_vertices;
+  is_directed_ = header.flags & kLandmarkFileDirected;
+  graph_checksum_ = header.graph_checksum;
+  if (num_vertices_ != graph.NumVertices() ||
+      is_directed_ != graph.IsDirected() ||
+      graph_checksum_ != landmark_graph_checksum(graph)) {
+    fail("Landmark file was written for a different graph");
+  }
+  // Bound the table size by the file size first, so the sizes below can't
+  // overflow.
+  const std::uint64_t k = header.num_landmarks;
+  if (k > num_vertices_ ||
+      (k != 0 && num_vertices_ > file_size / sizeof(double) / k)) {
+    fail("Landmark file has the wrong size");
+  }
+  const std::uint64_t table_size = num_vertices_ * k;
+  if (file_size != sizeof(header) + sizeof(std::uint64_t) * k +
+                       sizeof(double) * table_size * (is_directed_ ? 2 : 1)) {
+    fail("Landmark file has the wrong size");
+  }
+
+  std::vector<std::uint64_t> landmarks(k);
+  from_.resize(table_size);
+  in.read(reinterpret_cast<char*>(landmarks.data()),
+          sizeof(std::uint64_t) * k);
+  in.read(reinterpret_cast<char*>(from_.data()), sizeof(double) * table_size);
+  if (is_directed_) {
+    to_.resize(table_size);
+    in.read(reinterpret_cast<char*>(to_.data()), sizeof(double) * table_size);
+  }
+  if (!in) fail("Failed while reading file");
+  for (std::uint64_t landmark : landmarks) {
+    if (landmark >= num_vertices_) fail("Landmark file is corrupt");
+  }
+  landmarks_.assign(landmarks.begin(), landmarks.end());
+}
+
+double Landmarks::LowerBound(VertexId v1, VertexId v2) const {
+  const std::size_t k = landmarks_.size();
+  // Pointer arithmetic rather than indexing, since with no landmarks the
+  // tables are empty.
+  const std::vector<double>& to = is_directed_ ? to_ : from_;
+  return landmark_lower_bound(from_.data() + v1 * k, from_.data() + v2 * k,
+                              to.data() + v1 * k, to.data() + v2 * k, k);
+}
+
+void write_landmark_file(const Landmarks& landmarks, const std::string& path) {
+  LandmarkFileHeader header = {};
+  std::memcpy(header.magic, kLandmarkFileMagic, sizeof(header.magic));
+  header.version = kLandmarkFileVersion;
+  header.byte_order = kLandmarkFileByteOrder;
+  header.flags = landmarks.is_directed_ ? kLandmarkFileDirected : 0;
+  header.num_vertices = landmarks.num_vertices_;
+  header.num_landmarks = landmarks.landmarks_.size();
+  header.graph_checksum = landmarks.graph_checksum_;
+  std::vector<std::uint64_t> landmark_ids(landmarks.landmarks_.begin(),
+                                          landmarks.landmarks_.end());
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error(
+        "write_landmark_file error! Could not open file for writing (" + path +
+        ")\n");
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(landmark_ids.data()),
+            sizeof(std::uint64_t) * landmark_ids.size());
+  out.write(reinterpret_cast<const char*>(landmarks.from_.data()),
+            sizeof(double) * landmarks.from_.size());
+  out.write(reinterpret_cast<const char*>(landmarks.to_.data()),
+            sizeof(double) * landmarks.to_.size());
+  if (!out) {
+    throw std::runtime_error(
+        "write_landmark_file error! Failed while writing file (" + path +
+        ")\n");
+  }
+}
+
+}  // namespace graphlib
@@ -0,0 +1,119 @@
+/*
+"Landmarks" give lower bounds on shortest path distances for graphs that have
+no geometry to derive them from, so that A* search (see astar in
+weighted_paths.hpp) can be goal-directed on any graph. This is "ALT" search
+(A*, landmarks, and the triangle inequality) of Goldberg and Harrelson.
+
+A handful of vertices are picked as landmarks, and the distances from each
+landmark L to every vertex, and from every vertex to L, are computed up front.
+By the triangle inequality, for any vertices v and t,
+
+      d(v, t) >= d(L, t) - d(L, v)      and      d(v, t) >= d(v, L) - d(t, L)
+
+and the largest of these over all landmarks is the lower bound. It's tightest
+when t lies "behind" v as seen from some landmark, so good landmarks sit on the
+outskirts of the graph, spread around it. Two ways of picking them:
+- FARTHEST: repeatedly take the vertex farthest from the landmarks picked so
+  far (the first one being the farthest from a random vertex).
+- AVOID (Goldberg and Werneck): grow a shortest path tree from a random root,
+  and weigh each vertex by how far its distance from the root exceeds the
+  current lower bound on it. The new landmark is the leaf reached by walking
+  down from the root into the heaviest subtree each time, skipping subtrees
+  that already hold a landmark. This aims the landmark at the region the
+  current ones cover worst.
+The lower bounds are "consistent" (see bidirectional_astar), so Landmarks work
+for bidirectional search too.
+
+The distance tables take 2 * V doubles per landmark (V for an undirected graph),
+stored vertex by vertex so that a lower bound reads two contiguous rows. Tables
+can be written to a binary file and loaded back, so that the preprocessing
+survives restarts. The file records a checksum of the graph it was computed
+for, and refuses to load for any other graph (whose bounds could be wrong).
+
+Landmark file layout (native byte order, which is checked on load):
+
+      header     magic "LANDMARK", format version, byte order mark, flags
+                 (directed), V, number of landmarks k, graph checksum
+      landmarks  uint64[k]        VertexIds of the landmarks
+      from       double[V * k]    d(landmark i, v) at [v * k + i]
+      to         double[V * k]    d(v, landmark i) at [v * k + i], only if
+                                  directed
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+enum class LandmarkSelection { FARTHEST, AVOID };
+
+class Landmarks {
+ public:
+  // Picks num_landmarks landmarks (or all vertices, if there are fewer) of the
+  // given graph, whose edge weights must be non-negative, and computes their
+  // distance tables.
+  Landmarks(const Graph& graph, std::size_t num_landmarks,
+            LandmarkSelection selection = LandmarkSelection::AVOID);
+  Landmarks(const CompactGraph& graph, std::size_t num_landmarks,
+            LandmarkSelection selection = LandmarkSelection::AVOID);
+
+  // Loads the landmarks written to the given file by write_landmark_file, for
+  // the given graph.
+  Landmarks(const std::string& path, const Graph& graph);
+  Landmarks(const std::string& path, const CompactGraph& graph);
+
+  // The tables can be large, so they're moved rather than copied. Wrap a
+  // Landmarks in std::cref to pass it to astar as the heuristic.
+  Landmarks(const Landmarks&) = delete;
+  Landmarks& operator=(const Landmarks&) = delete;
+  Landmarks(Landmarks&&) = default;
+  Landmarks& operator=(Landmarks&&) = default;
+
+  std::size_t NumVertices() const { return num_vertices_; }
+  std::size_t NumLandmarks() const { return landmarks_.size(); }
+  bool IsDirected() const { return is_directed_; }
+
+  // VertexIds of the landmarks, in the order they were picked.
+  const std::vector<VertexId>& GetLandmarks() const { return landmarks_; }
+
+  // Distance from the i-th landmark to v, and from v to the i-th landmark.
+  double DistanceFrom(std::size_t i, VertexId v) const {
+    return from_[v * landmarks_.size() + i];
+  }
+  double DistanceTo(std::size_t i, VertexId v) const {
+    return (is_directed_ ? to_ : from_)[v * landmarks_.size() + i];
+  }
+
+  // Lower bound on the distance from v1 to v2.
+  double LowerBound(VertexId v1, VertexId v2) const;
+
+  // LowerBound as a heuristic(v1, v2) for astar and bidirectional_astar.
+  double operator()(const Vertex* v1, const Vertex* v2) const {
+    return LowerBound(v1->id_, v2->id_);
+  }
+
+ private:
+  friend void write_landmark_file(const Landmarks& landmarks,
+                                  const std::string& path);
+
+  std::size_t num_vertices_ = 0;
+  bool is_directed_ = false;
+  std::uint64_t graph_checksum_ = 0;
+
+  std::vector<VertexId> landmarks_;
+  std::vector<double> from_, to_;  // to_ is empty if undirected
+};
+
+// Write the given landmarks to a binary landmark file, replacing any existing
+// file.
+void write_landmark_file(const Landmarks& landmarks, const std::string& path);
+
+}  // namespace graphlib
@@ -1,158 +1,277 @@
 #include "graphlib/algo/mst.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <iostream>
-#include <queue>
+#include <numeric>
+#include <utility>
+
+#include "graphlib/geometry/delaunay.hpp"
+#include "graphlib/geometry/spatial_index_2d.hpp"
+#include "graphlib/parallel.hpp"
+#include "graphlib/union_find.hpp"
 
 namespace graphlib {
 
-// Min-heap keeps track of the shortest edge between a non-tree vertex and the
-// growing spanning tree.
-std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>>
-    g_crossing_edges;
-
-// Debugging utility to check contents of an Edge priority queue.
-std::string to_string(
-    std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> pq) {
-  std::string s("Edge priority queue contents:\n");
-  while (!pq.empty()) {
-    s += to_string(pq.top());
-    pq.pop();
+// Weighted edge between VertexIds.
+struct IdEdge {
+  double weight;
+  VertexId v1, v2;
+};
+
+// Kruskal's algorithm over a flat array of unique edges. Sorting the array
+// once (in parallel) replaces one priority queue operation per edge, and
+// Union-Find with path compression keeps each cycle check nearly constant time.
+template <typename GraphType>
+std::vector<Edge> kruskal_on_edges(const GraphType* graph,
+                                   std::vector<IdEdge> edges,
+                                   unsigned num_threads) {
+  parallel_stable_sort(edges.begin(), edges.end(), num_threads,
+                       [](const IdEdge& lhs, const IdEdge& rhs) {
+                         return lhs.weight < rhs.weight;
+                       });
+
+  std::vector<Edge> mst;
+  UnionFind uf(graph->NumVertices());
+  for (const IdEdge& e : edges) {
+    if (uf.NumSets() == 1) break;
+    if (uf.Union(e.v1, e.v2)) {
+      mst.emplace_back(graph->GetVertexPtr(e.v1), graph->GetVertexPtr(e.v2),
+                       e.weight);
+    }
+  }
+  return mst;
+}
+
+// Each undirected edge is stored in both directions; these keep only the copy
+// from the lower VertexId (which also drops self-loops).
+std::vector<IdEdge> unique_undirected_edges(const Graph* graph) {
+  std::vector<IdEdge> edges;
+  for (const auto& p : graph->GetAdjacencyMap()) {
+    for (const auto& adj : p.second) {
+      if (p.first->id_ < adj.first->id_) {
+        edges.push_back({adj.second, p.first->id_, adj.first->id_});
+      }
+    }
   }
-  s += '\n';
-  return s;
+  return edges;
 }
 
-void prim_visit(Graph* graph, const Vertex* v) {
-  v->state_ = Vertex::State::DISCOVERED;
-  for (auto& adj : graph->GetAdjacentSet(v)) {
-    const Vertex* v2 = adj.first;
-    double weight = adj.second;
-    if (v2->state_ == Vertex::State::UNDISCOVERED) {
-      g_crossing_edges.emplace(v, v2, weight);
+std::vector<IdEdge> unique_undirected_edges(const CompactGraph* graph) {
+  std::vector<IdEdge> edges;
+  edges.reserve(graph->NumEdges() / 2);
+  for (VertexId v = 0; v != static_cast<VertexId>(graph->NumVertices()); ++v) {
+    for (std::size_t e = graph->EdgeBegin(v); e != graph->EdgeEnd(v); ++e) {
+      if (v < graph->GetTarget(e)) {
+        edges.push_back({graph->GetWeight(e), v, graph->GetTarget(e)});
+      }
     }
   }
+  return edges;
 }
 
-// "Lazy" implementation of Prim's algorithm as seen in Sedgewick.
-std::vector<Edge> prim_mst(Graph* graph) {
+std::vector<Edge> kruskal_mst(const Graph* graph, unsigned num_threads) {
   if (graph->IsDirected()) {
-    std::cerr << "Error: Tried to run Prim's algorithm on directed graph!\n";
+    std::cerr << "Error: Tried to run Kruskal's algorithm on directed graph!\n";
     return std::vector<Edge>();
   }
+  return kruskal_on_edges(graph, unique_undirected_edges(graph), num_threads);
+}
 
-  std::vector<Edge> mst;
-  while (!g_crossing_edges.empty()) {
-    g_crossing_edges.pop();
+std::vector<Edge> kruskal_mst(const CompactGraph* graph, unsigned num_threads) {
+  if (graph->IsDirected()) {
+    std::cerr << "Error: Tried to run Kruskal's algorithm on directed graph!\n";
+    return std::vector<Edge>();
   }
+  return kruskal_on_edges(graph, unique_undirected_edges(graph), num_threads);
+}
+
+// Lets kruskal_on_edges treat a list of points like the vertices of a graph,
+// numbered by position in the list.
+struct EuclideanPointList {
+  std::size_t NumVertices() const { return points->size(); }
+  const Vertex* GetVertexPtr(VertexId i) const { return (*points)[i]; }
 
-  // Assuming the given graph is connected, this successfully adds at least one
-  // crossing edge to the priority queue to kick off the algorithm.
-  prim_visit(graph, graph->GetAdjacencyMap().cbegin()->first);
+  const std::vector<const Vertex2d*>* points;
+};
+
+// Number of nearest neighbors that points left out of the Delaunay
+// triangulation are connected to.
+const std::size_t kEuclideanMstNeighbors = 8;
 
-  while (!g_crossing_edges.empty()) {
-    Edge e = g_crossing_edges.top();
-    g_crossing_edges.pop();
+std::vector<Edge> euclidean_mst(const std::vector<const Vertex2d*>& points,
+                                unsigned num_threads) {
+  const std::size_t num_points = points.size();
+  std::vector<IdEdge> edges;
+  auto add_edge = [&](std::size_t i, std::size_t j) {
+    edges.push_back({distance_2d(*points[i], *points[j]),
+                     static_cast<VertexId>(i), static_cast<VertexId>(j)});
+  };
 
-    if (e.v1_->state_ == Vertex::State::DISCOVERED &&
-        e.v2_->state_ == Vertex::State::DISCOVERED) {
-      continue;
+  DelaunayTriangulation triangulation = delaunay_triangulation(points);
+  const std::vector<std::size_t>& triangles = triangulation.triangles_;
+  std::vector<bool> triangulated(num_points, triangles.empty());
+  if (triangles.empty()) {
+    // The points are all collinear (or fewer than 3), so the tree is the path
+    // through them in order along their line.
+    std::vector<std::size_t> order(num_points);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j) {
+      return std::make_pair(points[i]->x_, points[i]->y_) <
+             std::make_pair(points[j]->x_, points[j]->y_);
+    });
+    for (std::size_t k = 1; k < num_points; ++k) {
+      add_edge(order[k - 1], order[k]);
     }
-    mst.push_back(e);
-    if (e.v1_->state_ == Vertex::State::UNDISCOVERED) {
-      prim_visit(graph, e.v1_);
+  }
+  edges.reserve(triangles.size() / 2 + 1);
+  for (std::size_t e = 0; e != triangles.size(); ++e) {
+    triangulated[triangles[e]] = true;
+    // Interior edges have a half-edge on either side; keep just one of them.
+    // Hull edges have no opposite, which compares greater than any half-edge.
+    if (e < triangulation.halfedges_[e]) {
+      add_edge(triangles[e], triangles[e - e % 3 + (e + 1) % 3]);
     }
-    if (e.v2_->state_ == Vertex::State::UNDISCOVERED) {
-      prim_visit(graph, e.v2_);
+  }
+
+  if (std::find(triangulated.begin(), triangulated.end(), false) !=
+      triangulated.end()) {
+    SpatialIndex2d index;
+    std::vector<SpatialIndex2d::Point> index_points;
+    index_points.reserve(num_points);
+    for (std::size_t i = 0; i != num_points; ++i) {
+      index_points.push_back(
+          {points[i]->x_, points[i]->y_, static_cast<VertexId>(i)});
+    }
+    index.Insert(std::move(index_points));
+    for (std::size_t i = 0; i != num_points; ++i) {
+      if (triangulated[i]) continue;
+      for (VertexId j : index.KNearest(points[i]->x_, points[i]->y_,
+                                       kEuclideanMstNeighbors + 1)) {
+        if (j != static_cast<VertexId>(i)) add_edge(i, j);
+      }
     }
   }
-  return mst;
+
+  EuclideanPointList point_list = {&points};
+  return kruskal_on_edges(&point_list, std::move(edges), num_threads);
 }
 
-// This is a Graph adaptation of the weighted Union-Find data structure to help
-// with Kruskal's algorithm. The universal set is the set of all Vertices in a
-// given Graph, and the disjoint subsets maintained by the weighted Union-Find
-// represent connected components.
-//
-// Each disjoint subset can be represented as a tree, with the tree root
-// "naming" the subset. The underlying implementation here is composed of two
-// maps, one of which binds each Vertex to its parent in its tree. Vertices
-// bound to a nullptr represent tree roots. The other map keeps track of each
-// tree's size, which is used to keep trees balanced when they are merged.
-class VertexUnionFind {
- public:
-  VertexUnionFind(Graph* graph) {
-    // Initially, each vertex is its own subset / connected component.
-    for (const auto& v : graph->GetAdjacencyMap()) {
-      parents_[v.first] = nullptr;
-      sizes_[v.first] = 1;
-    }
+std::vector<Edge> euclidean_mst(const Graph2d* graph, unsigned num_threads) {
+  std::vector<const Vertex2d*> points;
+  points.reserve(graph->NumVertices());
+  for (VertexId v = 0; v != static_cast<VertexId>(graph->NumVertices()); ++v) {
+    points.push_back(static_cast<const Vertex2d*>(graph->GetVertexPtr(v)));
   }
+  return euclidean_mst(points, num_threads);
+}
+
+// Smallest number of edges (or vertices) worth handing to a thread.
+const std::size_t kBoruvkaMinChunkSize = 4096;
+
+const std::size_t kNoEdge = static_cast<std::size_t>(-1);
+
+// Boruvka's algorithm over a flat array of unique edges. Each round, every
+// component picks its cheapest edge to another component, all picked edges
+// join the forest, and the components they connect are merged. Each round at
+// least halves the number of components that still have outgoing edges, so
+// there are at most log V rounds.
+//
+// Ties between equal weights are broken by position in the edge array. With
+// this strict order, the picked edges can't form a cycle (the classic pitfall
+// of Boruvka's algorithm), and the forest doesn't depend on the number of
+// threads.
+template <typename GraphType>
+std::vector<Edge> boruvka_on_edges(const GraphType* graph,
+                                   std::vector<IdEdge> edges,
+                                   unsigned num_threads) {
+  const std::size_t num_vertices = graph->NumVertices();
+  std::vector<Edge> msf;
+  UnionFind uf(num_vertices);
+  std::vector<VertexId> component(num_vertices);
+  for (std::size_t v = 0; v != num_vertices; ++v) component[v] = v;
 
-  // Returns the "name" of the subset / connected component containing a given
-  // Vertex (i.e. the root of the given Vertex's tree.)
-  const Vertex* Find(const Vertex* v) const {
-    while (parents_.at(v)) {
-      v = parents_.at(v);
+  // Index of the cheapest known edge out of each component (by root).
+  // Threads race to lower these, so they're atomic.
+  std::vector<std::atomic<std::size_t>> cheapest(num_vertices);
+  auto lighter = [&](std::size_t e1, std::size_t e2) {
+    return e2 == kNoEdge || edges[e1].weight < edges[e2].weight ||
+           (edges[e1].weight == edges[e2].weight && e1 < e2);
+  };
+  auto offer = [&](VertexId root, std::size_t e) {
+    std::size_t current = cheapest[root].load(std::memory_order_relaxed);
+    while (lighter(e, current) &&
+           !cheapest[root].compare_exchange_weak(current, e,
+                                                 std::memory_order_relaxed)) {
     }
-    return v;
-  }
+  };
 
-  bool IsConnected(const Vertex* v1, const Vertex* v2) const {
-    return Find(v1) == Find(v2);
-  }
+  while (!edges.empty()) {
+    parallel_for(0, num_vertices, num_threads, kBoruvkaMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t v = begin; v != end; ++v) {
+                     cheapest[v].store(kNoEdge, std::memory_order_relaxed);
+                   }
+                 });
+    parallel_for(0, edges.size(), num_threads, kBoruvkaMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t e = begin; e != end; ++e) {
+                     offer(component[edges[e].v1], e);
+                     offer(component[edges[e].v2], e);
+                   }
+                 });
 
-  // Merge the subsets containing the given Vertices.
-  void Union(const Vertex* v1, const Vertex* v2) {
-    if (IsConnected(v1, v2)) {
-      return;
+    // Join the picked edges (an edge picked by both of its components is only
+    // joined once). There is at most one per component, so this is cheap.
+    for (std::size_t root = 0; root != num_vertices; ++root) {
+      std::size_t e = cheapest[root].load(std::memory_order_relaxed);
+      if (e != kNoEdge && uf.Union(edges[e].v1, edges[e].v2)) {
+        msf.emplace_back(graph->GetVertexPtr(edges[e].v1),
+                         graph->GetVertexPtr(edges[e].v2), edges[e].weight);
+      }
     }
 
-    // Merge the smaller tree into the larger tree to maintain balance.
-    const Vertex *set1 = Find(v1), *set2 = Find(v2);
-    if (sizes_.at(set1) < sizes_.at(set2)) {
-      parents_.at(set1) = set2;
-      sizes_.at(set2) += sizes_.at(set1);
-    } else {
-      parents_.at(set2) = set1;
-      sizes_.at(set1) += sizes_.at(set2);
+    // Relabel vertices with their merged components, then drop the edges that
+    // are now inside a component.
+    parallel_for(0, num_vertices, num_threads, kBoruvkaMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t v = begin; v != end; ++v) {
+                     component[v] = uf.FindRoot(v);
+                   }
+                 });
+    std::vector<std::vector<IdEdge>> kept(
+        num_threads ? num_threads : default_num_threads());
+    parallel_for(0, edges.size(), num_threads, kBoruvkaMinChunkSize,
+                 [&](std::size_t begin, std::size_t end, unsigned thread) {
+                   for (std::size_t e = begin; e != end; ++e) {
+                     if (component[edges[e].v1] != component[edges[e].v2]) {
+                       kept[thread].push_back(edges[e]);
+                     }
+                   }
+                 });
+    edges.clear();
+    for (const std::vector<IdEdge>& thread_edges : kept) {
+      edges.insert(edges.end(), thread_edges.begin(), thread_edges.end());
     }
   }
+  return msf;
+}
 
- private:
-  std::map<const Vertex*, const Vertex*> parents_;
-  std::map<const Vertex*, int> sizes_;
-};
-
-std::vector<Edge> kruskal_mst(Graph* graph) {
+std::vector<Edge> boruvka_msf(const Graph* graph, unsigned num_threads) {
   if (graph->IsDirected()) {
-    std::cerr << "Error: Tried to run Kruskal's algorithm on directed graph!\n";
+    std::cerr << "Error: Tried to run Boruvka's algorithm on directed graph!\n";
     return std::vector<Edge>();
   }
+  return boruvka_on_edges(graph, unique_undirected_edges(graph), num_threads);
+}
 
-  std::vector<Edge> mst;
-  while (!g_crossing_edges.empty()) {
-    g_crossing_edges.pop();
-  }
-
-  // Add all edges in given graph to priority queue.
-  for (const auto& p : graph->GetAdjacencyMap()) {
-    for (const auto& adj : p.second) {
-      g_crossing_edges.emplace(p.first, adj.first, adj.second);
-    }
-  }
-
-  VertexUnionFind uf(graph);
-  while (!g_crossing_edges.empty() &&
-         mst.size() < graph->GetAdjacencyMap().size()) {
-    Edge e = g_crossing_edges.top();
-    g_crossing_edges.pop();
-
-    if (!uf.IsConnected(e.v1_, e.v2_)) {
-      uf.Union(e.v1_, e.v2_);
-      mst.push_back(e);
-    }
+std::vector<Edge> boruvka_msf(const CompactGraph* graph, unsigned num_threads) {
+  if (graph->IsDirected()) {
+    std::cerr << "Error: Tried to run Boruvka's algorithm on directed graph!\n";
+    return std::vector<Edge>();
   }
-  return mst;
+  return boruvka_on_edges(graph, unique_undirected_edges(graph), num_threads);
 }
 
 }  // namespace graphlib
@@ -5,16 +5,138 @@
 
 #pragma once
 
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/geometry/graph_2d.hpp"
 #include "graphlib/graph.hpp"
+#include "graphlib/indexed_heap.hpp"
+#include "graphlib/search_state.hpp"
 
+#include <cstddef>
+#include <iostream>
 #include <vector>
 
 namespace graphlib {
 
-// Prim's algorithm. Assumes given graph is connected.
-std::vector<Edge> prim_mst(Graph* graph);
+// Prim's algorithm. Assumes given graph is connected. Arity is that of the
+// IndexedMinHeap holding the vertices not yet in the tree (see
+// indexed_heap.hpp).
+template <std::size_t Arity = kDefaultHeapArity>
+std::vector<Edge> prim_mst(const Graph* graph);
 
-// Kruskal's algorithm.
-std::vector<Edge> kruskal_mst(Graph* graph);
+// Kruskal's algorithm. Returns a minimum spanning forest if the given graph
+// isn't connected. The edges are sorted on num_threads threads (one per
+// hardware thread if 0).
+std::vector<Edge> kruskal_mst(const Graph* graph, unsigned num_threads = 0);
+
+// Boruvka's algorithm, for a minimum spanning forest (one minimum spanning tree
+// per connected component). Runs in rounds, each of which scans the remaining
+// edges on num_threads threads (one per hardware thread if 0) for the cheapest
+// edge out of each component, then merges the components those edges connect.
+std::vector<Edge> boruvka_msf(const Graph* graph, unsigned num_threads = 0);
+
+// Euclidean minimum spanning tree: the minimum spanning tree of the complete
+// graph on the given points, with straight-line distances as edge weights.
+// Every edge of it is also an edge of the points' Delaunay triangulation (see
+// delaunay.hpp), so Kruskal's algorithm only needs to consider the O(n) edges
+// of the triangulation, instead of all O(n^2) pairs: O(n log n) time overall.
+// Points left out of the triangulation (duplicates and near-duplicates) are
+// connected through their nearest neighbors instead. The edges are sorted on
+// num_threads threads (one per hardware thread if 0).
+std::vector<Edge> euclidean_mst(const std::vector<const Vertex2d*>& points,
+                                unsigned num_threads = 0);
+
+// Euclidean minimum spanning tree of the vertices of the given graph. The
+// graph's own edges are ignored.
+std::vector<Edge> euclidean_mst(const Graph2d* graph,
+                                unsigned num_threads = 0);
+
+// CompactGraph overloads of the above.
+template <std::size_t Arity = kDefaultHeapArity>
+std::vector<Edge> prim_mst(const CompactGraph* graph);
+std::vector<Edge> kruskal_mst(const CompactGraph* graph,
+                              unsigned num_threads = 0);
+std::vector<Edge> boruvka_msf(const CompactGraph* graph,
+                              unsigned num_threads = 0);
+
+// "Eager" implementation of Prim's algorithm as seen in Sedgewick. Instead of
+// keeping every crossing edge on a min-heap (and skipping the ones made
+// obsolete as the tree grows), keep only the shortest crossing edge to each
+// non-tree vertex: an IndexedMinHeap of non-tree vertices keyed by the weight
+// of that edge, whose tree endpoint is recorded as the vertex's search tree
+// parent. A vertex's key is lowered whenever a shorter crossing edge to it
+// shows up.
+template <std::size_t Arity>
+std::vector<Edge> prim_mst(const Graph* graph) {
+  if (graph->IsDirected()) {
+    std::cerr << "Error: Tried to run Prim's algorithm on directed graph!\n";
+    return std::vector<Edge>();
+  }
+
+  std::vector<Edge> mst;
+  if (graph->NumVertices() == 0) return mst;
+
+  SearchState state(graph->NumVertices());
+  IndexedMinHeap<Arity> crossing_edges(graph->NumVertices());
+  crossing_edges.Push(graph->GetAdjacencyMap().cbegin()->first->id_, 0);
+
+  while (!crossing_edges.Empty()) {
+    double weight = crossing_edges.TopKey();
+    const Vertex* v1 = graph->GetVertexPtr(crossing_edges.Pop());
+    state.state_[v1->id_] = VertexState::DISCOVERED;
+    if (state.parent_[v1->id_] != kNoVertex) {
+      mst.emplace_back(graph->GetVertexPtr(state.parent_[v1->id_]), v1,
+                       weight);
+    }
+
+    for (auto& adj : graph->GetAdjacentSet(v1)) {
+      const Vertex* v2 = adj.first;
+      if (state.state_[v2->id_] == VertexState::DISCOVERED) continue;
+      if (!crossing_edges.Contains(v2->id_) ||
+          adj.second < crossing_edges.GetKey(v2->id_)) {
+        state.parent_[v2->id_] = v1->id_;
+        crossing_edges.PushOrDecreaseKey(v2->id_, adj.second);
+      }
+    }
+  }
+  return mst;
+}
+
+template <std::size_t Arity>
+std::vector<Edge> prim_mst(const CompactGraph* graph) {
+  if (graph->IsDirected()) {
+    std::cerr << "Error: Tried to run Prim's algorithm on directed graph!\n";
+    return std::vector<Edge>();
+  }
+
+  std::vector<Edge> mst;
+  if (graph->NumVertices() == 0) return mst;
+
+  // Same "eager" strategy as the Graph overload, starting from VertexId 0.
+  std::vector<bool> in_tree(graph->NumVertices(), false);
+  std::vector<VertexId> edge_to(graph->NumVertices(), kNoVertex);
+  IndexedMinHeap<Arity> crossing_edges(graph->NumVertices());
+  crossing_edges.Push(0, 0);
+
+  while (!crossing_edges.Empty()) {
+    double weight = crossing_edges.TopKey();
+    VertexId v1 = crossing_edges.Pop();
+    in_tree[v1] = true;
+    if (edge_to[v1] != kNoVertex) {
+      mst.emplace_back(graph->GetVertexPtr(edge_to[v1]),
+                       graph->GetVertexPtr(v1), weight);
+    }
+
+    for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1); ++e) {
+      VertexId v2 = graph->GetTarget(e);
+      if (in_tree[v2]) continue;
+      if (!crossing_edges.Contains(v2) ||
+          graph->GetWeight(e) < crossing_edges.GetKey(v2)) {
+        edge_to[v2] = v1;
+        crossing_edges.PushOrDecreaseKey(v2, graph->GetWeight(e));
+      }
+    }
+  }
+  return mst;
+}
 
 }  // namespace graphlib
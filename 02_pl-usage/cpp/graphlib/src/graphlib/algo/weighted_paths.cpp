@@ -1,83 +1,42 @@
 #include "graphlib/algo/weighted_paths.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <numeric>
 #include <queue>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "graphlib/algo/dfs.hpp"
+#include "graphlib/indexed_heap.hpp"
+#include "graphlib/parallel.hpp"
 
 namespace graphlib {
 
-// Maps each vertex to its currently-known shortest distance to the search
-// root.
-std::map<const Vertex*, double> g_dist_to_root;
-
 // Several algorithms implemented here start by setting the known distance to
 // the search root to 0 and the known distance to all other (yet undiscovered)
 // vertices to infinity.
-void setup_dist_to_root(Graph* graph, const Vertex* search_root) {
-  g_dist_to_root.clear();
-  for (const auto& v : graph->GetAdjacencyMap()) {
-    if (v.first == search_root) {
-      g_dist_to_root[v.first] = 0;
-    } else {
-      g_dist_to_root[v.first] = std::numeric_limits<double>::infinity();
-    }
-  }
+void setup_dist_to_root(SearchState* state, VertexId search_root) {
+  std::fill(state->dist_to_root_.begin(), state->dist_to_root_.end(),
+            std::numeric_limits<double>::infinity());
+  state->dist_to_root_[search_root] = 0;
 }
 
-// Comparator to emulate Dijkstra's min-heap with an underlying std::vector.
-struct GreaterDistToRoot {
-  bool operator()(const Vertex* lhs, const Vertex* rhs) const {
-    return g_dist_to_root.at(lhs) > g_dist_to_root.at(rhs);
-  }
-};
-
-// Dijkstra's algorithm uses a min-heap to keep track of the next non-tree
-// Vertex closest to the search root. std::priority_queue doesn't work here
-// because we need the ability to change the "value" (distance to search root)
-// of a Vertex already in the heap and reheapify on the go. To support this
-// functionality, we use std::make_heap, std::push_heap, and std::pop_heap on an
-// underlying std::vector.
-void dijkstra(Graph* graph, const Vertex* search_root,
-              const Vertex* destination) {
-  setup_dist_to_root(graph, search_root);
-
-  std::vector<const Vertex*> min_heap;
-  min_heap.push_back(search_root);
-
-  while (!min_heap.empty()) {
-    // Bubble the smallest element (top of min-heap) down to the end of the
-    // underlying vector, store it in v1, then pop it.
-    std::pop_heap(min_heap.begin(), min_heap.end(), GreaterDistToRoot());
-    const Vertex* v1 = min_heap.back();
-    min_heap.pop_back();
-
-    if (v1 == destination) return;
-
-    for (auto& adj : graph->GetAdjacentSet(v1)) {
-      const Vertex* v2 = adj.first;
-      double weight = adj.second;
+void astar(const Graph2d* graph, const Vertex* search_root, SearchState* state,
+           const Vertex* destination) {
+  astar(static_cast<const Graph*>(graph), search_root, state, destination,
+        distance_2d_heuristic);
+}
 
-      if (g_dist_to_root.at(v2) > g_dist_to_root.at(v1) + weight) {
-        g_dist_to_root.at(v2) = g_dist_to_root.at(v1) + weight;
-        v2->parent_ = v1;
-
-        if (std::find(min_heap.begin(), min_heap.end(), v2) != min_heap.end()) {
-          // If v2 is already in the min-heap, do a complete reheapify of the
-          // underlying vector with v2's updated "g_dist_to_root" value.
-          std::make_heap(min_heap.begin(), min_heap.end(), GreaterDistToRoot());
-        } else {
-          // If v2 is not yet in the min-heap, push it to the back of the
-          // underlying vector, then bubble it up to its proper heap placement.
-          min_heap.push_back(v2);
-          std::push_heap(min_heap.begin(), min_heap.end(), GreaterDistToRoot());
-        }
-      }
-    }
-  }
+void bidirectional_astar(const Graph2d* graph, const Vertex* search_root,
+                         SearchState* state, const Vertex* destination,
+                         const Graph* reverse_graph) {
+  bidirectional_astar(static_cast<const Graph*>(graph), search_root, state,
+                      destination, distance_2d_heuristic, reverse_graph);
 }
 
 // UNTESTED!
@@ -91,9 +50,10 @@ void dijkstra(Graph* graph, const Vertex* search_root,
 // dist_to_root[v] can't change after v is processed. Therefore, all edges
 // coming out of v will only be relaxed when v is being processed (and never
 // after).
-void dag_paths(Graph* graph, const Vertex* search_root,
-               const Vertex* destination) {
-  setup_dist_to_root(graph, search_root);
+void dag_paths(const Graph* graph, const Vertex* search_root,
+               SearchState* state, const Vertex* destination) {
+  setup_dist_to_root(state, graph->GetVertexPtr(*search_root)->id_);
+  std::vector<double>& dist_to_root = state->dist_to_root_;
 
   std::stack<const Vertex*> s = topological_sort(graph);
   while (!s.empty()) {
@@ -106,117 +66,599 @@ void dag_paths(Graph* graph, const Vertex* search_root,
       const Vertex* v2 = adj.first;
       double weight = adj.second;
 
-      if (g_dist_to_root.at(v2) > g_dist_to_root.at(v1) + weight) {
-        g_dist_to_root.at(v2) = g_dist_to_root.at(v1) + weight;
-        v2->parent_ = v1;
+      if (dist_to_root[v2->id_] > dist_to_root[v1->id_] + weight) {
+        dist_to_root[v2->id_] = dist_to_root[v1->id_] + weight;
+        state->parent_[v2->id_] = v1->id_;
       }
     }
   }
 }
 
-void bellman_ford(Graph* graph, const Vertex* search_root) {
-  setup_dist_to_root(graph, search_root);
+void bellman_ford(const Graph* graph, const Vertex* search_root,
+                  SearchState* state) {
+  search_root = graph->GetVertexPtr(*search_root);
+  setup_dist_to_root(state, search_root->id_);
+  std::vector<double>& dist_to_root = state->dist_to_root_;
   std::queue<const Vertex*> q;
-  std::map<const Vertex*, bool> on_q;  // quick lookup for if vertex is on queue
-  for (const auto& v : graph->GetAdjacencyMap()) {
-    on_q[v.first] = false;
-  }
+  // Quick lookup for if vertex is on queue.
+  std::vector<bool> on_q(graph->NumVertices(), false);
 
   q.push(search_root);
-  on_q.at(search_root) = true;
+  on_q[search_root->id_] = true;
 
   while (!q.empty()) {
     const Vertex* v1 = q.front();
     q.pop();
-    on_q.at(v1) = false;
+    on_q[v1->id_] = false;
 
     for (auto& adj : graph->GetAdjacentSet(v1)) {
       const Vertex* v2 = adj.first;
       double weight = adj.second;
 
-      if (g_dist_to_root.at(v2) > g_dist_to_root.at(v1) + weight) {
-        g_dist_to_root.at(v2) = g_dist_to_root.at(v1) + weight;
-        v2->parent_ = v1;
+      if (dist_to_root[v2->id_] > dist_to_root[v1->id_] + weight) {
+        dist_to_root[v2->id_] = dist_to_root[v1->id_] + weight;
+        state->parent_[v2->id_] = v1->id_;
 
-        if (!on_q.at(v2)) {
+        if (!on_q[v2->id_]) {
           q.push(v2);
-          on_q.at(v2) = true;
+          on_q[v2->id_] = true;
         }
       }
     }
   }
 }
 
-// Returns a stack for the path currently encoded in the parent members of each
-// Vertex. Analogous to shortest_unweighted_path generation in bfs.cpp
-std::stack<const Vertex*> get_path_helper(Graph* graph,
-                                          const Vertex* search_root,
-                                          const Vertex* destination) {
-  const Vertex* v = destination;
-  std::stack<const Vertex*> s;
-  s.push(v);
-
-  while (v != search_root) {
-    if (v) {
-      v = v->parent_;
-      s.push(v);
-    } else {
-      std::cerr << "No path between " << search_root->name_ << " and "
-                << destination->name_ << "\n\n";
-      return std::stack<const Vertex*>();
+std::stack<const Vertex*> shortest_weighted_path(const Graph* graph,
+                                                 const Vertex* search_root,
+                                                 const Vertex* destination) {
+  SearchState state(graph->NumVertices());
+  bellman_ford(graph, search_root, &state);
+  return get_path(graph, state, search_root, destination);
+}
+
+// Per-thread state of shortest_pos_weight_paths, reused across its searches.
+// After each search, only the vertices it touched are reset.
+struct BatchPathWorkspace {
+  explicit BatchPathWorkspace(std::size_t num_vertices)
+      : dist(num_vertices, std::numeric_limits<double>::infinity()),
+        parent(num_vertices, kNoVertex),
+        is_destination(num_vertices, false),
+        heap(num_vertices) {}
+
+  std::vector<double> dist;
+  std::vector<VertexId> parent;
+  std::vector<bool> is_destination;  // not yet processed by this search
+  std::vector<VertexId> touched;
+  IndexedMinHeap<> heap;
+};
+
+// Implementation of shortest_pos_weight_paths over the (source, destination)
+// VertexIds of the queries, shared by both graph types. for_each_edge(v,
+// function) calls function(target, weight) for each edge out of v.
+template <typename GraphType, typename ForEachEdge>
+std::vector<PathResult> batch_pos_weight_paths(
+    const GraphType* graph,
+    const std::vector<std::pair<VertexId, VertexId>>& queries,
+    unsigned num_threads, ForEachEdge for_each_edge) {
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  std::vector<PathResult> results(queries.size());
+
+  // Sort the queries by source, and split them into groups with one source.
+  std::vector<std::size_t> order(queries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&queries](std::size_t lhs, std::size_t rhs) {
+                     return queries[lhs].first < queries[rhs].first;
+                   });
+  std::vector<std::size_t> group_begins;
+  for (std::size_t i = 0; i != order.size(); ++i) {
+    if (i == 0 || queries[order[i]].first != queries[order[i - 1]].first) {
+      group_begins.push_back(i);
     }
   }
-  return s;
+  group_begins.push_back(order.size());
+
+  if (num_threads == 0) num_threads = default_num_threads();
+  std::vector<std::unique_ptr<BatchPathWorkspace>> workspaces(num_threads);
+  parallel_for_dynamic(
+      0, group_begins.size() - 1, num_threads,
+      [&](std::size_t group, unsigned thread_index) {
+        if (!workspaces[thread_index]) {
+          workspaces[thread_index] =
+              std::make_unique<BatchPathWorkspace>(graph->NumVertices());
+        }
+        BatchPathWorkspace& w = *workspaces[thread_index];
+        const std::size_t begin = group_begins[group];
+        const std::size_t end = group_begins[group + 1];
+        const VertexId source = queries[order[begin]].first;
+
+        std::size_t remaining = 0;
+        for (std::size_t i = begin; i != end; ++i) {
+          const VertexId destination = queries[order[i]].second;
+          if (!w.is_destination[destination]) {
+            w.is_destination[destination] = true;
+            ++remaining;
+          }
+        }
+
+        w.dist[source] = 0;
+        w.touched.push_back(source);
+        w.heap.Push(source, 0);
+        while (remaining != 0 && !w.heap.Empty()) {
+          const VertexId v1 = w.heap.Pop();
+          if (w.is_destination[v1]) {
+            w.is_destination[v1] = false;
+            --remaining;
+          }
+          for_each_edge(v1, [&](VertexId v2, double weight) {
+            const double dist_through_v1 = w.dist[v1] + weight;
+            if (w.dist[v2] > dist_through_v1) {
+              if (w.dist[v2] == kInfinity) w.touched.push_back(v2);
+              w.dist[v2] = dist_through_v1;
+              w.parent[v2] = v1;
+              w.heap.PushOrDecreaseKey(v2, dist_through_v1);
+            }
+          });
+        }
+
+        for (std::size_t i = begin; i != end; ++i) {
+          const VertexId destination = queries[order[i]].second;
+          PathResult& result = results[order[i]];
+          w.is_destination[destination] = false;  // if it was never reached
+          result.distance_ = w.dist[destination];
+          if (result.distance_ == kInfinity) continue;
+          VertexId v = destination;
+          result.path_.push(graph->GetVertexPtr(v));
+          while (v != source) {
+            v = w.parent[v];
+            result.path_.push(graph->GetVertexPtr(v));
+          }
+        }
+
+        w.heap.Clear();
+        for (VertexId v : w.touched) {
+          w.dist[v] = kInfinity;
+          w.parent[v] = kNoVertex;
+        }
+        w.touched.clear();
+      });
+  return results;
 }
 
-std::stack<const Vertex*> shortest_pos_weight_path(Graph* graph,
-                                                   const Vertex* search_root,
-                                                   const Vertex* destination) {
-  dijkstra(graph, search_root, destination);
-  return get_path_helper(graph, search_root, destination);
+std::vector<PathResult> shortest_pos_weight_paths(
+    const Graph* graph, const std::vector<PathQuery>& queries,
+    unsigned num_threads) {
+  std::vector<std::pair<VertexId, VertexId>> ids;
+  ids.reserve(queries.size());
+  for (const PathQuery& query : queries) {
+    ids.emplace_back(graph->GetVertexPtr(*query.source_)->id_,
+                     graph->GetVertexPtr(*query.destination_)->id_);
+  }
+  return batch_pos_weight_paths(
+      graph, ids, num_threads, [graph](VertexId v, auto function) {
+        for (auto& adj : graph->GetAdjacentSet(graph->GetVertexPtr(v))) {
+          function(adj.first->id_, adj.second);
+        }
+      });
 }
 
-std::stack<const Vertex*> shortest_weighted_path(Graph* graph,
-                                                 const Vertex* search_root,
-                                                 const Vertex* destination) {
-  bellman_ford(graph, search_root);
-  return get_path_helper(graph, search_root, destination);
+std::vector<PathResult> shortest_pos_weight_paths(
+    const Graph* graph, const Vertex* source,
+    const std::vector<const Vertex*>& destinations, unsigned num_threads) {
+  std::vector<PathQuery> queries;
+  queries.reserve(destinations.size());
+  for (const Vertex* destination : destinations) {
+    queries.push_back({source, destination});
+  }
+  return shortest_pos_weight_paths(graph, queries, num_threads);
+}
+
+// Side of the square blocks of the distance matrix relaxed at a time. Three
+// blocks of doubles (the one being relaxed, and the two it's relaxed through)
+// take 96 KiB, which fits in a typical L2 cache.
+const std::size_t kFloydWarshallBlockSize = 64;
+
+DenseDistanceMatrix::DenseDistanceMatrix(std::size_t num_vertices)
+    : num_vertices_(num_vertices),
+      stride_((num_vertices + kFloydWarshallBlockSize - 1) /
+              kFloydWarshallBlockSize * kFloydWarshallBlockSize),
+      dist_(stride_ * stride_, std::numeric_limits<double>::infinity()) {
+  for (std::size_t v = 0; v != num_vertices; ++v) {
+    dist_[v * stride_ + v] = 0;
+  }
 }
 
-DistanceMatrix floyd_warshall(Graph* graph) {
+// Relax every distance in block (i_block, j_block) through every vertex in
+// block k_block. The innermost loop is a branch-free elementwise min over
+// contiguous rows, which the compiler vectorizes.
+void floyd_warshall_block(DenseDistanceMatrix* dist, std::size_t k_block,
+                          std::size_t i_block, std::size_t j_block) {
+  const std::size_t b = kFloydWarshallBlockSize, stride = dist->Stride();
+  double* data = dist->Data();
+  for (std::size_t k = k_block * b; k != (k_block + 1) * b; ++k) {
+    const double* row_k = data + k * stride + j_block * b;
+    for (std::size_t i = i_block * b; i != (i_block + 1) * b; ++i) {
+      const double dist_i_k = data[i * stride + k];
+      if (dist_i_k == std::numeric_limits<double>::infinity()) continue;
+      double* row_i = data + i * stride + j_block * b;
+      for (std::size_t j = 0; j != b; ++j) {
+        row_i[j] = std::min(row_i[j], dist_i_k + row_k[j]);
+      }
+    }
+  }
+}
+
+// Same as floyd_warshall_block, for a block outside block row and block column
+// k_block. The blocks it's relaxed through don't change meanwhile, so each row
+// of the block can be relaxed through all of block k_block at once, in a local
+// copy that stays in L1 cache (and that can't alias the rows it's relaxed
+// through, so the compiler needs no runtime overlap checks).
+void floyd_warshall_outer_block(DenseDistanceMatrix* dist, std::size_t k_block,
+                                std::size_t i_block, std::size_t j_block) {
+  const std::size_t b = kFloydWarshallBlockSize, stride = dist->Stride();
+  double* data = dist->Data();
+  double row[kFloydWarshallBlockSize];
+  for (std::size_t i = i_block * b; i != (i_block + 1) * b; ++i) {
+    double* row_i = data + i * stride + j_block * b;
+    std::copy(row_i, row_i + b, row);
+    for (std::size_t k = k_block * b; k != (k_block + 1) * b; ++k) {
+      const double dist_i_k = data[i * stride + k];
+      if (dist_i_k == std::numeric_limits<double>::infinity()) continue;
+      const double* row_k = data + k * stride + j_block * b;
+      for (std::size_t j = 0; j != b; ++j) {
+        row[j] = std::min(row[j], dist_i_k + row_k[j]);
+      }
+    }
+    std::copy(row, row + b, row_i);
+  }
+}
+
+// Blocked Floyd-Warshall. For each block k of intermediate vertices, in order:
+// first the diagonal block (k, k) is relaxed through itself; then the rest of
+// block row k and block column k, which only depend on the diagonal block; and
+// finally every other block (i, j), which only depends on blocks (i, k) and
+// (k, j). Blocks within the last two phases are independent, so each phase is
+// split across threads.
+void floyd_warshall_blocked(DenseDistanceMatrix* dist, unsigned num_threads) {
+  const std::size_t num_blocks = dist->Stride() / kFloydWarshallBlockSize;
+  for (std::size_t k = 0; k != num_blocks; ++k) {
+    floyd_warshall_block(dist, k, k, k);
+
+    parallel_for(0, 2 * num_blocks, num_threads, 1,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t b = begin; b != end; ++b) {
+                     std::size_t other = b / 2;
+                     if (other == k) continue;
+                     if (b % 2) {
+                       floyd_warshall_block(dist, k, k, other);
+                     } else {
+                       floyd_warshall_block(dist, k, other, k);
+                     }
+                   }
+                 });
+
+    parallel_for(0, num_blocks * num_blocks, num_threads, 1,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t b = begin; b != end; ++b) {
+                     std::size_t i = b / num_blocks, j = b % num_blocks;
+                     if (i == k || j == k) continue;
+                     floyd_warshall_outer_block(dist, k, i, j);
+                   }
+                 });
+  }
+}
+
+DenseDistanceMatrix floyd_warshall_dense(const Graph* graph,
+                                         unsigned num_threads) {
+  DenseDistanceMatrix dist(graph->NumVertices());
+  for (const auto& p : graph->GetAdjacencyMap()) {
+    for (const auto& adj : p.second) {
+      if (adj.first != p.first) {
+        dist.Set(p.first->id_, adj.first->id_, adj.second);
+      }
+    }
+  }
+  floyd_warshall_blocked(&dist, num_threads);
+  return dist;
+}
+
+DistanceMatrix to_distance_matrix(const Graph* graph,
+                                  const DenseDistanceMatrix& dense_matrix) {
   DistanceMatrix dist_matrix;
   for (const auto& v1 : graph->GetAdjacencyMap()) {
+    auto& row = dist_matrix[v1.first];
     for (const auto& v2 : graph->GetAdjacencyMap()) {
-      if (v1 == v2) {
-        dist_matrix[v1.first][v2.first] = 0;
-      } else if (graph->EdgeExists(*(v1.first), *(v2.first))) {
-        dist_matrix[v1.first][v2.first] =
-            graph->EdgeWeight(*(v1.first), *(v2.first));
-      } else {
-        dist_matrix[v1.first][v2.first] =
-            std::numeric_limits<double>::infinity();
+      row.emplace(v2.first, dense_matrix.Get(v1.first->id_, v2.first->id_));
+    }
+  }
+  return dist_matrix;
+}
+
+DistanceMatrix floyd_warshall(const Graph* graph) {
+  return to_distance_matrix(graph, floyd_warshall_dense(graph));
+}
+
+// UNTESTED!
+void dag_paths(const CompactGraph* graph, const Vertex* search_root,
+               SearchState* state, const Vertex* destination) {
+  setup_dist_to_root(state, graph->GetVertexId(search_root));
+  std::vector<double>& dist_to_root = state->dist_to_root_;
+
+  std::stack<const Vertex*> s = topological_sort(graph);
+  while (!s.empty()) {
+    const Vertex* v1_ptr = s.top();
+    s.pop();
+
+    if (v1_ptr == destination) return;
+
+    VertexId v1 = graph->GetVertexId(v1_ptr);
+    for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1); ++e) {
+      VertexId v2 = graph->GetTarget(e);
+      double dist_through_v1 = dist_to_root[v1] + graph->GetWeight(e);
+
+      if (dist_to_root[v2] > dist_through_v1) {
+        dist_to_root[v2] = dist_through_v1;
+        state->parent_[v2] = v1;
       }
     }
   }
+}
+
+void bellman_ford(const CompactGraph* graph, const Vertex* search_root,
+                  SearchState* state) {
+  const VertexId root = graph->GetVertexId(search_root);
+  setup_dist_to_root(state, root);
+  std::vector<double>& dist_to_root = state->dist_to_root_;
+
+  std::queue<VertexId> q;
+  std::vector<bool> on_q(graph->NumVertices(), false);
+  q.push(root);
+  on_q[root] = true;
+
+  while (!q.empty()) {
+    VertexId v1 = q.front();
+    q.pop();
+    on_q[v1] = false;
 
-  for (const auto& n : dist_matrix) {
-    const Vertex* k = n.first;
-    for (auto& i : dist_matrix) {
-      const Vertex* v1 = i.first;
-      for (auto& j : i.second) {
-        const Vertex* v2 = j.first;
-        double& known_dist = j.second;
-        double dist_through_k =
-            dist_matrix.at(v1).at(k) + dist_matrix.at(k).at(v2);
+    for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1); ++e) {
+      VertexId v2 = graph->GetTarget(e);
+      double dist_through_v1 = dist_to_root[v1] + graph->GetWeight(e);
 
-        if (dist_through_k < known_dist) {
-          known_dist = dist_through_k;
+      if (dist_to_root[v2] > dist_through_v1) {
+        dist_to_root[v2] = dist_through_v1;
+        state->parent_[v2] = v1;
+
+        if (!on_q[v2]) {
+          q.push(v2);
+          on_q[v2] = true;
         }
       }
     }
   }
+}
+
+std::stack<const Vertex*> shortest_weighted_path(const CompactGraph* graph,
+                                                 const Vertex* search_root,
+                                                 const Vertex* destination) {
+  SearchState state(graph->NumVertices());
+  bellman_ford(graph, search_root, &state);
+  return get_path(graph, state, search_root, destination);
+}
+
+std::vector<PathResult> shortest_pos_weight_paths(
+    const CompactGraph* graph, const std::vector<PathQuery>& queries,
+    unsigned num_threads) {
+  std::vector<std::pair<VertexId, VertexId>> ids;
+  ids.reserve(queries.size());
+  for (const PathQuery& query : queries) {
+    ids.emplace_back(graph->GetVertexId(query.source_),
+                     graph->GetVertexId(query.destination_));
+  }
+  return batch_pos_weight_paths(
+      graph, ids, num_threads, [graph](VertexId v, auto function) {
+        for (std::size_t e = graph->EdgeBegin(v); e != graph->EdgeEnd(v);
+             ++e) {
+          function(graph->GetTarget(e), graph->GetWeight(e));
+        }
+      });
+}
+
+std::vector<PathResult> shortest_pos_weight_paths(
+    const CompactGraph* graph, const Vertex* source,
+    const std::vector<const Vertex*>& destinations, unsigned num_threads) {
+  std::vector<PathQuery> queries;
+  queries.reserve(destinations.size());
+  for (const Vertex* destination : destinations) {
+    queries.push_back({source, destination});
+  }
+  return shortest_pos_weight_paths(graph, queries, num_threads);
+}
 
+DenseDistanceMatrix floyd_warshall_dense(const CompactGraph* graph,
+                                         unsigned num_threads) {
+  DenseDistanceMatrix dist(graph->NumVertices());
+  for (VertexId v1 = 0; v1 != static_cast<VertexId>(graph->NumVertices());
+       ++v1) {
+    for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1); ++e) {
+      if (graph->GetTarget(e) != v1) {
+        dist.Set(v1, graph->GetTarget(e), graph->GetWeight(e));
+      }
+    }
+  }
+  floyd_warshall_blocked(&dist, num_threads);
+  return dist;
+}
+
+DistanceMatrix to_distance_matrix(const CompactGraph* graph,
+                                  const DenseDistanceMatrix& dense_matrix) {
+  DistanceMatrix dist_matrix;
+  const VertexId num_vertices = graph->NumVertices();
+  for (VertexId v1 = 0; v1 != num_vertices; ++v1) {
+    auto& row = dist_matrix[graph->GetVertexPtr(v1)];
+    for (VertexId v2 = 0; v2 != num_vertices; ++v2) {
+      row.emplace(graph->GetVertexPtr(v2), dense_matrix.Get(v1, v2));
+    }
+  }
   return dist_matrix;
 }
 
+DistanceMatrix floyd_warshall(const CompactGraph* graph) {
+  return to_distance_matrix(graph, floyd_warshall_dense(graph));
+}
+
+// A relaxation of the edge (source, target) for delta_stepping, giving target
+// the given distance from the search root unless it already has a shorter one.
+struct DeltaSteppingRequest {
+  VertexId target, source;
+  double dist;
+};
+
+// The state of one delta_stepping thread, which owns the vertices whose
+// VertexIds are congruent to its index, modulo the number of threads. Only the
+// owner of a vertex changes its distance, parent or bucket, so these need no
+// synchronization: other threads send it requests instead.
+struct DeltaSteppingThread {
+  std::vector<std::vector<VertexId>> buckets;  // bucket b at b % buckets.size()
+  std::vector<VertexId> frontier;  // vertices taken out of the current bucket
+  std::vector<VertexId> settled;   // every vertex in the current bucket so far
+  std::vector<std::vector<DeltaSteppingRequest>> outboxes;  // by owner
+  bool has_frontier = false;
+  std::size_t next_bucket = 0;  // lowest nonempty bucket after the current one
+};
+
+const std::size_t kNoDeltaSteppingBucket = static_cast<std::size_t>(-1);
+
+void delta_stepping(const CompactGraph* graph, const Vertex* search_root,
+                    SearchState* state, double delta, unsigned num_threads) {
+  const VertexId root = graph->GetVertexId(search_root);
+  const std::size_t num_vertices = graph->NumVertices();
+  double max_weight = 0;
+  for (double weight : graph->GetWeights()) {
+    if (weight < 0) {
+      throw std::runtime_error("delta_stepping error! Negative edge weight.\n");
+    }
+    max_weight = std::max(max_weight, weight);
+  }
+  if (delta <= 0) {
+    const double average_degree =
+        static_cast<double>(graph->NumEdges()) / num_vertices;
+    delta = max_weight / std::max(1.0, average_degree);
+    if (delta <= 0) delta = 1;  // all weights are 0
+  }
+  if (num_threads == 0) num_threads = default_num_threads();
+  num_threads = std::min<std::size_t>(num_threads, num_vertices);
+
+  // Tentative distances are never more than max_weight past the current
+  // bucket, so bucket numbers in use always fit in a cyclic array this long.
+  const std::size_t num_buckets =
+      static_cast<std::size_t>(max_weight / delta) + 2;
+
+  setup_dist_to_root(state, root);
+  std::vector<double>& dist_to_root = state->dist_to_root_;
+  std::vector<VertexId>& parent = state->parent_;
+  std::fill(parent.begin(), parent.end(), kNoVertex);
+  // Bucket each vertex is waiting in (entries left behind in other buckets
+  // after its distance dropped are skipped), and whether it's in settled.
+  std::vector<std::size_t> bucket_of(num_vertices, kNoDeltaSteppingBucket);
+  std::vector<std::uint8_t> is_settled(num_vertices, 0);
+
+  std::vector<DeltaSteppingThread> threads(num_threads);
+  for (DeltaSteppingThread& thread : threads) {
+    thread.buckets.resize(num_buckets);
+    thread.outboxes.resize(num_threads);
+  }
+  threads[root % num_threads].buckets[0].push_back(root);
+  bucket_of[root] = 0;
+
+  Barrier barrier(num_threads);
+  parallel_for(0, num_threads, num_threads, 1, [&](std::size_t index,
+                                                   std::size_t, unsigned) {
+    DeltaSteppingThread& self = threads[index];
+
+    // Sends requests for the edges out of the given vertices that are light
+    // (or heavy).
+    auto send_requests = [&](const std::vector<VertexId>& vertices,
+                             bool light) {
+      for (VertexId v : vertices) {
+        for (std::size_t e = graph->EdgeBegin(v); e != graph->EdgeEnd(v);
+             ++e) {
+          const double weight = graph->GetWeight(e);
+          if ((weight <= delta) != light) continue;
+          const VertexId target = graph->GetTarget(e);
+          self.outboxes[target % num_threads].push_back(
+              {target, v, dist_to_root[v] + weight});
+        }
+      }
+    };
+    // Applies the requests sent to this thread, moving improved vertices to
+    // the bucket of their new distance.
+    auto apply_requests = [&]() {
+      for (DeltaSteppingThread& sender : threads) {
+        for (const DeltaSteppingRequest& request : sender.outboxes[index]) {
+          if (request.dist >= dist_to_root[request.target]) continue;
+          dist_to_root[request.target] = request.dist;
+          parent[request.target] = request.source;
+          const std::size_t bucket =
+              static_cast<std::size_t>(request.dist / delta);
+          if (bucket_of[request.target] != bucket) {
+            bucket_of[request.target] = bucket;
+            self.buckets[bucket % num_buckets].push_back(request.target);
+          }
+        }
+        sender.outboxes[index].clear();
+      }
+    };
+
+    std::size_t current = 0;
+    while (true) {
+      // Relax light edges until the current bucket stays empty everywhere.
+      while (true) {
+        std::vector<VertexId>& bucket = self.buckets[current % num_buckets];
+        self.frontier.clear();
+        for (VertexId v : bucket) {
+          if (bucket_of[v] != current) continue;
+          bucket_of[v] = kNoDeltaSteppingBucket;
+          self.frontier.push_back(v);
+          if (!is_settled[v]) {
+            is_settled[v] = 1;
+            self.settled.push_back(v);
+          }
+        }
+        bucket.clear();
+        self.has_frontier = !self.frontier.empty();
+        barrier.Wait();
+        bool any_frontier = false;
+        for (const DeltaSteppingThread& thread : threads) {
+          any_frontier = any_frontier || thread.has_frontier;
+        }
+        if (!any_frontier) break;
+        send_requests(self.frontier, true);
+        barrier.Wait();
+        apply_requests();
+      }
+
+      // The distances of the vertices that were in the current bucket are
+      // final now, so each of their heavy edges needs relaxing only once.
+      send_requests(self.settled, false);
+      for (VertexId v : self.settled) is_settled[v] = 0;
+      self.settled.clear();
+      barrier.Wait();
+      apply_requests();
+      self.next_bucket = kNoDeltaSteppingBucket;
+      for (std::size_t b = current + 1; b != current + num_buckets; ++b) {
+        if (!self.buckets[b % num_buckets].empty()) {
+          self.next_bucket = b;
+          break;
+        }
+      }
+      barrier.Wait();
+      current = kNoDeltaSteppingBucket;
+      for (const DeltaSteppingThread& thread : threads) {
+        current = std::min(current, thread.next_bucket);
+      }
+      if (current == kNoDeltaSteppingBucket) break;
+    }
+  });
+}
+
 }  // namespace graphlib
@@ -1,50 +1,554 @@
 #pragma once
 
+#include "graphlib/algo/callbacks.hpp"
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/geometry/graph_2d.hpp"
 #include "graphlib/graph.hpp"
+#include "graphlib/indexed_heap.hpp"
+#include "graphlib/search_state.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <map>
+#include <memory>
 #include <stack>
+#include <vector>
 
 namespace graphlib {
 
 // For algorithms below that take a destination as an argument:
 // If not given a destination, results in a complete shortest-paths tree encoded
-// in each Vertex's parent member. If given a destination, terminates execution
-// once destination is processed.
+// in the parent_ and dist_to_root_ members of the given SearchState. If given a
+// destination, terminates execution once destination is processed.
 
 // Dijkstra's algorithm for single-source shortest non-negative weighted paths.
-void dijkstra(Graph* graph, const Vertex* search_root,
-              const Vertex* destination = nullptr);
+// Arity is that of the IndexedMinHeap holding the vertices to process (see
+// indexed_heap.hpp).
+template <std::size_t Arity = kDefaultHeapArity>
+void dijkstra(const Graph* graph, const Vertex* search_root,
+              SearchState* state, const Vertex* destination = nullptr);
+
+// For the point-to-point searches below, a heuristic is any callable
+// heuristic(v1, v2) taking two const Vertex* and returning a lower bound on the
+// distance from v1 to v2. For example, straight-line distance is one whenever
+// no edge is shorter than the distance between its endpoints (as in a Graph2d;
+// see distance_2d_heuristic). Passing nullptr (the default) uses 0 for every
+// bound.
+
+// A* search: Dijkstra's algorithm, but taking vertices in order of their
+// distance from the search root plus the heuristic's bound on their remaining
+// distance to destination. Vertices leading away from destination are put off,
+// often until the search is over. Finds a shortest path as long as the
+// heuristic never overestimates (is "admissible"). Terminates once destination
+// is processed; results are encoded in the given SearchState as for dijkstra,
+// and each vertex processed ("settled") along the way is marked PROCESSED.
+template <typename Heuristic = std::nullptr_t>
+void astar(const Graph* graph, const Vertex* search_root, SearchState* state,
+           const Vertex* destination, Heuristic heuristic = nullptr);
+
+// Bidirectional search: searches forward from the search root and backward
+// from destination at once, each side in turn processing its closest vertex,
+// until no path through the remaining vertices could beat the best one found
+// across the two. Each side only needs to cover about half the distance. With
+// a heuristic, both sides are A* searches, using the average of the bounds to
+// destination and from the search root (Ikeda et al.) so that both sides agree
+// on which vertices are promising. This requires the heuristic to be
+// "consistent": no edge (v1, v2) may be shorter than heuristic(v1, v) -
+// heuristic(v2, v) or heuristic(v, v2) - heuristic(v, v1), for any v.
+// Straight-line distances are.
+//
+// The shortest path to destination, and the distances along it, are encoded
+// in the given SearchState as for astar; vertices processed by either side are
+// marked PROCESSED. The backward search follows incoming edges. For a directed
+// graph, pass its reverse (see Graph::GetReverseGraph) if it's already at
+// hand; otherwise one is built.
+template <typename Heuristic = std::nullptr_t>
+void bidirectional_astar(const Graph* graph, const Vertex* search_root,
+                         SearchState* state, const Vertex* destination,
+                         Heuristic heuristic = nullptr,
+                         const Graph* reverse_graph = nullptr);
+
+// Graph2d overloads of astar and bidirectional_astar, with straight-line
+// distances (distance_2d_heuristic) as the heuristic.
+void astar(const Graph2d* graph, const Vertex* search_root, SearchState* state,
+           const Vertex* destination);
+void bidirectional_astar(const Graph2d* graph, const Vertex* search_root,
+                         SearchState* state, const Vertex* destination,
+                         const Graph* reverse_graph = nullptr);
 
 // UNTESTED!
 // A faster method for computing single-source shortest paths for edge-weighted
 // DAGs, using a topological sort.
-void dag_paths(Graph* graph, const Vertex* search_root,
-               const Vertex* destination = nullptr);
+void dag_paths(const Graph* graph, const Vertex* search_root,
+               SearchState* state, const Vertex* destination = nullptr);
 
 // Queue-based Bellman-Ford algorithm for single-source shortest weighted paths
 // in a graph without negative cycles.
-void bellman_ford(Graph* graph, const Vertex* search_root);
+void bellman_ford(const Graph* graph, const Vertex* search_root,
+                  SearchState* state);
 
 // Repeatedly pop the stacks returned by these functions to obtain the
-// corresponding paths.
-std::stack<const Vertex*> shortest_pos_weight_path(Graph* graph,
+// corresponding paths. shortest_pos_weight_path runs dijkstra with the given
+// heap Arity.
+template <std::size_t Arity = kDefaultHeapArity>
+std::stack<const Vertex*> shortest_pos_weight_path(const Graph* graph,
                                                    const Vertex* search_root,
                                                    const Vertex* destination);
-std::stack<const Vertex*> shortest_weighted_path(Graph* graph,
+std::stack<const Vertex*> shortest_weighted_path(const Graph* graph,
                                                  const Vertex* search_root,
                                                  const Vertex* destination);
 
+// A query for the shortest path from source_ to destination_.
+struct PathQuery {
+  const Vertex* source_;
+  const Vertex* destination_;
+};
+
+// The answer to a PathQuery: the distance of a shortest path (infinite if there
+// is none), and the path itself, to be popped as for shortest_pos_weight_path
+// (empty if there is none).
+struct PathResult {
+  double distance_ = std::numeric_limits<double>::infinity();
+  std::stack<const Vertex*> path_;
+};
+
+// Batched shortest_pos_weight_path: answers every query at once, with results
+// in the order of the queries. Queries are grouped by source, and each group
+// is answered by a single Dijkstra search, stopped once all the group's
+// destinations are processed. The groups are spread over num_threads threads
+// (one per hardware thread if 0), which share the graph read-only. Each thread
+// reuses one workspace across its searches, resetting only the vertices the
+// previous search reached, so a search far smaller than the graph doesn't pay
+// O(V) to start.
+std::vector<PathResult> shortest_pos_weight_paths(
+    const Graph* graph, const std::vector<PathQuery>& queries,
+    unsigned num_threads = 0);
+
+// Same as above, for the queries from source to each destination, which are
+// answered by one search.
+std::vector<PathResult> shortest_pos_weight_paths(
+    const Graph* graph, const Vertex* source,
+    const std::vector<const Vertex*>& destinations, unsigned num_threads = 0);
+
 // To improve the readability of our Floyd-Warshall output matrix type, we
-// enforce an ordering based on the underlying Vertices stored by the matrix
+// enforce an ordering based on the names of the Vertices stored by the matrix
 // rather than the pointer values themselves. (see graph.hpp)
 using DistanceMatrix =
-    std::map<const Vertex*,
-             std::map<const Vertex*, double, UnderlyingVertexOrder>,
-             UnderlyingVertexOrder>;
+    std::map<const Vertex*, std::map<const Vertex*, double, VertexNameOrder>,
+             VertexNameOrder>;
+
+// Dense, row-major V x V matrix of distances between VertexIds. Rows are padded
+// to a multiple of the block size used by floyd_warshall_dense, so they are
+// Stride() (not NumVertices()) doubles apart.
+class DenseDistanceMatrix {
+ public:
+  // All distances are infinite, except 0 from each vertex to itself.
+  explicit DenseDistanceMatrix(std::size_t num_vertices);
+
+  std::size_t NumVertices() const { return num_vertices_; }
+  std::size_t Stride() const { return stride_; }
+
+  double Get(VertexId from, VertexId to) const {
+    return dist_[from * stride_ + to];
+  }
+  void Set(VertexId from, VertexId to, double dist) {
+    dist_[from * stride_ + to] = dist;
+  }
+
+  double* Data() { return dist_.data(); }
+  const double* Data() const { return dist_.data(); }
+
+ private:
+  std::size_t num_vertices_, stride_;
+  std::vector<double> dist_;
+};
 
 // Floyd-Warshall algorithm for all-pairs distance matrix. Doubles as
-// representation for transitive closure.
-DistanceMatrix floyd_warshall(Graph* graph);
+// representation for transitive closure. The matrix is split into square
+// blocks that fit in cache, and each round of blocks is relaxed by num_threads
+// threads (one per hardware thread if 0).
+DenseDistanceMatrix floyd_warshall_dense(const Graph* graph,
+                                         unsigned num_threads = 0);
+
+// Map-based view of a dense distance matrix, keyed by the graph's Vertices.
+DistanceMatrix to_distance_matrix(const Graph* graph,
+                                  const DenseDistanceMatrix& dense_matrix);
+
+// Same as to_distance_matrix(graph, floyd_warshall_dense(graph)).
+DistanceMatrix floyd_warshall(const Graph* graph);
+
+// CompactGraph overloads of the above.
+template <std::size_t Arity = kDefaultHeapArity>
+void dijkstra(const CompactGraph* graph, const Vertex* search_root,
+              SearchState* state, const Vertex* destination = nullptr);
+template <typename Heuristic = std::nullptr_t>
+void astar(const CompactGraph* graph, const Vertex* search_root,
+           SearchState* state, const Vertex* destination,
+           Heuristic heuristic = nullptr);
+template <typename Heuristic = std::nullptr_t>
+void bidirectional_astar(const CompactGraph* graph, const Vertex* search_root,
+                         SearchState* state, const Vertex* destination,
+                         Heuristic heuristic = nullptr,
+                         const CompactGraph* reverse_graph = nullptr);
+void dag_paths(const CompactGraph* graph, const Vertex* search_root,
+               SearchState* state, const Vertex* destination = nullptr);
+void bellman_ford(const CompactGraph* graph, const Vertex* search_root,
+                  SearchState* state);
+template <std::size_t Arity = kDefaultHeapArity>
+std::stack<const Vertex*> shortest_pos_weight_path(const CompactGraph* graph,
+                                                   const Vertex* search_root,
+                                                   const Vertex* destination);
+std::stack<const Vertex*> shortest_weighted_path(const CompactGraph* graph,
+                                                 const Vertex* search_root,
+                                                 const Vertex* destination);
+std::vector<PathResult> shortest_pos_weight_paths(
+    const CompactGraph* graph, const std::vector<PathQuery>& queries,
+    unsigned num_threads = 0);
+std::vector<PathResult> shortest_pos_weight_paths(
+    const CompactGraph* graph, const Vertex* source,
+    const std::vector<const Vertex*>& destinations, unsigned num_threads = 0);
+DenseDistanceMatrix floyd_warshall_dense(const CompactGraph* graph,
+                                         unsigned num_threads = 0);
+DistanceMatrix to_distance_matrix(const CompactGraph* graph,
+                                  const DenseDistanceMatrix& dense_matrix);
+DistanceMatrix floyd_warshall(const CompactGraph* graph);
+
+// Multithreaded single-source shortest non-negative weighted paths (Meyer and
+// Sanders' "delta-stepping"), giving the same distances as dijkstra, and a
+// shortest paths tree, in the given SearchState (parents of unreached vertices
+// are kNoVertex). Vertices wait in buckets of width delta by distance, and the
+// lowest nonempty bucket is emptied all at once, in parallel: first relaxing
+// the "light" edges (of weight up to delta) out of its vertices, over and over
+// while that refills the bucket, then the "heavy" edges out of every vertex
+// that was in it. A small delta approaches Dijkstra's algorithm (little wasted
+// work, but little parallelism per bucket); a large one approaches
+// Bellman-Ford. If delta is 0, it's the largest edge weight over the average
+// degree, as suggested for random weights. Uses num_threads threads, or one
+// per hardware thread if 0.
+void delta_stepping(const CompactGraph* graph, const Vertex* search_root,
+                    SearchState* state, double delta = 0,
+                    unsigned num_threads = 0);
+
+// Dijkstra's algorithm uses a min-heap to keep track of the next non-tree
+// Vertex closest to the search root. std::priority_queue doesn't work here
+// because we need the ability to lower the "value" (distance to search root) of
+// a Vertex already in the heap. An IndexedMinHeap knows where each VertexId is
+// in the heap, so it supports this in O(log V) time (see indexed_heap.hpp).
+template <std::size_t Arity>
+void dijkstra(const Graph* graph, const Vertex* search_root,
+              SearchState* state, const Vertex* destination) {
+  search_root = graph->GetVertexPtr(*search_root);
+  std::vector<double>& dist_to_root = state->dist_to_root_;
+  std::fill(dist_to_root.begin(), dist_to_root.end(),
+            std::numeric_limits<double>::infinity());
+  dist_to_root[search_root->id_] = 0;
+
+  IndexedMinHeap<Arity> min_heap(graph->NumVertices());
+  min_heap.Push(search_root->id_, 0);
+
+  while (!min_heap.Empty()) {
+    const Vertex* v1 = graph->GetVertexPtr(min_heap.Pop());
+
+    if (v1 == destination) return;
+
+    for (auto& adj : graph->GetAdjacentSet(v1)) {
+      const Vertex* v2 = adj.first;
+      double weight = adj.second;
+
+      if (dist_to_root[v2->id_] > dist_to_root[v1->id_] + weight) {
+        dist_to_root[v2->id_] = dist_to_root[v1->id_] + weight;
+        state->parent_[v2->id_] = v1->id_;
+        min_heap.PushOrDecreaseKey(v2->id_, dist_to_root[v2->id_]);
+      }
+    }
+  }
+}
+
+template <std::size_t Arity>
+void dijkstra(const CompactGraph* graph, const Vertex* search_root,
+              SearchState* state, const Vertex* destination) {
+  const VertexId root = graph->GetVertexId(search_root);
+  std::vector<double>& dist_to_root = state->dist_to_root_;
+  std::fill(dist_to_root.begin(), dist_to_root.end(),
+            std::numeric_limits<double>::infinity());
+  dist_to_root[root] = 0;
+
+  IndexedMinHeap<Arity> min_heap(graph->NumVertices());
+  min_heap.Push(root, 0);
+
+  while (!min_heap.Empty()) {
+    VertexId v1 = min_heap.Pop();
+    const Vertex* v1_ptr = graph->GetVertexPtr(v1);
+    if (v1_ptr == destination) return;
+
+    for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1); ++e) {
+      VertexId v2 = graph->GetTarget(e);
+      double dist_through_v1 = dist_to_root[v1] + graph->GetWeight(e);
+
+      if (dist_to_root[v2] > dist_through_v1) {
+        dist_to_root[v2] = dist_through_v1;
+        state->parent_[v2] = v1;
+        min_heap.PushOrDecreaseKey(v2, dist_through_v1);
+      }
+    }
+  }
+}
+
+template <std::size_t Arity>
+std::stack<const Vertex*> shortest_pos_weight_path(const Graph* graph,
+                                                   const Vertex* search_root,
+                                                   const Vertex* destination) {
+  SearchState state(graph->NumVertices());
+  dijkstra<Arity>(graph, search_root, &state, destination);
+  return get_path(graph, state, search_root, destination);
+}
+
+template <std::size_t Arity>
+std::stack<const Vertex*> shortest_pos_weight_path(const CompactGraph* graph,
+                                                   const Vertex* search_root,
+                                                   const Vertex* destination) {
+  SearchState state(graph->NumVertices());
+  dijkstra<Arity>(graph, search_root, &state, destination);
+  return get_path(graph, state, search_root, destination);
+}
+
+// Implementation of astar over VertexIds, shared by both graph types. Calls
+// for_each_edge(v1, relax) to have relax(v2, weight) called for each edge out
+// of v1, and bound(v) for the heuristic's bound on the distance from v to
+// destination.
+template <typename ForEachEdge, typename Bound>
+void astar_helper(std::size_t num_vertices, VertexId search_root,
+                  VertexId destination, SearchState* state,
+                  ForEachEdge for_each_edge, Bound bound) {
+  std::vector<double>& dist_to_root = state->dist_to_root_;
+  std::fill(dist_to_root.begin(), dist_to_root.end(),
+            std::numeric_limits<double>::infinity());
+  dist_to_root[search_root] = 0;
+
+  // Keyed by distance from the search root plus the bound on what's left.
+  IndexedMinHeap<> min_heap(num_vertices);
+  min_heap.Push(search_root, bound(search_root));
+  state->state_[search_root] = VertexState::DISCOVERED;
+
+  while (!min_heap.Empty()) {
+    VertexId v1 = min_heap.Pop();
+    state->state_[v1] = VertexState::PROCESSED;
+    if (v1 == destination) return;
+
+    for_each_edge(v1, [&](VertexId v2, double weight) {
+      if (dist_to_root[v2] > dist_to_root[v1] + weight) {
+        dist_to_root[v2] = dist_to_root[v1] + weight;
+        state->parent_[v2] = v1;
+        state->state_[v2] = VertexState::DISCOVERED;
+        min_heap.PushOrDecreaseKey(v2, dist_to_root[v2] + bound(v2));
+      }
+    });
+  }
+}
+
+// Implementation of bidirectional_astar over VertexIds, shared by both graph
+// types. for_each_out_edge and for_each_in_edge are called like for_each_edge
+// in astar_helper; potential(v) is half of the bound on the distance from v to
+// destination minus half of the bound on the distance from the search root to
+// v.
+template <typename ForEachOutEdge, typename ForEachInEdge, typename Potential>
+void bidirectional_astar_helper(std::size_t num_vertices, VertexId search_root,
+                                VertexId destination, SearchState* state,
+                                ForEachOutEdge for_each_out_edge,
+                                ForEachInEdge for_each_in_edge,
+                                Potential potential) {
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  std::vector<double>& dist_to_root = state->dist_to_root_;
+  std::fill(dist_to_root.begin(), dist_to_root.end(), kInfinity);
+  dist_to_root[search_root] = 0;
+  state->state_[search_root] = VertexState::DISCOVERED;
+  if (search_root == destination) {
+    state->state_[search_root] = VertexState::PROCESSED;
+    return;
+  }
+
+  // The backward search's counterparts of dist_to_root and parent_.
+  std::vector<double> dist_to_destination(num_vertices, kInfinity);
+  std::vector<VertexId> next(num_vertices, kNoVertex);
+  dist_to_destination[destination] = 0;
+
+  IndexedMinHeap<> forward_heap(num_vertices), backward_heap(num_vertices);
+  forward_heap.Push(search_root, potential(search_root));
+  backward_heap.Push(destination, -potential(destination));
+
+  // The shortest path found so far crosses over from the forward search tree
+  // to the backward one along the edge (meet_from, meet_to).
+  double shortest = kInfinity;
+  VertexId meet_from = kNoVertex, meet_to = kNoVertex;
+
+  // With the potentials, the sum of the two smallest keys is a lower bound on
+  // the length of any path through unprocessed vertices.
+  while (!forward_heap.Empty() && !backward_heap.Empty() &&
+         forward_heap.TopKey() + backward_heap.TopKey() < shortest) {
+    if (forward_heap.TopKey() <= backward_heap.TopKey()) {
+      VertexId v1 = forward_heap.Pop();
+      state->state_[v1] = VertexState::PROCESSED;
+      for_each_out_edge(v1, [&](VertexId v2, double weight) {
+        double dist = dist_to_root[v1] + weight;
+        if (dist_to_root[v2] > dist) {
+          dist_to_root[v2] = dist;
+          state->parent_[v2] = v1;
+          forward_heap.PushOrDecreaseKey(v2, dist + potential(v2));
+        }
+        if (dist + dist_to_destination[v2] < shortest) {
+          shortest = dist + dist_to_destination[v2];
+          meet_from = v1;
+          meet_to = v2;
+        }
+      });
+    } else {
+      VertexId v1 = backward_heap.Pop();
+      state->state_[v1] = VertexState::PROCESSED;
+      for_each_in_edge(v1, [&](VertexId v2, double weight) {
+        double dist = dist_to_destination[v1] + weight;
+        if (dist_to_destination[v2] > dist) {
+          dist_to_destination[v2] = dist;
+          next[v2] = v1;
+          backward_heap.PushOrDecreaseKey(v2, dist - potential(v2));
+        }
+        if (dist + dist_to_root[v2] < shortest) {
+          shortest = dist + dist_to_root[v2];
+          meet_from = v2;
+          meet_to = v1;
+        }
+      });
+    }
+  }
+  if (meet_from == kNoVertex) return;
+
+  // Splice the backward search's path from meet_to into the search tree.
+  state->parent_[meet_to] = meet_from;
+  for (VertexId v = meet_to;; v = next[v]) {
+    dist_to_root[v] = shortest - dist_to_destination[v];
+    if (v == destination) break;
+    state->parent_[next[v]] = v;
+  }
+}
+
+template <typename Heuristic>
+void astar(const Graph* graph, const Vertex* search_root, SearchState* state,
+           const Vertex* destination, Heuristic heuristic) {
+  search_root = graph->GetVertexPtr(*search_root);
+  destination = graph->GetVertexPtr(*destination);
+  astar_helper(
+      graph->NumVertices(), search_root->id_, destination->id_, state,
+      [graph](VertexId v1, auto&& relax) {
+        for (auto& adj : graph->GetAdjacentSet(graph->GetVertexPtr(v1))) {
+          relax(adj.first->id_, adj.second);
+        }
+      },
+      [&](VertexId v) -> double {
+        if constexpr (kIsNoCallback<Heuristic>) {
+          return 0;
+        } else {
+          return heuristic(graph->GetVertexPtr(v), destination);
+        }
+      });
+}
+
+template <typename Heuristic>
+void bidirectional_astar(const Graph* graph, const Vertex* search_root,
+                         SearchState* state, const Vertex* destination,
+                         Heuristic heuristic, const Graph* reverse_graph) {
+  search_root = graph->GetVertexPtr(*search_root);
+  destination = graph->GetVertexPtr(*destination);
+  std::unique_ptr<Graph> built_reverse_graph;
+  const Graph* in_graph = graph;
+  if (graph->IsDirected()) {
+    if (!reverse_graph) {
+      built_reverse_graph = graph->GetReverseGraph();
+      reverse_graph = built_reverse_graph.get();
+    }
+    in_graph = reverse_graph;
+  }
+
+  auto for_each_edge_of = [](const Graph* g) {
+    return [g](VertexId v1, auto&& relax) {
+      for (auto& adj : g->GetAdjacentSet(g->GetVertexPtr(v1))) {
+        relax(adj.first->id_, adj.second);
+      }
+    };
+  };
+  bidirectional_astar_helper(
+      graph->NumVertices(), search_root->id_, destination->id_, state,
+      for_each_edge_of(graph), for_each_edge_of(in_graph),
+      [&](VertexId v) -> double {
+        if constexpr (kIsNoCallback<Heuristic>) {
+          return 0;
+        } else {
+          const Vertex* u = graph->GetVertexPtr(v);
+          return (heuristic(u, destination) - heuristic(search_root, u)) / 2;
+        }
+      });
+}
+
+template <typename Heuristic>
+void astar(const CompactGraph* graph, const Vertex* search_root,
+           SearchState* state, const Vertex* destination,
+           Heuristic heuristic) {
+  const VertexId root = graph->GetVertexId(search_root);
+  const VertexId target = graph->GetVertexId(destination);
+  destination = graph->GetVertexPtr(target);
+  astar_helper(
+      graph->NumVertices(), root, target, state,
+      [graph](VertexId v1, auto&& relax) {
+        for (std::size_t e = graph->EdgeBegin(v1); e != graph->EdgeEnd(v1);
+             ++e) {
+          relax(graph->GetTarget(e), graph->GetWeight(e));
+        }
+      },
+      [&](VertexId v) -> double {
+        if constexpr (kIsNoCallback<Heuristic>) {
+          return 0;
+        } else {
+          return heuristic(graph->GetVertexPtr(v), destination);
+        }
+      });
+}
+
+template <typename Heuristic>
+void bidirectional_astar(const CompactGraph* graph, const Vertex* search_root,
+                         SearchState* state, const Vertex* destination,
+                         Heuristic heuristic,
+                         const CompactGraph* reverse_graph) {
+  const VertexId root = graph->GetVertexId(search_root);
+  const VertexId target = graph->GetVertexId(destination);
+  search_root = graph->GetVertexPtr(root);
+  destination = graph->GetVertexPtr(target);
+  std::unique_ptr<CompactGraph> built_reverse_graph;
+  const CompactGraph* in_graph = graph;
+  if (graph->IsDirected()) {
+    if (!reverse_graph) {
+      built_reverse_graph =
+          std::make_unique<CompactGraph>(graph->GetReverseGraph());
+      reverse_graph = built_reverse_graph.get();
+    }
+    in_graph = reverse_graph;
+  }
+
+  auto for_each_edge_of = [](const CompactGraph* g) {
+    return [g](VertexId v1, auto&& relax) {
+      for (std::size_t e = g->EdgeBegin(v1); e != g->EdgeEnd(v1); ++e) {
+        relax(g->GetTarget(e), g->GetWeight(e));
+      }
+    };
+  };
+  bidirectional_astar_helper(
+      graph->NumVertices(), root, target, state, for_each_edge_of(graph),
+      for_each_edge_of(in_graph), [&](VertexId v) -> double {
+        if constexpr (kIsNoCallback<Heuristic>) {
+          return 0;
+        } else {
+          const Vertex* u = graph->GetVertexPtr(v);
+          return (heuristic(u, destination) - heuristic(search_root, u)) / 2;
+        }
+      });
+}
 
 }  // namespace graphlib
@@ -0,0 +1,137 @@
+#include "graphlib/compact_graph.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "graphlib/geometry/graph_2d.hpp"
+#include "graphlib/graph_file.hpp"
+
+namespace graphlib {
+
+CompactGraph::CompactGraph(const Graph& graph)
+    : is_directed_(graph.IsDirected()) {
+  const std::size_t num_vertices = graph.NumVertices();
+
+  // First pass sizes the edge arrays.
+  std::size_t num_edges = 0;
+  vertices_.reserve(num_vertices);
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices); ++v) {
+    vertices_.push_back(graph.GetVertexPtr(v));
+    num_edges += graph.GetAdjacentSet(vertices_.back()).size();
+  }
+
+  // Second pass fills in the CSR arrays.
+  auto arrays = std::make_shared<Arrays>();
+  arrays->offsets.reserve(num_vertices + 1);
+  arrays->targets.reserve(num_edges);
+  arrays->weights.reserve(num_edges);
+  arrays->offsets.push_back(0);
+  for (const Vertex* v : vertices_) {
+    for (const auto& adj : graph.GetAdjacentSet(v)) {
+      arrays->targets.push_back(adj.first->id_);
+      arrays->weights.push_back(adj.second);
+    }
+    arrays->offsets.push_back(arrays->targets.size());
+  }
+  SetArrays(std::move(arrays));
+}
+
+// The mapping stores offsets as uint64s, which are viewed in place.
+static_assert(std::is_same<std::size_t, std::uint64_t>::value,
+              "CompactGraph views mapped offsets as std::size_t");
+
+CompactGraph::CompactGraph(const MappedGraph& graph)
+    : offsets_(graph.offsets_),
+      targets_(graph.targets_),
+      weights_(graph.weights_),
+      num_edges_(graph.NumEdges()),
+      is_directed_(graph.IsDirected()) {
+  graph.Validate();
+  const std::size_t num_vertices = graph.NumVertices();
+  auto owned_vertices =
+      std::make_shared<std::vector<std::unique_ptr<Vertex>>>();
+  owned_vertices->reserve(num_vertices);
+  vertices_.reserve(num_vertices);
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices); ++v) {
+    if (graph.HasCoordinates()) {
+      owned_vertices->push_back(
+          std::make_unique<Vertex2d>(graph.GetX(v), graph.GetY(v)));
+    } else {
+      owned_vertices->push_back(
+          std::make_unique<Vertex>(std::string(graph.GetName(v))));
+    }
+    owned_vertices->back()->id_ = v;
+    vertices_.push_back(owned_vertices->back().get());
+  }
+  owned_vertices_ = std::move(owned_vertices);
+}
+
+void CompactGraph::SetArrays(std::shared_ptr<const Arrays> arrays) {
+  offsets_ = arrays->offsets.data();
+  targets_ = arrays->targets.data();
+  weights_ = arrays->weights.data();
+  num_edges_ = arrays->targets.size();
+  arrays_ = std::move(arrays);
+}
+
+VertexId CompactGraph::GetVertexId(const Vertex* v) const {
+  if (!v || v->id_ < 0 || v->id_ >= static_cast<VertexId>(vertices_.size()) ||
+      vertices_[v->id_] != v) {
+    throw std::runtime_error(
+        "CompactGraph::GetVertexId error! Tried to obtain id of vertex not "
+        "present in snapshot (" +
+        (v ? v->name_ : std::string("null")) + ")\n");
+  }
+  return v->id_;
+}
+
+CompactGraph CompactGraph::GetReverseGraph() const {
+  CompactGraph reverse;
+  reverse.vertices_ = vertices_;
+  reverse.owned_vertices_ = owned_vertices_;
+  reverse.is_directed_ = true;
+
+  // Counting sort of the edges by target. Iterating sources in increasing id
+  // order keeps each reversed adjacency list sorted by id.
+  const std::size_t num_vertices = NumVertices();
+  auto arrays = std::make_shared<Arrays>();
+  arrays->offsets.assign(num_vertices + 1, 0);
+  for (VertexId target : GetTargets()) {
+    ++arrays->offsets[target + 1];
+  }
+  for (std::size_t v = 0; v != num_vertices; ++v) {
+    arrays->offsets[v + 1] += arrays->offsets[v];
+  }
+
+  arrays->targets.resize(NumEdges());
+  arrays->weights.resize(NumEdges());
+  std::vector<std::size_t> cursor(arrays->offsets.begin(),
+                                  arrays->offsets.end() - 1);
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices); ++v) {
+    for (std::size_t e = EdgeBegin(v); e != EdgeEnd(v); ++e) {
+      std::size_t pos = cursor[targets_[e]]++;
+      arrays->targets[pos] = v;
+      arrays->weights[pos] = weights_[e];
+    }
+  }
+  reverse.SetArrays(std::move(arrays));
+  return reverse;
+}
+
+std::string to_string(const CompactGraph& graph) {
+  std::string s("Adjacency lists:\n");
+  for (VertexId v = 0; v != static_cast<VertexId>(graph.NumVertices()); ++v) {
+    s += graph.GetVertexPtr(v)->name_ + " -> ";
+    for (std::size_t e = graph.EdgeBegin(v); e != graph.EdgeEnd(v); ++e) {
+      s += graph.GetVertexPtr(graph.GetTarget(e))->name_ +
+           "(wgt=" + std::to_string(graph.GetWeight(e)) + ") | ";
+    }
+    s += '\n';
+  }
+  s += '\n';
+  return s;
+}
+
+}  // namespace graphlib
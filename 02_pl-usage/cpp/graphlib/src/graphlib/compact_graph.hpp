@@ -0,0 +1,145 @@
+/*
+The "CompactGraph" class is an immutable, compressed sparse row (CSR) snapshot
+of a Graph. It exists purely for performance: the AdjacencyMap representation
+used by Graph (see graph.hpp) is flexible, but every neighbor hop is a pointer
+chase through red-black tree nodes. A CompactGraph stores the same edges in
+three contiguous arrays instead.
+
+A CompactGraph uses the same dense VertexIds as its source Graph (see
+graph.hpp), so a SearchState can be used interchangeably with either. The
+outgoing edges of the Vertex with id v occupy the half-open index range
+[offsets[v], offsets[v + 1]) of the "targets" and "weights" arrays.
+
+Using the example at the top of graph.hpp (undirected, unit weights), with the
+vertices added to the Graph in alphabetical order:
+
+      ids:      A=0 B=1 C=2 D=3 E=4
+      offsets:  {0, 2, 2, 3, 5, 8}
+      targets:  {3, 4, 4, 0, 4, 0, 2, 3}
+      weights:  {1, 1, 1, 1, 1, 1, 1, 1}
+
+A CompactGraph refers to the Vertex instances owned by its source Graph, so the
+source Graph must outlive it. Changes made to the source Graph after the
+snapshot is taken are not reflected in the snapshot.
+
+A CompactGraph can also be made from a MappedGraph (see graph_file.hpp), after
+reloading a graph file. It then reads the CSR arrays straight from the file
+mapping, without copying them, so the MappedGraph must outlive it; only the
+Vertex instances (which the file doesn't hold) are created, one per vertex.
+Since a CompactGraph never changes, copies share their arrays and Vertices.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+class MappedGraph;
+
+// Read-only view of one of the CSR arrays of a CompactGraph.
+template <typename T>
+class ArrayView {
+ public:
+  ArrayView(const T* data, std::size_t size) : data_(data), size_(size) {}
+
+  const T* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+  const T& operator[](std::size_t i) const { return data_[i]; }
+
+ private:
+  const T* data_;
+  std::size_t size_;
+};
+
+template <typename T>
+bool operator==(const ArrayView<T>& lhs, const ArrayView<T>& rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+class CompactGraph {
+ public:
+  // Takes a CSR snapshot of the given Graph.
+  explicit CompactGraph(const Graph& graph);
+
+  // Views the CSR arrays of the given MappedGraph, which must outlive this
+  // CompactGraph, after checking them (see MappedGraph::Validate). Vertices
+  // are created with the names in the file (as Vertex2d instances if the file
+  // has coordinates), and get their ids from it.
+  explicit CompactGraph(const MappedGraph& graph);
+
+  std::size_t NumVertices() const { return vertices_.size(); }
+  std::size_t NumEdges() const { return num_edges_; }
+
+  bool IsDirected() const { return is_directed_; }
+
+  // Mapping between dense ids and the Vertex instances of the source Graph.
+  const Vertex* GetVertexPtr(VertexId id) const { return vertices_[id]; }
+  VertexId GetVertexId(const Vertex* v) const;
+
+  // Outgoing edges of a vertex are the edge indices in [EdgeBegin, EdgeEnd).
+  std::size_t EdgeBegin(VertexId v) const { return offsets_[v]; }
+  std::size_t EdgeEnd(VertexId v) const { return offsets_[v + 1]; }
+  std::size_t Degree(VertexId v) const { return offsets_[v + 1] - offsets_[v]; }
+
+  VertexId GetTarget(std::size_t edge) const { return targets_[edge]; }
+  double GetWeight(std::size_t edge) const { return weights_[edge]; }
+
+  // Factory for a reversed (transposed) copy of this snapshot. VertexIds are
+  // preserved. As with Graph::GetReverseGraph, the result is directed.
+  CompactGraph GetReverseGraph() const;
+
+  // Raw CSR arrays.
+  ArrayView<std::size_t> GetOffsets() const {
+    return ArrayView<std::size_t>(offsets_, vertices_.size() + 1);
+  }
+  ArrayView<VertexId> GetTargets() const {
+    return ArrayView<VertexId>(targets_, num_edges_);
+  }
+  ArrayView<double> GetWeights() const {
+    return ArrayView<double>(weights_, num_edges_);
+  }
+
+ private:
+  // Fills in the CSR arrays directly (see graph_builder.hpp).
+  friend class GraphBuilder;
+
+  // CSR arrays built by a CompactGraph (rather than borrowed from a mapping).
+  struct Arrays {
+    std::vector<std::size_t> offsets;  // size V + 1
+    std::vector<VertexId> targets;     // size E
+    std::vector<double> weights;       // size E
+  };
+
+  CompactGraph() = default;
+
+  // Points the views below at the given arrays, and shares their ownership.
+  void SetArrays(std::shared_ptr<const Arrays> arrays);
+
+  const std::size_t* offsets_ = nullptr;  // size V + 1
+  const VertexId* targets_ = nullptr;     // size E
+  const double* weights_ = nullptr;       // size E
+  std::size_t num_edges_ = 0;
+  std::shared_ptr<const Arrays> arrays_;  // null if borrowed from a mapping
+
+  std::vector<const Vertex*> vertices_;  // id -> Vertex
+
+  // Vertices created for a snapshot of a MappedGraph.
+  std::shared_ptr<const std::vector<std::unique_ptr<Vertex>>> owned_vertices_;
+
+  bool is_directed_ = true;
+};
+
+// For a given snapshot, return a string displaying all vertices and
+// corresponding adjacency lists. Output matches to_string(const Graph&).
+std::string to_string(const CompactGraph& graph);
+
+}  // namespace graphlib
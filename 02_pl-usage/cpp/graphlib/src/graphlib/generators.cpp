@@ -0,0 +1,148 @@
+#include "graphlib/generators.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "graphlib/graph_builder.hpp"
+
+namespace graphlib {
+
+// Edge weights in (0, 1].
+double random_edge_weight(std::mt19937_64* rng) {
+  return 1 - std::uniform_real_distribution<double>(0, 1)(*rng);
+}
+
+std::unique_ptr<Graph> erdos_renyi_graph(std::size_t num_vertices,
+                                         std::size_t num_edges,
+                                         bool is_directed, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<std::size_t> vertex_distribution(
+      0, num_vertices - 1);
+
+  GraphBuilder builder(is_directed);
+  for (std::size_t v = 0; v != num_vertices; ++v) {
+    builder.AddVertex(std::to_string(v));
+  }
+  for (std::size_t i = 0; i != num_edges && num_vertices > 1; ++i) {
+    std::size_t v1 = vertex_distribution(rng), v2;
+    do {
+      v2 = vertex_distribution(rng);
+    } while (v1 == v2);
+    builder.AddEdge(std::to_string(v1), std::to_string(v2),
+                    random_edge_weight(&rng));
+  }
+  return builder.Build();
+}
+
+std::unique_ptr<Graph> rmat_graph(unsigned scale, std::size_t edge_factor,
+                                  bool is_directed, unsigned seed) {
+  const double a = 0.57, b = 0.19, c = 0.19;
+  const std::size_t num_vertices = std::size_t(1) << scale;
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> quadrant_distribution(0, 1);
+
+  GraphBuilder builder(is_directed);
+  for (std::size_t v = 0; v != num_vertices; ++v) {
+    builder.AddVertex(std::to_string(v));
+  }
+  for (std::size_t i = 0; i != edge_factor * num_vertices; ++i) {
+    // Descend one level of the adjacency matrix per bit of the vertex ids,
+    // picking one of the four quadrants each time.
+    std::size_t v1 = 0, v2 = 0;
+    for (unsigned bit = 0; bit != scale; ++bit) {
+      double p = quadrant_distribution(rng);
+      v1 = (v1 << 1) | (p >= a + b);
+      v2 = (v2 << 1) | ((p >= a && p < a + b) || p >= a + b + c);
+    }
+    if (v1 == v2) continue;
+    builder.AddEdge(std::to_string(v1), std::to_string(v2),
+                    random_edge_weight(&rng));
+  }
+  return builder.Build();
+}
+
+std::unique_ptr<Graph> grid_graph(std::size_t rows, std::size_t cols,
+                                  unsigned seed) {
+  std::mt19937_64 rng(seed);
+  GraphBuilder builder(false);
+  for (std::size_t v = 0; v != rows * cols; ++v) {
+    builder.AddVertex(std::to_string(v));
+  }
+  for (std::size_t r = 0; r != rows; ++r) {
+    for (std::size_t c = 0; c != cols; ++c) {
+      std::string v = std::to_string(r * cols + c);
+      if (c + 1 != cols) {
+        builder.AddEdge(v, std::to_string(r * cols + c + 1),
+                        random_edge_weight(&rng));
+      }
+      if (r + 1 != rows) {
+        builder.AddEdge(v, std::to_string((r + 1) * cols + c),
+                        random_edge_weight(&rng));
+      }
+    }
+  }
+  return builder.Build();
+}
+
+std::unique_ptr<Graph2d> random_geometric_graph(std::size_t num_vertices,
+                                                double radius, unsigned seed) {
+  if (!std::isfinite(radius) || radius <= 0) {
+    throw std::runtime_error(
+        "random_geometric_graph error! Radius must be finite and positive.\n");
+  }
+  const double side = std::sqrt(static_cast<double>(num_vertices));
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> coordinate_distribution(0, side);
+
+  std::unique_ptr<Graph2d> graph = std::make_unique<Graph2d>(false);
+  std::vector<Vertex2d> points;
+  points.reserve(num_vertices);
+  for (std::size_t i = 0; i != num_vertices; ++i) {
+    double x = coordinate_distribution(rng);
+    double y = coordinate_distribution(rng);
+    points.emplace_back(x, y);
+  }
+  graph->AddVertices(points);
+
+  // Bucket points into square cells of side at least radius, so that only
+  // points in neighboring cells need to be compared. No more than about one
+  // cell per point, however small the radius.
+  const std::size_t cells_per_side = std::max<std::size_t>(
+      1, static_cast<std::size_t>(std::min(side / radius, std::ceil(side))));
+  const double cell_size = side / cells_per_side;
+  auto cell_of = [&](double coordinate) {
+    return std::min(cells_per_side - 1,
+                    static_cast<std::size_t>(coordinate / cell_size));
+  };
+  std::vector<std::vector<std::size_t>> cells(cells_per_side * cells_per_side);
+  for (std::size_t i = 0; i != num_vertices; ++i) {
+    cells[cell_of(points[i].y_) * cells_per_side + cell_of(points[i].x_)]
+        .push_back(i);
+  }
+
+  for (std::size_t i = 0; i != num_vertices; ++i) {
+    const std::size_t row = cell_of(points[i].y_), col = cell_of(points[i].x_);
+    for (std::size_t r = row ? row - 1 : 0;
+         r <= std::min(row + 1, cells_per_side - 1); ++r) {
+      for (std::size_t c = col ? col - 1 : 0;
+           c <= std::min(col + 1, cells_per_side - 1); ++c) {
+        for (std::size_t j : cells[r * cells_per_side + c]) {
+          if (j > i && distance_2d(points[i], points[j]) <= radius) {
+            graph->AddEdge(points[i], points[j]);
+          }
+        }
+      }
+    }
+  }
+  return graph;
+}
+
+double random_geometric_radius(double average_degree) {
+  return std::sqrt(average_degree / std::acos(-1.0));
+}
+
+}  // namespace graphlib
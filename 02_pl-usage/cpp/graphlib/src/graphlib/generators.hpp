@@ -0,0 +1,47 @@
+// Synthetic graph generators, for benchmarks and for testing algorithms at
+// scale. All generators are deterministic for a given seed. Vertex names are
+// the decimal vertex ids (except for Graph2d, whose names are coordinates), and
+// edge weights are drawn uniformly from (0, 1] unless stated otherwise.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "graphlib/geometry/graph_2d.hpp"
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+// Erdős–Rényi G(n, m) graph: num_edges edges with endpoints chosen uniformly
+// at random. Self-loops are redrawn; duplicate edges are dropped, so the result
+// may have slightly fewer than num_edges edges.
+std::unique_ptr<Graph> erdos_renyi_graph(std::size_t num_vertices,
+                                         std::size_t num_edges,
+                                         bool is_directed, unsigned seed);
+
+// R-MAT (recursive matrix) graph with 2^scale vertices and
+// edge_factor * 2^scale edges, using the Graph500 quadrant probabilities
+// (a, b, c, d) = (0.57, 0.19, 0.19, 0.05). Produces a skewed, power-law-like
+// degree distribution. Self-loops and duplicate edges are dropped.
+std::unique_ptr<Graph> rmat_graph(unsigned scale, std::size_t edge_factor,
+                                  bool is_directed, unsigned seed);
+
+// Undirected rows x cols 2d grid (4-neighborhood lattice), with random weights.
+std::unique_ptr<Graph> grid_graph(std::size_t rows, std::size_t cols,
+                                  unsigned seed);
+
+// Undirected random geometric graph: num_vertices points uniform in a square of
+// side sqrt(num_vertices) (i.e. one point per unit area on average), with an
+// edge between every pair of points at most radius apart. Edge weights are
+// Euclidean distances, as with any Graph2d. Throws if radius isn't finite and
+// positive.
+std::unique_ptr<Graph2d> random_geometric_graph(std::size_t num_vertices,
+                                                double radius, unsigned seed);
+
+// Radius for which random_geometric_graph gives an expected average degree of
+// average_degree (ignoring points near the sides of the square): a disk of that
+// radius has an area of average_degree.
+double random_geometric_radius(double average_degree);
+
+}  // namespace graphlib
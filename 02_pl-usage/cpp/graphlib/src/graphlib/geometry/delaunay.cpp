@@ -0,0 +1,336 @@
+#include "graphlib/geometry/delaunay.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+namespace graphlib {
+
+const std::size_t kNoPoint = static_cast<std::size_t>(-1);
+
+// Whether the points p, q, r make a counterclockwise turn.
+bool delaunay_orient(double px, double py, double qx, double qy, double rx,
+                     double ry) {
+  return (qy - py) * (rx - qx) - (qx - px) * (ry - qy) < 0;
+}
+
+// Whether point p lies inside the circumcircle of the triangle a, b, c.
+bool delaunay_in_circle(double ax, double ay, double bx, double by, double cx,
+                        double cy, double px, double py) {
+  const double dx = ax - px, dy = ay - py;
+  const double ex = bx - px, ey = by - py;
+  const double fx = cx - px, fy = cy - py;
+  const double ap = dx * dx + dy * dy;
+  const double bp = ex * ex + ey * ey;
+  const double cp = fx * fx + fy * fy;
+  return dx * (ey * cp - bp * fy) - dy * (ex * cp - bp * fx) +
+             ap * (ex * fy - ey * fx) <
+         0;
+}
+
+// Offset from a to the circumcenter of the triangle a, b, c (infinite or NaN
+// if they're collinear).
+std::pair<double, double> delaunay_circumcenter_offset(double ax, double ay,
+                                                       double bx, double by,
+                                                       double cx, double cy) {
+  const double dx = bx - ax, dy = by - ay;
+  const double ex = cx - ax, ey = cy - ay;
+  const double bl = dx * dx + dy * dy;
+  const double cl = ex * ex + ey * ey;
+  const double d = 0.5 / (dx * ey - dy * ex);
+  return {(ey * bl - dy * cl) * d, (dx * cl - ex * bl) * d};
+}
+
+// Monotonic in the angle of (dx, dy), in [0, 1], without any trigonometry.
+double delaunay_pseudo_angle(double dx, double dy) {
+  const double p = dx / (std::abs(dx) + std::abs(dy));
+  return (dy > 0 ? 3 - p : 1 + p) / 4;
+}
+
+// State of the sweep, over the points' coordinates.
+class DelaunaySweep {
+ public:
+  explicit DelaunaySweep(const std::vector<const Vertex2d*>& points)
+      : num_points_(points.size()),
+        x_(num_points_),
+        y_(num_points_),
+        hull_prev_(num_points_),
+        hull_next_(num_points_),
+        hull_tri_(num_points_),
+        hash_size_(static_cast<std::size_t>(
+            std::ceil(std::sqrt(static_cast<double>(num_points_))))),
+        hull_hash_(hash_size_, kNoPoint) {
+    for (std::size_t i = 0; i != num_points_; ++i) {
+      x_[i] = points[i]->x_;
+      y_[i] = points[i]->y_;
+    }
+  }
+
+  DelaunayTriangulation Run();
+
+ private:
+  // Bucket of the hull hash for the given point.
+  std::size_t HashKey(double x, double y) const {
+    const double dx = x - center_x_, dy = y - center_y_;
+    if (dx == 0 && dy == 0) return 0;
+    return static_cast<std::size_t>(
+               std::floor(delaunay_pseudo_angle(dx, dy) * hash_size_)) %
+           hash_size_;
+  }
+
+  // Makes half-edges a and b opposites of each other.
+  void Link(std::size_t a, std::size_t b) {
+    result_.halfedges_[a] = b;
+    if (b != kNoHalfEdge) result_.halfedges_[b] = a;
+  }
+
+  // Adds the triangle i0, i1, i2, whose half-edges have the given opposites.
+  // Returns its first half-edge.
+  std::size_t AddTriangle(std::size_t i0, std::size_t i1, std::size_t i2,
+                          std::size_t a, std::size_t b, std::size_t c) {
+    const std::size_t t = result_.triangles_.size();
+    result_.triangles_.insert(result_.triangles_.end(), {i0, i1, i2});
+    result_.halfedges_.resize(t + 3);
+    Link(t, a);
+    Link(t + 1, b);
+    Link(t + 2, c);
+    return t;
+  }
+
+  std::size_t Legalize(std::size_t a);
+
+  const std::size_t num_points_;
+  std::vector<double> x_, y_;
+
+  // The convex hull so far, as a circular list of points. Each hull point
+  // also keeps the half-edge of the hull edge that starts at it.
+  std::vector<std::size_t> hull_prev_, hull_next_, hull_tri_;
+  std::size_t hull_start_ = 0;
+  const std::size_t hash_size_;
+  std::vector<std::size_t> hull_hash_;  // hull points by angle, or kNoPoint
+  double center_x_ = 0, center_y_ = 0;
+
+  std::vector<std::size_t> edge_stack_;  // for Legalize
+  DelaunayTriangulation result_;
+};
+
+// Restores the Delaunay condition across half-edge a, flipping it if the point
+// across it lies in the circumcircle of its triangle, and then checking the
+// edges the flip exposed in turn. Returns the half-edge that ends up in a's
+// triangle, opposite the point a was added from.
+std::size_t DelaunaySweep::Legalize(std::size_t a) {
+  std::vector<std::size_t>& triangles = result_.triangles_;
+  std::vector<std::size_t>& halfedges = result_.halfedges_;
+  std::size_t ar = 0;
+  edge_stack_.clear();
+  while (true) {
+    const std::size_t b = halfedges[a];
+    const std::size_t a0 = a - a % 3;
+    ar = a0 + (a + 2) % 3;
+    if (b == kNoHalfEdge) {  // on the convex hull
+      if (edge_stack_.empty()) break;
+      a = edge_stack_.back();
+      edge_stack_.pop_back();
+      continue;
+    }
+
+    const std::size_t b0 = b - b % 3;
+    const std::size_t al = a0 + (a + 1) % 3;
+    const std::size_t bl = b0 + (b + 2) % 3;
+    const std::size_t p0 = triangles[ar];
+    const std::size_t pr = triangles[a];
+    const std::size_t pl = triangles[al];
+    const std::size_t p1 = triangles[bl];
+    if (delaunay_in_circle(x_[p0], y_[p0], x_[pr], y_[pr], x_[pl], y_[pl],
+                           x_[p1], y_[p1])) {
+      triangles[a] = p1;
+      triangles[b] = p0;
+      const std::size_t hbl = halfedges[bl];
+      // If the flip swapped a hull edge over to the other triangle, update the
+      // hull's reference to it.
+      if (hbl == kNoHalfEdge) {
+        std::size_t e = hull_start_;
+        do {
+          if (hull_tri_[e] == bl) {
+            hull_tri_[e] = a;
+            break;
+          }
+          e = hull_prev_[e];
+        } while (e != hull_start_);
+      }
+      Link(a, hbl);
+      Link(b, halfedges[ar]);
+      Link(ar, bl);
+      edge_stack_.push_back(b0 + (b + 1) % 3);
+    } else {
+      if (edge_stack_.empty()) break;
+      a = edge_stack_.back();
+      edge_stack_.pop_back();
+    }
+  }
+  return ar;
+}
+
+DelaunayTriangulation DelaunaySweep::Run() {
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  if (num_points_ < 3) return result_;
+
+  // Seed triangle: the point closest to the middle of the bounding box, the
+  // point closest to that, and the point making the smallest circumcircle with
+  // those two.
+  const auto [min_x, max_x] = std::minmax_element(x_.begin(), x_.end());
+  const auto [min_y, max_y] = std::minmax_element(y_.begin(), y_.end());
+  const double mid_x = (*min_x + *max_x) / 2, mid_y = (*min_y + *max_y) / 2;
+  auto dist_squared = [&](std::size_t i, double x, double y) {
+    return (x_[i] - x) * (x_[i] - x) + (y_[i] - y) * (y_[i] - y);
+  };
+
+  std::size_t i0 = 0, i1 = kNoPoint, i2 = kNoPoint;
+  double min_dist = kInfinity;
+  for (std::size_t i = 0; i != num_points_; ++i) {
+    double d = dist_squared(i, mid_x, mid_y);
+    if (d < min_dist) {
+      i0 = i;
+      min_dist = d;
+    }
+  }
+  min_dist = kInfinity;
+  for (std::size_t i = 0; i != num_points_; ++i) {
+    double d = dist_squared(i, x_[i0], y_[i0]);
+    if (i != i0 && d < min_dist && d > 0) {
+      i1 = i;
+      min_dist = d;
+    }
+  }
+  if (i1 == kNoPoint) return result_;  // all points are the same
+  double min_radius = kInfinity;
+  for (std::size_t i = 0; i != num_points_; ++i) {
+    if (i == i0 || i == i1) continue;
+    auto [dx, dy] = delaunay_circumcenter_offset(x_[i0], y_[i0], x_[i1],
+                                                 y_[i1], x_[i], y_[i]);
+    double r = dx * dx + dy * dy;
+    if (r < min_radius) {
+      i2 = i;
+      min_radius = r;
+    }
+  }
+  if (i2 == kNoPoint) return result_;  // all points are collinear
+
+  if (delaunay_orient(x_[i0], y_[i0], x_[i1], y_[i1], x_[i2], y_[i2])) {
+    std::swap(i1, i2);
+  }
+  auto [offset_x, offset_y] = delaunay_circumcenter_offset(
+      x_[i0], y_[i0], x_[i1], y_[i1], x_[i2], y_[i2]);
+  center_x_ = x_[i0] + offset_x;
+  center_y_ = y_[i0] + offset_y;
+
+  // Sweep the points in order of distance from the seed's circumcenter. Ties
+  // are broken by position, so that duplicates end up next to each other. The
+  // sort keys are copied next to the ids, to keep the sort cache-friendly.
+  std::vector<std::tuple<double, double, double, std::size_t>> order(
+      num_points_);
+  for (std::size_t i = 0; i != num_points_; ++i) {
+    order[i] = {dist_squared(i, center_x_, center_y_), x_[i], y_[i], i};
+  }
+  std::sort(order.begin(), order.end());
+
+  // The seed triangle is the starting hull.
+  hull_start_ = i0;
+  hull_next_[i0] = hull_prev_[i2] = i1;
+  hull_next_[i1] = hull_prev_[i0] = i2;
+  hull_next_[i2] = hull_prev_[i1] = i0;
+  hull_tri_[i0] = 0;
+  hull_tri_[i1] = 1;
+  hull_tri_[i2] = 2;
+  hull_hash_[HashKey(x_[i0], y_[i0])] = i0;
+  hull_hash_[HashKey(x_[i1], y_[i1])] = i1;
+  hull_hash_[HashKey(x_[i2], y_[i2])] = i2;
+  const std::size_t max_triangles = 2 * num_points_ - 5;
+  result_.triangles_.reserve(3 * max_triangles);
+  result_.halfedges_.reserve(3 * max_triangles);
+  AddTriangle(i0, i1, i2, kNoHalfEdge, kNoHalfEdge, kNoHalfEdge);
+
+  double previous_x = 0, previous_y = 0;
+  for (std::size_t k = 0; k != num_points_; ++k) {
+    const std::size_t i = std::get<3>(order[k]);
+    const double x = x_[i], y = y_[i];
+
+    // Skip duplicates, which come right after each other, and the seed.
+    if (k > 0 && x == previous_x && y == previous_y) continue;
+    previous_x = x;
+    previous_y = y;
+    if ((x == x_[i0] && y == y_[i0]) || (x == x_[i1] && y == y_[i1]) ||
+        (x == x_[i2] && y == y_[i2])) {
+      continue;
+    }
+
+    // Find a hull edge visible from the point, starting from the hull point
+    // nearest its angle.
+    std::size_t start = 0;
+    for (std::size_t j = 0, key = HashKey(x, y); j != hash_size_; ++j) {
+      start = hull_hash_[(key + j) % hash_size_];
+      if (start != kNoPoint && start != hull_next_[start]) break;
+    }
+    start = hull_prev_[start];
+    std::size_t e = start, q = hull_next_[e];
+    while (!delaunay_orient(x, y, x_[e], y_[e], x_[q], y_[q])) {
+      e = q;
+      if (e == start) {
+        e = kNoPoint;
+        break;
+      }
+      q = hull_next_[e];
+    }
+    // No visible edge: the point is too close to the hull to place.
+    if (e == kNoPoint) continue;
+
+    // Connect the point to the first visible edge, and flip edges from it
+    // until they're Delaunay.
+    std::size_t t = AddTriangle(e, i, hull_next_[e], kNoHalfEdge, kNoHalfEdge,
+                                hull_tri_[e]);
+    hull_tri_[i] = Legalize(t + 2);
+    hull_tri_[e] = t;
+
+    // Walk forward along the hull, connecting the point to each edge it sees.
+    std::size_t n = hull_next_[e];
+    q = hull_next_[n];
+    while (delaunay_orient(x, y, x_[n], y_[n], x_[q], y_[q])) {
+      t = AddTriangle(n, i, q, hull_tri_[i], kNoHalfEdge, hull_tri_[n]);
+      hull_tri_[i] = Legalize(t + 2);
+      hull_next_[n] = n;  // removed from the hull
+      n = q;
+      q = hull_next_[n];
+    }
+
+    // Walk backward too, if the first visible edge wasn't the first one
+    // looked at.
+    if (e == start) {
+      q = hull_prev_[e];
+      while (delaunay_orient(x, y, x_[q], y_[q], x_[e], y_[e])) {
+        t = AddTriangle(q, i, e, kNoHalfEdge, hull_tri_[e], hull_tri_[q]);
+        Legalize(t + 2);
+        hull_tri_[q] = t;
+        hull_next_[e] = e;  // removed from the hull
+        e = q;
+        q = hull_prev_[e];
+      }
+    }
+
+    // The point joins the hull between e and n.
+    hull_start_ = hull_prev_[i] = e;
+    hull_next_[e] = hull_prev_[n] = i;
+    hull_next_[i] = n;
+    hull_hash_[HashKey(x, y)] = i;
+    hull_hash_[HashKey(x_[e], y_[e])] = e;
+  }
+  return std::move(result_);
+}
+
+DelaunayTriangulation delaunay_triangulation(
+    const std::vector<const Vertex2d*>& points) {
+  return DelaunaySweep(points).Run();
+}
+
+}  // namespace graphlib
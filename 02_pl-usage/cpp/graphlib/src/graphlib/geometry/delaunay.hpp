@@ -0,0 +1,47 @@
+/*
+A Delaunay triangulation of a set of points in the plane is one in which no
+point lies inside the circumcircle of any triangle. It has O(n) edges, and
+contains the Euclidean minimum spanning tree of the points (see euclidean_mst
+in mst.hpp), which can therefore be found without looking at all O(n^2) pairs.
+
+The triangulation is built with the sweep-hull algorithm of Mapbox's
+"Delaunator" (after Sinclair's "S-hull"). Starting from a seed triangle near
+the middle of the points, the other points are added in order of distance from
+its circumcenter, so each one lies outside the convex hull of the ones before.
+A new point is connected to every hull edge it can see, and edges that break
+the Delaunay condition are flipped. A hash of the hull's points by their angle
+around the seed finds a visible edge right away, so the build takes
+O(n log n) time, most of it for sorting the points.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "graphlib/geometry/graph_2d.hpp"
+
+namespace graphlib {
+
+constexpr std::size_t kNoHalfEdge = static_cast<std::size_t>(-1);
+
+// Triangles as half-edges: half-edge e goes from point triangles_[e] to the
+// next point of its triangle, triangle e / 3.
+struct DelaunayTriangulation {
+  // Indices of the points of each triangle, three per triangle, all with the
+  // same orientation.
+  std::vector<std::size_t> triangles_;
+
+  // The opposite half-edge (in the neighboring triangle) of each half-edge, or
+  // kNoHalfEdge for one on the convex hull.
+  std::vector<std::size_t> halfedges_;
+};
+
+// Triangulates the given points. If they are all collinear (or there are fewer
+// than 3), there are no triangles. Duplicate points are left out (only one
+// copy is used), as may be points too close to another for floating-point
+// orientation tests to place them.
+DelaunayTriangulation delaunay_triangulation(
+    const std::vector<const Vertex2d*>& points);
+
+}  // namespace graphlib
@@ -1,11 +1,15 @@
 #include "graphlib/geometry/graph_2d.hpp"
 
+#include <utility>
+
 namespace graphlib {
 
 Graph2d::Graph2d(bool is_directed) : Graph(is_directed) {}
 
-Graph2d::Graph2d(const InputVertexSet& vertex_set, bool is_directed)
-    : Graph(vertex_set, is_directed) {}
+Graph2d::Graph2d(const std::vector<Vertex2d>& vertices, bool is_directed)
+    : Graph(is_directed) {
+  AddVertices(vertices);
+}
 
 Graph2d::Graph2d(const Input2dAL& al, bool is_directed) : Graph(is_directed) {
   for (const auto& v : al) {
@@ -17,27 +21,37 @@ Graph2d::Graph2d(const Input2dAL& al, bool is_directed) : Graph(is_directed) {
   }
 }
 
-void Graph2d::AddVertex(const Vertex2d& v) {
-  v.Reset();
-  if (FindInVertexSet(v) == vertex_set_.end()) {
-    vertex_set_.insert(std::make_unique<Vertex2d>(v));
+Graph::IndexEntry Graph2d::AddVertexEntry(const Vertex2d& v) {
+  const IndexEntry* entry = FindIndexEntry(v.name_);
+  if (entry) {
+    return *entry;
   }
-  if (FindInAdjacencyMap(v) == adjacency_map_.end()) {
-    adjacency_map_[GetVertexPtr(v)];
+  IndexEntry new_entry = InsertVertex(NewVertex<Vertex2d>(v));
+  spatial_index_.Insert({v.x_, v.y_, new_entry.vertex->id_});
+  return new_entry;
+}
+
+void Graph2d::AddVertex(const Vertex2d& v) { AddVertexEntry(v); }
+
+void Graph2d::AddVertices(const std::vector<Vertex2d>& vertices) {
+  std::vector<SpatialIndex2d::Point> points;
+  points.reserve(vertices.size());
+  for (const Vertex2d& v : vertices) {
+    if (FindIndexEntry(v.name_)) continue;
+    IndexEntry entry = InsertVertex(NewVertex<Vertex2d>(v));
+    points.push_back({v.x_, v.y_, entry.vertex->id_});
   }
+  spatial_index_.Insert(std::move(points));
 }
 
 void Graph2d::AddEdge(const Vertex2d& source, const Vertex2d& dest) {
-  AddVertex(source);
-  AddVertex(dest);
-
-  auto source_ptr = GetVertexPtr(source);
-  auto dest_ptr = GetVertexPtr(dest);
+  IndexEntry source_entry = AddVertexEntry(source);
+  IndexEntry dest_entry = AddVertexEntry(dest);
 
   double edge_weight = distance_2d(source, dest);
-  adjacency_map_.at(source_ptr).insert({dest_ptr, edge_weight});
+  source_entry.adjacent_set->insert({dest_entry.vertex, edge_weight});
   if (!is_directed_) {
-    adjacency_map_.at(dest_ptr).insert({source_ptr, edge_weight});
+    dest_entry.adjacent_set->insert({source_entry.vertex, edge_weight});
   }
 }
 
@@ -45,4 +59,30 @@ double Graph2d::EdgeWeight(const Vertex2d& source, const Vertex2d& dest) {
   return distance_2d(source, dest);
 }
 
+const Vertex2d* Graph2d::NearestVertex(double x, double y) const {
+  VertexId id = spatial_index_.Nearest(x, y);
+  if (id == kNoVertex) return nullptr;
+  return static_cast<const Vertex2d*>(GetVertexPtr(id));
+}
+
+std::vector<const Vertex2d*> Graph2d::NearestVertices(double x, double y,
+                                                      std::size_t k) const {
+  return ToVertices(spatial_index_.KNearest(x, y, k));
+}
+
+std::vector<const Vertex2d*> Graph2d::VerticesWithinRadius(
+    double x, double y, double radius) const {
+  return ToVertices(spatial_index_.WithinRadius(x, y, radius));
+}
+
+std::vector<const Vertex2d*> Graph2d::ToVertices(
+    const std::vector<VertexId>& ids) const {
+  std::vector<const Vertex2d*> vertices;
+  vertices.reserve(ids.size());
+  for (VertexId id : ids) {
+    vertices.push_back(static_cast<const Vertex2d*>(GetVertexPtr(id)));
+  }
+  return vertices;
+}
+
 }  // namespace graphlib
@@ -3,7 +3,10 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
+#include "graphlib/geometry/spatial_index_2d.hpp"
 #include "graphlib/graph.hpp"
 
 namespace graphlib {
@@ -21,6 +24,16 @@ inline double distance_2d(const Vertex2d& v1, const Vertex2d& v2) {
   return std::sqrt(std::pow(v1.x_ - v2.x_, 2) + std::pow(v1.y_ - v2.y_, 2));
 }
 
+// Straight-line distance between two Vertices of a Graph2d (or of a
+// CompactGraph built from one), in the form taken as a heuristic by astar and
+// bidirectional_astar (see weighted_paths.hpp). No path between two vertices
+// of a Graph2d can be shorter, since every edge weighs as much as the distance
+// between its endpoints.
+inline double distance_2d_heuristic(const Vertex* v1, const Vertex* v2) {
+  return distance_2d(static_cast<const Vertex2d&>(*v1),
+                     static_cast<const Vertex2d&>(*v2));
+}
+
 class Graph2d : public Graph {
  public:
   using Input2dAL = std::map<Vertex2d, std::set<Vertex2d>>;
@@ -28,23 +41,52 @@ class Graph2d : public Graph {
   // Constructs an empty graph.
   Graph2d(bool is_directed);
 
-  // Constructs a graph given only a set of vertices, no edges.
-  Graph2d(const InputVertexSet& vertex_set, bool is_directed);
+  // Constructs a graph given only a set of vertices, no edges (see
+  // AddVertices).
+  Graph2d(const std::vector<Vertex2d>& vertices, bool is_directed);
 
   // Constructs a fully specified graph.
   Graph2d(const Input2dAL& al, bool is_directed);
 
   void AddVertex(const Vertex2d& v);
 
+  // Add all of the given vertices, indexing them for the spatial queries below
+  // in one batch (O(n log n) for n new vertices).
+  void AddVertices(const std::vector<Vertex2d>& vertices);
+
   void AddEdge(const Vertex2d& source, const Vertex2d& dest);
 
   double EdgeWeight(const Vertex2d& source, const Vertex2d& dest);
 
+  // Spatial queries, answered from an index of all vertices added so far (see
+  // spatial_index_2d.hpp). Distance ties go to the vertex added first.
+
+  // The vertex closest to (x, y), or nullptr if the graph is empty.
+  const Vertex2d* NearestVertex(double x, double y) const;
+
+  // The k vertices closest to (x, y) (or all of them, if there are fewer),
+  // closest first.
+  std::vector<const Vertex2d*> NearestVertices(double x, double y,
+                                               std::size_t k) const;
+
+  // All vertices at most radius away from (x, y), closest first.
+  std::vector<const Vertex2d*> VerticesWithinRadius(double x, double y,
+                                                    double radius) const;
+
   // Delete inherited functions that insert non-Vertex2d types.
   void AddVertex(const Vertex& v) = delete;
   void AddEdge(const Vertex& source, const Vertex& dest) = delete;
   void AddEdge(const Vertex& source, const Vertex& dest,
                double edge_weight) = delete;
+
+ protected:
+  IndexEntry AddVertexEntry(const Vertex2d& v);
+
+  // Vertex2d pointers for the given VertexIds.
+  std::vector<const Vertex2d*> ToVertices(
+      const std::vector<VertexId>& ids) const;
+
+  SpatialIndex2d spatial_index_;
 };
 
 }  // namespace graphlib
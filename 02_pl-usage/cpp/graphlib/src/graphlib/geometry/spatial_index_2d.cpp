@@ -0,0 +1,159 @@
+#include "graphlib/geometry/spatial_index_2d.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace graphlib {
+
+using Point = SpatialIndex2d::Point;
+
+// Ranges of at most this many points are left unsplit, and scanned in full.
+const std::ptrdiff_t kSpatialLeafSize = 8;
+
+// A point found by a query, ordered by (squared) distance, then VertexId.
+struct SpatialCandidate {
+  double dist_squared_;
+  VertexId id_;
+};
+
+bool operator<(const SpatialCandidate& lhs, const SpatialCandidate& rhs) {
+  return lhs.dist_squared_ < rhs.dist_squared_ ||
+         (lhs.dist_squared_ == rhs.dist_squared_ && lhs.id_ < rhs.id_);
+}
+
+SpatialCandidate to_candidate(const Point& p, double x, double y) {
+  return {(p.x_ - x) * (p.x_ - x) + (p.y_ - y) * (p.y_ - y), p.id_};
+}
+
+// Arrange [begin, end) into a tree, splitting by y if by_y and by x otherwise.
+void build_spatial_tree(Point* begin, Point* end, bool by_y) {
+  if (end - begin <= kSpatialLeafSize) return;
+  Point* mid = begin + (end - begin) / 2;
+  std::nth_element(begin, mid, end, [by_y](const Point& lhs, const Point& rhs) {
+    return by_y ? lhs.y_ < rhs.y_ : lhs.x_ < rhs.x_;
+  });
+  build_spatial_tree(begin, mid, !by_y);
+  build_spatial_tree(mid + 1, end, !by_y);
+}
+
+// Calls visit(p) for every point p of the tree [begin, end) that might be
+// closer to (x, y) than the square root of bound(), which may shrink as points
+// are visited. The side of each split holding (x, y) is searched first, since
+// it's the likeliest to shrink the bound enough to skip the other side.
+template <typename Visit, typename Bound>
+void search_spatial_tree(const Point* begin, const Point* end, bool by_y,
+                         double x, double y, Visit& visit, Bound& bound) {
+  if (end - begin <= kSpatialLeafSize) {
+    for (const Point* p = begin; p != end; ++p) visit(*p);
+    return;
+  }
+  const Point* mid = begin + (end - begin) / 2;
+  visit(*mid);
+  const double diff = by_y ? y - mid->y_ : x - mid->x_;
+  if (diff < 0) {
+    search_spatial_tree(begin, mid, !by_y, x, y, visit, bound);
+    if (diff * diff <= bound()) {
+      search_spatial_tree(mid + 1, end, !by_y, x, y, visit, bound);
+    }
+  } else {
+    search_spatial_tree(mid + 1, end, !by_y, x, y, visit, bound);
+    if (diff * diff <= bound()) {
+      search_spatial_tree(begin, mid, !by_y, x, y, visit, bound);
+    }
+  }
+}
+
+void SpatialIndex2d::Insert(const Point& point) { Insert(std::vector{point}); }
+
+void SpatialIndex2d::Insert(std::vector<Point> points) {
+  if (points.empty()) return;
+  size_ += points.size();
+  build_spatial_tree(points.data(), points.data() + points.size(), false);
+  trees_.push_back(std::move(points));
+
+  // Merge the last two trees while the last is at least half the size of the
+  // one before it.
+  while (trees_.size() >= 2 &&
+         trees_[trees_.size() - 2].size() < 2 * trees_.back().size()) {
+    std::vector<Point>& merged = trees_[trees_.size() - 2];
+    merged.insert(merged.end(), trees_.back().begin(), trees_.back().end());
+    trees_.pop_back();
+    build_spatial_tree(merged.data(), merged.data() + merged.size(), false);
+  }
+}
+
+VertexId SpatialIndex2d::Nearest(double x, double y) const {
+  SpatialCandidate nearest = {std::numeric_limits<double>::infinity(),
+                              kNoVertex};
+  auto visit = [&](const Point& p) {
+    SpatialCandidate candidate = to_candidate(p, x, y);
+    if (candidate < nearest) nearest = candidate;
+  };
+  auto bound = [&] { return nearest.dist_squared_; };
+  for (const std::vector<Point>& tree : trees_) {
+    search_spatial_tree(tree.data(), tree.data() + tree.size(), false, x, y,
+                        visit, bound);
+  }
+  return nearest.id_;
+}
+
+std::vector<VertexId> SpatialIndex2d::KNearest(double x, double y,
+                                               std::size_t k) const {
+  if (k == 0) return {};
+  // Max-heap of the k closest points found so far.
+  std::vector<SpatialCandidate> nearest;
+  nearest.reserve(std::min(k, size_));
+  auto visit = [&](const Point& p) {
+    SpatialCandidate candidate = to_candidate(p, x, y);
+    if (nearest.size() < k) {
+      nearest.push_back(candidate);
+      std::push_heap(nearest.begin(), nearest.end());
+    } else if (candidate < nearest.front()) {
+      std::pop_heap(nearest.begin(), nearest.end());
+      nearest.back() = candidate;
+      std::push_heap(nearest.begin(), nearest.end());
+    }
+  };
+  auto bound = [&] {
+    return nearest.size() < k ? std::numeric_limits<double>::infinity()
+                              : nearest.front().dist_squared_;
+  };
+  for (const std::vector<Point>& tree : trees_) {
+    search_spatial_tree(tree.data(), tree.data() + tree.size(), false, x, y,
+                        visit, bound);
+  }
+
+  std::sort_heap(nearest.begin(), nearest.end());
+  std::vector<VertexId> ids;
+  ids.reserve(nearest.size());
+  for (const SpatialCandidate& candidate : nearest) {
+    ids.push_back(candidate.id_);
+  }
+  return ids;
+}
+
+std::vector<VertexId> SpatialIndex2d::WithinRadius(double x, double y,
+                                                   double radius) const {
+  const double radius_squared = radius * radius;
+  std::vector<SpatialCandidate> within;
+  auto visit = [&](const Point& p) {
+    SpatialCandidate candidate = to_candidate(p, x, y);
+    if (candidate.dist_squared_ <= radius_squared) within.push_back(candidate);
+  };
+  auto bound = [&] { return radius_squared; };
+  for (const std::vector<Point>& tree : trees_) {
+    search_spatial_tree(tree.data(), tree.data() + tree.size(), false, x, y,
+                        visit, bound);
+  }
+
+  std::sort(within.begin(), within.end());
+  std::vector<VertexId> ids;
+  ids.reserve(within.size());
+  for (const SpatialCandidate& candidate : within) {
+    ids.push_back(candidate.id_);
+  }
+  return ids;
+}
+
+}  // namespace graphlib
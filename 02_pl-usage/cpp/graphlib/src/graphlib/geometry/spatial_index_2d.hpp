@@ -0,0 +1,68 @@
+/*
+The "SpatialIndex2d" class answers nearest-neighbor, k-nearest-neighbor, and
+radius queries over a set of points in the plane, each tagged with a VertexId
+(e.g. the vertices of a Graph2d, which maintains one).
+
+Points are kept in 2d trees ("k-d trees" with k = 2). Each tree is stored
+implicitly in an array of points: the median of a range, by x or y in turn at
+each level, sits in the middle, with the points on either side of it in the
+two halves. Building a tree over n points takes O(n log n) time, and a query
+only visits the parts of it that could hold a closer point than the ones found
+so far.
+
+A static tree can't take new points, so the index is a forest of trees that
+are rebuilt as points arrive (Bentley and Saxe's "logarithmic method"): each
+new batch of points becomes a tree of its own, and the smallest trees are
+merged while the last one is at least half the size of the one before it.
+Like carries in a binary counter, this keeps the number of trees at most
+logarithmic, and each point gets rebuilt into a new tree O(log n) times. A
+large batch (see Insert) is built into one tree right away.
+
+Distance ties are broken by smaller VertexId, so every query has exactly one
+answer.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+class SpatialIndex2d {
+ public:
+  struct Point {
+    double x_, y_;
+    VertexId id_;
+  };
+
+  // Constructs an empty index.
+  SpatialIndex2d() = default;
+
+  std::size_t Size() const { return size_; }
+
+  // Add a point in O(log^2 n) amortized time, or a batch of m points in
+  // O(m log m) time plus the amortized cost of merging them into the forest.
+  void Insert(const Point& point);
+  void Insert(std::vector<Point> points);
+
+  // Returns the VertexId of the point closest to (x, y), or kNoVertex if the
+  // index is empty.
+  VertexId Nearest(double x, double y) const;
+
+  // Returns the VertexIds of the k points closest to (x, y) (or of all points,
+  // if there are fewer), closest first.
+  std::vector<VertexId> KNearest(double x, double y, std::size_t k) const;
+
+  // Returns the VertexIds of all points at most radius away from (x, y),
+  // closest first.
+  std::vector<VertexId> WithinRadius(double x, double y, double radius) const;
+
+ private:
+  std::vector<std::vector<Point>> trees_;  // from largest to smallest
+  std::size_t size_ = 0;
+};
+
+}  // namespace graphlib
@@ -1,27 +1,11 @@
 #include "graphlib/graph.hpp"
 
-#include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace graphlib {
 
-std::string to_string(const Vertex::State& state) {
-  switch (state) {
-    case Vertex::State::UNDISCOVERED:
-      return "0";
-      break;
-    case Vertex::State::DISCOVERED:
-      return "1";
-      break;
-    case Vertex::State::PROCESSED:
-      return "2";
-      break;
-    default:
-      return "nonexistent Vertex state";
-  }
-}
-
 Graph::Graph(bool is_directed) : is_directed_(is_directed) {}
 
 Graph::Graph(const InputVertexSet& vertex_set, bool is_directed)
@@ -53,88 +37,102 @@ Graph::Graph(InputWeightedAL weighted_al, bool is_directed)
   }
 }
 
-Graph::VertexSet::const_iterator Graph::FindInVertexSet(const Vertex& v) const {
-  return std::find_if(
-      vertex_set_.cbegin(), vertex_set_.cend(),
-      [&](const VertexSet::value_type& p) -> bool { return *p == v; });
+Graph::~Graph() {
+  // The arena releases the memory of the Vertices, but doesn't destroy them.
+  for (Vertex* v : vertex_set_) {
+    v->~Vertex();
+  }
+}
+
+const Graph::IndexEntry* Graph::FindIndexEntry(std::string_view name) const {
+  auto index_iter = vertex_index_.find(name);
+  return index_iter == vertex_index_.end() ? nullptr
+                                           : &entries_[index_iter->second];
+}
+
+const Graph::IndexEntry* Graph::FindIndexEntry(const Vertex* v) const {
+  if (v->id_ >= 0 && v->id_ < static_cast<VertexId>(entries_.size()) &&
+      entries_[v->id_].vertex == v) {
+    return &entries_[v->id_];
+  }
+  return FindIndexEntry(v->name_);
+}
+
+Graph::IndexEntry Graph::InsertVertex(Vertex* v) {
+  v->id_ = static_cast<VertexId>(entries_.size());
+  const Vertex* v_ptr = v;
+  vertex_set_.insert(v);
+  AdjacentSet* adj_set = &adjacency_map_[v_ptr];
+  vertex_index_[v_ptr->name_] = v_ptr->id_;
+  entries_.push_back({v_ptr, adj_set});
+  return entries_.back();
 }
 
-Graph::AdjacencyMap::const_iterator Graph::FindInAdjacencyMap(
-    const Vertex& v) const {
-  return std::find_if(adjacency_map_.cbegin(), adjacency_map_.cend(),
-                      [&](const AdjacencyMap::value_type& p) -> bool {
-                        return *(p.first) == v;
-                      });
+const Vertex* Graph::FindVertex(std::string_view name) const {
+  const IndexEntry* entry = FindIndexEntry(name);
+  return entry ? entry->vertex : nullptr;
 }
 
 const Vertex* Graph::GetVertexPtr(const Vertex& v) const {
-  auto vertex_iter = FindInVertexSet(v);
-  if (vertex_iter == vertex_set_.end()) {
+  const Vertex* v_ptr = FindVertex(v.name_);
+  if (!v_ptr) {
     throw std::runtime_error(
         "Graph::GetVertexPtr error! Tried to obtain pointer to "
         "nonexistent vertex (" +
         v.name_ + ")\n");
   }
-  return (*vertex_iter).get();
+  return v_ptr;
 }
 
-void Graph::AddVertex(const Vertex& v) {
-  v.Reset();
-  if (FindInVertexSet(v) == vertex_set_.end()) {
-    vertex_set_.insert(std::make_unique<Vertex>(v));
-  }
-  if (FindInAdjacencyMap(v) == adjacency_map_.end()) {
-    adjacency_map_[GetVertexPtr(v)];
+Graph::IndexEntry Graph::AddVertexEntry(const Vertex& v) {
+  const IndexEntry* entry = FindIndexEntry(v.name_);
+  if (entry) {
+    return *entry;
   }
+  return InsertVertex(NewVertex<Vertex>(v));
 }
 
+void Graph::AddVertex(const Vertex& v) { AddVertexEntry(v); }
+
 void Graph::AddEdge(const Vertex& source, const Vertex& dest,
                     double edge_weight) {
-  AddVertex(source);
-  AddVertex(dest);
-
-  auto source_ptr = GetVertexPtr(source);
-  auto dest_ptr = GetVertexPtr(dest);
+  IndexEntry source_entry = AddVertexEntry(source);
+  IndexEntry dest_entry = AddVertexEntry(dest);
 
-  adjacency_map_.at(source_ptr).insert({dest_ptr, edge_weight});
+  source_entry.adjacent_set->insert({dest_entry.vertex, edge_weight});
   if (!is_directed_) {
-    adjacency_map_.at(dest_ptr).insert({source_ptr, edge_weight});
+    dest_entry.adjacent_set->insert({source_entry.vertex, edge_weight});
   }
 }
 
 bool Graph::EdgeExists(const Vertex& source, const Vertex& dest) const {
-  auto adj_iter = FindInAdjacencyMap(source);
-  const auto& adj_set = adj_iter->second;
-  for (const auto& pair : adj_set) {
-    if (*(pair.first) == dest) {
-      return true;
-    }
+  const IndexEntry* source_entry = FindIndexEntry(source.name_);
+  const Vertex* dest_ptr = FindVertex(dest.name_);
+  if (!source_entry || !dest_ptr) {
+    return false;
   }
-  return false;
+  const AdjacentSet& adj_set = *(source_entry->adjacent_set);
+  return adj_set.find({dest_ptr, 0}) != adj_set.end();
 }
 
 double Graph::EdgeWeight(const Vertex& source, const Vertex& dest) const {
-  auto adj_iter = FindInAdjacencyMap(source);
-  const auto& adj_set = adj_iter->second;
-  for (const auto& pair : adj_set) {
-    if (*(pair.first) == dest) {
-      return pair.second;
+  const IndexEntry* source_entry = FindIndexEntry(source.name_);
+  const Vertex* dest_ptr = FindVertex(dest.name_);
+  if (source_entry && dest_ptr) {
+    const AdjacentSet& adj_set = *(source_entry->adjacent_set);
+    auto adj_iter = adj_set.find({dest_ptr, 0});
+    if (adj_iter != adj_set.end()) {
+      return adj_iter->second;
     }
   }
   throw std::runtime_error(
       "Graph::EdgeWeight error! Given nonexistent edge.\n");
 }
 
-void Graph::ResetState() {
-  for (auto& v : vertex_set_) {
-    v->Reset();
-  }
-}
-
 std::string Graph::GetVertexSetStr() const {
   std::string s("Vertex set:\n");
   for (const auto& v : vertex_set_) {
-    s += v->name_ + "(state=" + graphlib::to_string(v->state_) + ") | ";
+    s += v->name_ + " | ";
   }
   s += '\n';
   return s;
@@ -142,6 +140,11 @@ std::string Graph::GetVertexSetStr() const {
 
 std::unique_ptr<Graph> Graph::GetReverseGraph() const {
   std::unique_ptr<Graph> reverse = std::make_unique<Graph>(true);
+
+  // Add vertices in id order first so that ids are preserved.
+  for (const IndexEntry& entry : entries_) {
+    reverse->AddVertex(*(entry.vertex));
+  }
   for (const auto& v : this->GetAdjacencyMap()) {
     Vertex source = *(v.first);
     reverse->AddVertex(source);
@@ -153,11 +156,23 @@ std::unique_ptr<Graph> Graph::GetReverseGraph() const {
 }
 
 Graph::AdjacentSet& Graph::GetMutableAdjacentSet(const Vertex* source) {
-  return adjacency_map_.at(source);
+  const IndexEntry* entry = FindIndexEntry(source);
+  if (!entry) {
+    throw std::out_of_range(
+        "Graph::GetMutableAdjacentSet error! Given nonexistent vertex (" +
+        source->name_ + ")\n");
+  }
+  return *(entry->adjacent_set);
 }
 
 const Graph::AdjacentSet& Graph::GetAdjacentSet(const Vertex* source) const {
-  return adjacency_map_.at(source);
+  const IndexEntry* entry = FindIndexEntry(source);
+  if (!entry) {
+    throw std::out_of_range(
+        "Graph::GetAdjacentSet error! Given nonexistent vertex (" +
+        source->name_ + ")\n");
+  }
+  return *(entry->adjacent_set);
 }
 
 std::string to_string(const Graph& graph) {
@@ -18,17 +18,25 @@ The corresponding adjacency sets would be:
 
 ===============================================================================
 
-The "Vertex" struct represents a vertex with a string name. It encodes commonly
-used values associated with graph algorithms, such as search state. Inheritance
-can be leveraged to create Vertex types that store more information.
+The "Vertex" struct represents a vertex with a string name. Inheritance can be
+leveraged to create Vertex types that store more information (I like to think of
+that information as the "payload" stored by a Vertex). Search state used by
+graph algorithms is NOT stored in Vertices; see search_state.hpp.
+
+Every Vertex owned by a Graph is also assigned a dense integer id in the range
+[0, V), in the order Vertices are added. Each Graph interns the names of its
+Vertices, mapping every distinct name to exactly one Vertex and id, so inside a
+Graph the id serves as a compact symbol for the name: the Graph's underlying
+data structures order and compare Vertices by id (an integer comparison) and
+only touch names for lookups by name and for output. The same ids index the
+dense arrays used by graph algorithms.
 
 The "Graph" class defines three typenames, "VertexSet", "AdjacentSet", and
 "AdjacencyMap", for internal use as the underlying data structure.
 
-The "VertexSet" typename (set<unique_ptr<Vertex>>) represents the only set of
-Vertex instances allocated and maintained by the Graph. All uses of a Vertex in
-the Graph must use a pointer to the Vertices contained in the VertexSet data
-member.
+The "VertexSet" typename (set<Vertex*>) represents the only set of Vertex
+instances allocated and maintained by the Graph. All uses of a Vertex in the
+Graph must use a pointer to the Vertices contained in the VertexSet data member.
 
 The "AdjacencyMap" typename (map<const Vertex*, AdjacentSet>), maps each
 Vertex instance of a graph to a corresponding "AdjacentSet" type.
@@ -41,6 +49,15 @@ Each neighboring vertex is paired with a floating point edge weight.
 Altogether, an AdjacencyMap key and a pair contained by the AdjacentSet bound
 to that key represent the concept of one directed weighted edge in a Graph.
 
+All three are ordered by Vertex id, so iterating over them visits Vertices in
+the order they were added to the Graph (the same order as a CompactGraph, see
+compact_graph.hpp).
+
+The Vertices and all nodes of these containers are allocated from an arena
+owned by the Graph (std::pmr::monotonic_buffer_resource), rather than one heap
+allocation each. Nothing is ever removed from a Graph, so the arena never needs
+to reuse memory; it is released all at once when the Graph is destroyed.
+
 There exists an auxiliary "Edge" struct, which also represents the concept of an
 edge in a graph, but this is only used in specific algorithms (like finding
 MSTs) and are NOT for defining Graphs themselves.
@@ -94,33 +111,33 @@ See examples/core_test.cpp for actual examples of this behavior.
 
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <set>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace graphlib {
 
-struct Vertex {
-  enum class State { UNDISCOVERED, DISCOVERED, PROCESSED };
+// Dense integer vertex ids, assigned by the Graph that owns a Vertex.
+using VertexId = int;
+
+// Sentinel for "no vertex" (e.g. the search tree parent of a search root, or
+// the id of a Vertex not owned by any Graph).
+constexpr VertexId kNoVertex = -1;
 
+struct Vertex {
   Vertex(const std::string& name) : name_(name) {}
 
   const std::string name_;
 
-  // The Vertex data members below store special states used by graph algorithm
-  // implementations. Making these mutable gives us the flexibility to add other
-  // nonconst Vertex data that should not be modified during the execution of
-  // graph algorithms, but can otherwise be modified for external uses (I like
-  // to think of those members as the "payload" stored by a Vertex).
-  mutable State state_ = State::UNDISCOVERED;   // search state
-  mutable const Vertex* parent_;                // search tree parent
-  mutable int entry_time_ = 0, exit_time_ = 0;  // dfs time intervals
-
-  void Reset() const {
-    state_ = State::UNDISCOVERED;
-    parent_ = nullptr;
-    entry_time_ = 0;
-    exit_time_ = 0;
-  }
+  // Assigned when a copy of this Vertex is added to a Graph. Ids do not take
+  // part in the comparison operators below, which compare names so that they
+  // also work for Vertices not owned by any Graph.
+  VertexId id_ = kNoVertex;
 
   virtual ~Vertex() = default;
 };
@@ -137,30 +154,33 @@ inline bool operator!=(const Vertex& lhs, const Vertex& rhs) {
   return !operator==(lhs, rhs);
 }
 
-std::string to_string(const Vertex::State& state);
-
+// Orders Vertices owned by the same Graph by id. Used by the Graph's underlying
+// data structures.
 struct UnderlyingVertexOrder {
   bool operator()(const Vertex* lhs, const Vertex* rhs) const {
-    return *lhs < *rhs;
-  }
-  bool operator()(const std::unique_ptr<Vertex>& lhs,
-                  const std::unique_ptr<Vertex>& rhs) const {
-    return *lhs < *rhs;
+    return lhs->id_ < rhs->id_;
   }
   bool operator()(const std::pair<const Vertex*, double>& lhs,
                   const std::pair<const Vertex*, double>& rhs) const {
-    return *(lhs.first) < *(rhs.first);
+    return lhs.first->id_ < rhs.first->id_;
+  }
+};
+
+// Orders Vertices by name, for output meant to be read in alphabetical order.
+struct VertexNameOrder {
+  bool operator()(const Vertex* lhs, const Vertex* rhs) const {
+    return *lhs < *rhs;
   }
 };
 
 class Graph {
  protected:
-  // Underlying data structure types.
-  using VertexSet = std::set<std::unique_ptr<Vertex>, UnderlyingVertexOrder>;
+  // Underlying data structure types, all allocated from the Graph's arena.
+  using VertexSet = std::pmr::set<Vertex*, UnderlyingVertexOrder>;
   using AdjacentSet =
-      std::set<std::pair<const Vertex*, double>, UnderlyingVertexOrder>;
+      std::pmr::set<std::pair<const Vertex*, double>, UnderlyingVertexOrder>;
   using AdjacencyMap =
-      std::map<const Vertex*, AdjacentSet, UnderlyingVertexOrder>;
+      std::pmr::map<const Vertex*, AdjacentSet, UnderlyingVertexOrder>;
 
  public:
   // Convenience typenames used for user input; not actual underlying types.
@@ -180,12 +200,30 @@ class Graph {
   // Constructs a fully specified weighted graph.
   Graph(InputWeightedAL weighted_al, bool is_directed);
 
+  // A Graph can be moved (the arena moves with it), but not copied or
+  // assigned.
+  Graph(Graph&&) = default;
+  Graph& operator=(Graph&&) = delete;
+
+  ~Graph();
+
   // Given a Vertex v, obtain a raw pointer to the singular instance of the
   // Vertex identical to v managed by this Graph object.
   const Vertex* GetVertexPtr(const Vertex& v) const;
 
-  // Add a freshly-reset copy of the given Vertex to this graph. Duplicates are
-  // ignored.
+  // Obtain a raw pointer to the Vertex with the given name, or nullptr if no
+  // such Vertex exists. Unlike GetVertexPtr, no temporary Vertex is needed.
+  const Vertex* FindVertex(std::string_view name) const;
+
+  // Obtain a raw pointer to the Vertex with the given id.
+  const Vertex* GetVertexPtr(VertexId id) const {
+    return entries_[id].vertex;
+  }
+
+  std::size_t NumVertices() const { return entries_.size(); }
+
+  // Add a copy of the given Vertex to this graph, assigning it the next unused
+  // id. Duplicates are ignored.
   void AddVertex(const Vertex& v);
 
   // Add "dest" to the adjacency set of "source", along with an associated edge
@@ -198,13 +236,8 @@ class Graph {
 
   double EdgeWeight(const Vertex& source, const Vertex& dest) const;
 
-  // Reset the state, color, etc, of all Vertices in this Graph object.
-  // This is intended for direct user usage and is *not* automatically called at
-  // the start of algorithmic functions present in this library.
-  void ResetState();
-
   // Factory for a reversed copy of this Graph. Note that this naturally only
-  // makes sense for directed graphs.
+  // makes sense for directed graphs. Vertex ids are preserved.
   std::unique_ptr<Graph> GetReverseGraph() const;
 
   // Return a string displaying all vertices (without adjacency sets).
@@ -215,17 +248,58 @@ class Graph {
 
   const AdjacencyMap& GetAdjacencyMap() const { return adjacency_map_; }
 
-  bool IsDirected() { return is_directed_; }
+  bool IsDirected() const { return is_directed_; }
 
  protected:
-  VertexSet vertex_set_;
-  AdjacencyMap adjacency_map_;
+  // Bulk-loads the underlying data structures directly (see graph_builder.hpp).
+  friend class GraphBuilder;
+
+  // Each Vertex in the VertexSet, along with its AdjacentSet in the
+  // AdjacencyMap.
+  struct IndexEntry {
+    const Vertex* vertex;
+    AdjacentSet* adjacent_set;
+  };
+
+  // Declared first, so that it is destroyed last.
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_ =
+      std::make_unique<std::pmr::monotonic_buffer_resource>();
+
+  VertexSet vertex_set_{arena_.get()};
+  AdjacencyMap adjacency_map_{arena_.get()};
+
+  // Index entries by VertexId.
+  std::vector<IndexEntry> entries_;
+
+  // Intern table maintained alongside vertex_set_ and adjacency_map_, mapping
+  // names to ids with O(1) average lookups. Keys are views of the name_ of the
+  // Vertex they map to.
+  std::pmr::unordered_map<std::string_view, VertexId> vertex_index_{
+      arena_.get()};
 
   bool is_directed_;
 
-  // Extensions of std::find
-  VertexSet::const_iterator FindInVertexSet(const Vertex& v) const;
-  AdjacencyMap::const_iterator FindInAdjacencyMap(const Vertex& v) const;
+  // Index lookups. Return nullptr if no Vertex with the given name exists.
+  const IndexEntry* FindIndexEntry(std::string_view name) const;
+
+  // Index lookup for a Vertex pointer. Vertices owned by this Graph are found
+  // by id without hashing; other Vertices fall back to lookup by name.
+  const IndexEntry* FindIndexEntry(const Vertex* v) const;
+
+  // Construct a Vertex (or derived type) in the arena. The result must be
+  // passed to InsertVertex, which takes ownership of it.
+  template <typename VertexType, typename... Args>
+  VertexType* NewVertex(Args&&... args) {
+    void* memory = arena_->allocate(sizeof(VertexType), alignof(VertexType));
+    return new (memory) VertexType(std::forward<Args>(args)...);
+  }
+
+  // Take ownership of a new Vertex (assumed not already present), giving it the
+  // next unused id and an empty AdjacentSet and indexing it.
+  IndexEntry InsertVertex(Vertex* v);
+
+  // AddVertex, returning the index entry of the (new or existing) Vertex.
+  IndexEntry AddVertexEntry(const Vertex& v);
 };
 
 // For a given graph, return a string displaying all vertices and corresponding
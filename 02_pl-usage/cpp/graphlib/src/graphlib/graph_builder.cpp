@@ -0,0 +1,137 @@
+#include "graphlib/graph_builder.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace graphlib {
+
+GraphBuilder::GraphBuilder(bool is_directed) : is_directed_(is_directed) {}
+
+VertexId GraphBuilder::GetOrAddId(std::string_view name) {
+  auto id_iter = ids_.find(name);
+  if (id_iter != ids_.end()) {
+    return id_iter->second;
+  }
+  VertexId id = static_cast<VertexId>(names_.size());
+  names_.emplace_back(name);
+  ids_.emplace(names_.back(), id);
+  return id;
+}
+
+void GraphBuilder::AddVertex(std::string_view name) { GetOrAddId(name); }
+
+void GraphBuilder::AddEdge(std::string_view source, std::string_view dest,
+                           double edge_weight) {
+  // Resolve the source first to match the id order of Graph::AddEdge.
+  VertexId source_id = GetOrAddId(source);
+  VertexId dest_id = GetOrAddId(dest);
+  edges_.push_back({source_id, dest_id, edge_weight});
+}
+
+void GraphBuilder::AddEdges(const std::vector<std::string>& sources,
+                            const std::vector<std::string>& dests,
+                            const std::vector<double>& weights) {
+  if (sources.size() != dests.size() ||
+      (!weights.empty() && weights.size() != sources.size())) {
+    throw std::runtime_error(
+        "GraphBuilder::AddEdges error! Given edge arrays of different "
+        "sizes.\n");
+  }
+  for (std::size_t i = 0; i != sources.size(); ++i) {
+    AddEdge(sources[i], dests[i], weights.empty() ? 1 : weights[i]);
+  }
+}
+
+std::unique_ptr<Graph> GraphBuilder::Build(
+    std::unique_ptr<CompactGraph>* compact_graph) {
+  const std::size_t num_vertices = names_.size();
+
+  // Add the reverse of each undirected edge right after the edge itself, in
+  // place, so that the first weight given for an edge still wins in both
+  // directions.
+  if (!is_directed_) {
+    const std::size_t num_edges = edges_.size();
+    edges_.resize(2 * num_edges);
+    for (std::size_t i = num_edges; i-- > 0;) {
+      const PendingEdge e = edges_[i];
+      edges_[2 * i] = e;
+      edges_[2 * i + 1] = {e.dest, e.source, e.weight};
+    }
+  }
+
+  // Sort edges into Graph's tree order (by id) and drop all but the first copy
+  // of each.
+  std::stable_sort(edges_.begin(), edges_.end(),
+                   [](const PendingEdge& lhs, const PendingEdge& rhs) {
+                     if (lhs.source != rhs.source) {
+                       return lhs.source < rhs.source;
+                     }
+                     return lhs.dest < rhs.dest;
+                   });
+  edges_.erase(std::unique(edges_.begin(), edges_.end(),
+                           [](const PendingEdge& lhs, const PendingEdge& rhs) {
+                             return lhs.source == rhs.source &&
+                                    lhs.dest == rhs.dest;
+                           }),
+               edges_.end());
+
+  // Everything below inserts in sorted order, so each insert (given the end of
+  // the tree as a hint) takes amortized constant time.
+  std::unique_ptr<Graph> graph = std::make_unique<Graph>(is_directed_);
+  graph->entries_.resize(num_vertices);
+  graph->vertex_index_.reserve(num_vertices);
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices); ++v) {
+    Vertex* vertex = graph->NewVertex<Vertex>(names_[v]);
+    vertex->id_ = v;
+    const Vertex* v_ptr = vertex;
+    graph->vertex_set_.insert(graph->vertex_set_.end(), vertex);
+    auto adj_iter = graph->adjacency_map_.try_emplace(
+        graph->adjacency_map_.end(), v_ptr);
+    graph->vertex_index_.emplace(v_ptr->name_, v);
+    graph->entries_[v] = {v_ptr, &adj_iter->second};
+  }
+  for (const PendingEdge& e : edges_) {
+    Graph::AdjacentSet* adj_set = graph->entries_[e.source].adjacent_set;
+    adj_set->emplace_hint(adj_set->end(), graph->entries_[e.dest].vertex,
+                          e.weight);
+  }
+
+  if (compact_graph) {
+    // The edges are already in CSR order.
+    std::unique_ptr<CompactGraph> compact(new CompactGraph());
+    compact->is_directed_ = is_directed_;
+    compact->vertices_.resize(num_vertices);
+    for (std::size_t v = 0; v != num_vertices; ++v) {
+      compact->vertices_[v] = graph->entries_[v].vertex;
+    }
+
+    auto arrays = std::make_shared<CompactGraph::Arrays>();
+    arrays->offsets.assign(num_vertices + 1, 0);
+    for (const PendingEdge& e : edges_) {
+      ++arrays->offsets[e.source + 1];
+    }
+    for (std::size_t v = 0; v != num_vertices; ++v) {
+      arrays->offsets[v + 1] += arrays->offsets[v];
+    }
+
+    arrays->targets.reserve(edges_.size());
+    arrays->weights.reserve(edges_.size());
+    for (const PendingEdge& e : edges_) {
+      arrays->targets.push_back(e.dest);
+      arrays->weights.push_back(e.weight);
+    }
+    compact->SetArrays(std::move(arrays));
+    *compact_graph = std::move(compact);
+  }
+
+  // Leave the builder empty (ids_ holds views into names_, so it goes first).
+  ids_.clear();
+  names_.clear();
+  std::vector<PendingEdge>().swap(edges_);
+
+  return graph;
+}
+
+}  // namespace graphlib
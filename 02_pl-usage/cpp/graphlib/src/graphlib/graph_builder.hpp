@@ -0,0 +1,92 @@
+/*
+The "GraphBuilder" class bulk-loads a Graph (and optionally its CompactGraph
+snapshot) from batches of edges given by vertex name.
+
+Graph::AddEdge is convenient for small graphs, but each call looks up (or
+inserts) both endpoints and then inserts into red-black trees in whatever order
+edges happen to arrive. A GraphBuilder instead resolves every vertex name to a
+dense id once, as batches arrive, and defers all tree inserts to Build().
+Build() sorts and deduplicates the buffered edges, then materializes the Graph
+in a single pass over sorted data, so every tree insert is a constant-time
+insert at the end of its tree.
+
+The resulting Graph is identical to one built by calling Graph::AddVertex and
+Graph::AddEdge in the same order:
+  - Vertex ids are assigned in the order vertex names first appear.
+  - Undirected graphs automatically get reverse edges.
+  - Duplicate edges are ignored, i.e. the first weight given for an edge wins.
+
+Typical usage:
+
+  GraphBuilder builder(false);
+  builder.AddEdges({"A", "A", "D", "E"}, {"D", "E", "E", "C"});
+  builder.AddVertex("B");
+  std::unique_ptr<CompactGraph> compact;
+  std::unique_ptr<Graph> graph = builder.Build(&compact);
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+class GraphBuilder {
+ public:
+  GraphBuilder(bool is_directed);
+
+  // Add a vertex that may not appear in any edge. Duplicates are ignored.
+  void AddVertex(std::string_view name);
+
+  // Add a single edge, adding its endpoints if they are not yet present.
+  void AddEdge(std::string_view source, std::string_view dest,
+               double edge_weight = 1);
+
+  // Add a batch of edges given as parallel arrays. If weights is empty, all
+  // edges in the batch have weight 1.
+  void AddEdges(const std::vector<std::string>& sources,
+                const std::vector<std::string>& dests,
+                const std::vector<double>& weights = {});
+
+  std::size_t NumVertices() const { return names_.size(); }
+
+  // Number of edges added so far, counting duplicates (and not counting the
+  // implicit reverse edges of an undirected graph).
+  std::size_t NumPendingEdges() const { return edges_.size(); }
+
+  // Materialize the Graph. If compact_graph is given, it is set to a
+  // CompactGraph snapshot of the returned Graph, built from the same sorted
+  // edges. The builder is left empty.
+  std::unique_ptr<Graph> Build(
+      std::unique_ptr<CompactGraph>* compact_graph = nullptr);
+
+ private:
+  struct PendingEdge {
+    VertexId source, dest;
+    double weight;
+  };
+
+  // Return the id of the vertex with the given name, adding it if necessary.
+  VertexId GetOrAddId(std::string_view name);
+
+  bool is_directed_;
+
+  // Vertex names by id. A deque never moves its elements, so the keys of
+  // ids_ can safely be views into it.
+  std::deque<std::string> names_;
+  std::unordered_map<std::string_view, VertexId> ids_;
+
+  // Edges in the order they were added.
+  std::vector<PendingEdge> edges_;
+};
+
+}  // namespace graphlib
@@ -0,0 +1,291 @@
+#include "graphlib/graph_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "graphlib/geometry/graph_2d.hpp"
+
+namespace graphlib {
+
+const char kGraphFileMagic[8] = {'G', 'R', 'A', 'P', 'H', 'L', 'I', 'B'};
+const std::uint32_t kGraphFileVersion = 1;
+
+// Written in native byte order, so reads back differently on a host with the
+// other byte order.
+const std::uint32_t kGraphFileByteOrder = 0x01020304;
+
+// Header flags.
+const std::uint32_t kGraphFileDirected = 1 << 0;
+const std::uint32_t kGraphFileCoordinates = 1 << 1;
+
+struct GraphFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t flags;
+  std::uint32_t reserved;
+  std::uint64_t num_vertices;
+  std::uint64_t num_edges;
+  std::uint64_t names_size;
+};
+
+// File positions of each section (see graph_file.hpp), and the total size.
+struct GraphFileLayout {
+  std::uint64_t offsets, targets, weights, name_offsets, name_order,
+      coordinates, names, size;
+};
+
+std::uint64_t align_to_8(std::uint64_t position) {
+  return (position + 7) & ~std::uint64_t(7);
+}
+
+// Whether the counts in the header could fit in a file of the given size. Each
+// count is bounded by the number of its smallest elements that fit, so the
+// layout of a header passing this check can't overflow.
+bool graph_file_counts_fit(const GraphFileHeader& header,
+                           std::uint64_t file_size) {
+  return header.num_vertices <= file_size / sizeof(std::uint64_t) &&
+         header.num_vertices <
+             static_cast<std::uint64_t>(std::numeric_limits<VertexId>::max()) &&
+         header.num_edges <= file_size / sizeof(double) &&
+         header.names_size <= file_size;
+}
+
+GraphFileLayout get_graph_file_layout(const GraphFileHeader& header) {
+  const std::uint64_t v = header.num_vertices, e = header.num_edges;
+  GraphFileLayout layout;
+  layout.offsets = align_to_8(sizeof(GraphFileHeader));
+  layout.targets = layout.offsets + sizeof(std::uint64_t) * (v + 1);
+  layout.weights = align_to_8(layout.targets + sizeof(VertexId) * e);
+  layout.name_offsets = layout.weights + sizeof(double) * e;
+  layout.name_order = layout.name_offsets + sizeof(std::uint64_t) * (v + 1);
+  layout.coordinates = align_to_8(layout.name_order + sizeof(VertexId) * v);
+  layout.names = layout.coordinates;
+  if (header.flags & kGraphFileCoordinates) {
+    layout.names += 2 * sizeof(double) * v;
+  }
+  layout.size = layout.names + header.names_size;
+  return layout;
+}
+
+// Zero-pad the output up to the given position, then write the given array.
+template <typename T>
+void write_graph_file_section(std::ofstream& out, std::uint64_t position,
+                              const T* data, std::size_t count) {
+  static const char zeros[8] = {};
+  out.write(zeros, position - static_cast<std::uint64_t>(out.tellp()));
+  out.write(reinterpret_cast<const char*>(data), sizeof(T) * count);
+}
+
+void write_graph_file(const CompactGraph& graph, const std::string& path) {
+  const std::size_t num_vertices = graph.NumVertices();
+
+  // Coordinates are only written if every vertex has them.
+  bool has_coordinates = num_vertices > 0;
+  std::vector<double> coordinates;
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices); ++v) {
+    auto v_2d = dynamic_cast<const Vertex2d*>(graph.GetVertexPtr(v));
+    if (!v_2d) {
+      has_coordinates = false;
+      break;
+    }
+    coordinates.push_back(v_2d->x_);
+    coordinates.push_back(v_2d->y_);
+  }
+
+  std::vector<std::uint64_t> offsets(graph.GetOffsets().begin(),
+                                     graph.GetOffsets().end());
+  std::vector<std::uint64_t> name_offsets(1, 0);
+  name_offsets.reserve(num_vertices + 1);
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices); ++v) {
+    name_offsets.push_back(name_offsets.back() +
+                           graph.GetVertexPtr(v)->name_.size());
+  }
+  std::vector<VertexId> name_order(num_vertices);
+  std::iota(name_order.begin(), name_order.end(), 0);
+  std::sort(name_order.begin(), name_order.end(),
+            [&graph](VertexId lhs, VertexId rhs) {
+              return graph.GetVertexPtr(lhs)->name_ <
+                     graph.GetVertexPtr(rhs)->name_;
+            });
+
+  GraphFileHeader header = {};
+  std::memcpy(header.magic, kGraphFileMagic, sizeof(header.magic));
+  header.version = kGraphFileVersion;
+  header.byte_order = kGraphFileByteOrder;
+  header.flags = (graph.IsDirected() ? kGraphFileDirected : 0) |
+                 (has_coordinates ? kGraphFileCoordinates : 0);
+  header.num_vertices = num_vertices;
+  header.num_edges = graph.NumEdges();
+  header.names_size = name_offsets.back();
+  const GraphFileLayout layout = get_graph_file_layout(header);
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error(
+        "write_graph_file error! Could not open file for writing (" + path +
+        ")\n");
+  }
+  write_graph_file_section(out, 0, &header, 1);
+  write_graph_file_section(out, layout.offsets, offsets.data(),
+                           offsets.size());
+  write_graph_file_section(out, layout.targets, graph.GetTargets().data(),
+                           graph.NumEdges());
+  write_graph_file_section(out, layout.weights, graph.GetWeights().data(),
+                           graph.NumEdges());
+  write_graph_file_section(out, layout.name_offsets, name_offsets.data(),
+                           name_offsets.size());
+  write_graph_file_section(out, layout.name_order, name_order.data(),
+                           name_order.size());
+  if (has_coordinates) {
+    write_graph_file_section(out, layout.coordinates, coordinates.data(),
+                             coordinates.size());
+  }
+  write_graph_file_section(out, layout.names, "", 0);
+  for (VertexId v = 0; v != static_cast<VertexId>(num_vertices); ++v) {
+    const std::string& name = graph.GetVertexPtr(v)->name_;
+    out.write(name.data(), name.size());
+  }
+
+  if (!out) {
+    throw std::runtime_error(
+        "write_graph_file error! Failed while writing file (" + path + ")\n");
+  }
+}
+
+MappedGraph::MappedGraph(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(
+        "MappedGraph::MappedGraph error! Could not open file (" + path + ")\n");
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<std::size_t>(file_stat.st_size) < sizeof(GraphFileHeader)) {
+    close(fd);
+    throw std::runtime_error(
+        "MappedGraph::MappedGraph error! Not a graph file (" + path + ")\n");
+  }
+  size_ = file_stat.st_size;
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // the mapping stays valid without the descriptor
+  if (data_ == MAP_FAILED) {
+    throw std::runtime_error(
+        "MappedGraph::MappedGraph error! Could not map file (" + path + ")\n");
+  }
+
+  // The destructor doesn't run if the constructor throws.
+  auto fail = [this, &path](const std::string& reason) {
+    munmap(data_, size_);
+    throw std::runtime_error("MappedGraph::MappedGraph error! " + reason +
+                             " (" + path + ")\n");
+  };
+
+  const char* bytes = static_cast<const char*>(data_);
+  GraphFileHeader header;
+  std::memcpy(&header, bytes, sizeof(header));
+  if (std::memcmp(header.magic, kGraphFileMagic, sizeof(header.magic)) != 0) {
+    fail("Not a graph file");
+  }
+  if (header.byte_order != kGraphFileByteOrder) {
+    fail("Graph file was written with a different byte order");
+  }
+  if (header.version != kGraphFileVersion) {
+    fail("Unsupported graph file version " + std::to_string(header.version));
+  }
+  if (!graph_file_counts_fit(header, size_)) {
+    fail("Graph file has the wrong size");
+  }
+  const GraphFileLayout layout = get_graph_file_layout(header);
+  if (layout.size != size_) {
+    fail("Graph file has the wrong size");
+  }
+
+  num_vertices_ = header.num_vertices;
+  num_edges_ = header.num_edges;
+  is_directed_ = header.flags & kGraphFileDirected;
+  offsets_ = reinterpret_cast<const std::uint64_t*>(bytes + layout.offsets);
+  targets_ = reinterpret_cast<const VertexId*>(bytes + layout.targets);
+  weights_ = reinterpret_cast<const double*>(bytes + layout.weights);
+  name_offsets_ =
+      reinterpret_cast<const std::uint64_t*>(bytes + layout.name_offsets);
+  name_order_ = reinterpret_cast<const VertexId*>(bytes + layout.name_order);
+  if (header.flags & kGraphFileCoordinates) {
+    coordinates_ = reinterpret_cast<const double*>(bytes + layout.coordinates);
+  }
+  names_ = bytes + layout.names;
+
+  // Cheap consistency checks; the arrays themselves are trusted.
+  if (offsets_[num_vertices_] != num_edges_ ||
+      name_offsets_[num_vertices_] != header.names_size) {
+    fail("Graph file is corrupt");
+  }
+}
+
+MappedGraph::~MappedGraph() { munmap(data_, size_); }
+
+void MappedGraph::Validate() const {
+  auto fail = [](const std::string& reason) {
+    throw std::runtime_error("MappedGraph::Validate error! " + reason + "\n");
+  };
+  const VertexId num_vertices = static_cast<VertexId>(num_vertices_);
+  if (offsets_[0] != 0 || name_offsets_[0] != 0) {
+    fail("Offsets don't start at 0");
+  }
+  for (VertexId v = 0; v != num_vertices; ++v) {
+    if (offsets_[v + 1] < offsets_[v] ||
+        name_offsets_[v + 1] < name_offsets_[v]) {
+      fail("Offsets decrease at VertexId " + std::to_string(v));
+    }
+  }
+  for (std::size_t e = 0; e != num_edges_; ++e) {
+    if (targets_[e] < 0 || targets_[e] >= num_vertices) {
+      fail("Edge " + std::to_string(e) + " has an invalid target");
+    }
+  }
+  for (VertexId i = 0; i != num_vertices; ++i) {
+    if (name_order_[i] < 0 || name_order_[i] >= num_vertices) {
+      fail("Name index has an invalid VertexId");
+    }
+    if (i != 0 && GetName(name_order_[i]) < GetName(name_order_[i - 1])) {
+      fail("Name index isn't sorted");
+    }
+  }
+}
+
+VertexId MappedGraph::FindVertex(std::string_view name) const {
+  const VertexId* end = name_order_ + num_vertices_;
+  const VertexId* iter =
+      std::lower_bound(name_order_, end, name,
+                       [this](VertexId v, std::string_view name) {
+                         return GetName(v) < name;
+                       });
+  return (iter != end && GetName(*iter) == name) ? *iter : kNoVertex;
+}
+
+std::string to_string(const MappedGraph& graph) {
+  std::string s("Adjacency lists:\n");
+  for (VertexId v = 0; v != static_cast<VertexId>(graph.NumVertices()); ++v) {
+    s += std::string(graph.GetName(v)) + " -> ";
+    for (std::size_t e = graph.EdgeBegin(v); e != graph.EdgeEnd(v); ++e) {
+      s += std::string(graph.GetName(graph.GetTarget(e))) +
+           "(wgt=" + std::to_string(graph.GetWeight(e)) + ") | ";
+    }
+    s += '\n';
+  }
+  s += '\n';
+  return s;
+}
+
+}  // namespace graphlib
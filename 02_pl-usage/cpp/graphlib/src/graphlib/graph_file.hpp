@@ -0,0 +1,114 @@
+/*
+A versioned binary on-disk format for graphs, along with the "MappedGraph"
+class, which memory-maps such a file and answers read-only queries directly
+from the mapping. Loading a MappedGraph does no parsing, copying, or per-vertex
+allocation, so startup time is independent of graph size.
+
+Files are written from a CompactGraph snapshot (see compact_graph.hpp), and a
+MappedGraph has the same VertexIds and CSR layout as the snapshot it was
+written from. To run the CompactGraph algorithms on a MappedGraph, make a
+CompactGraph of it, which reads the CSR arrays from the mapping in place (see
+compact_graph.hpp). If every Vertex of the snapshot is a Vertex2d (e.g. a
+snapshot of a Graph2d), their coordinates are written as well.
+
+File layout (native byte order, which is checked on load; every section starts
+at a multiple of 8 bytes):
+
+      header        magic "GRAPHLIB", format version, byte order mark,
+                    flags (directed, has coordinates), V, E, string table size
+      offsets       uint64[V + 1]   CSR offsets
+      targets       int32[E]        CSR targets
+      weights       double[E]       CSR weights
+      name offsets  uint64[V + 1]   name of vertex v is the string table range
+                                    [name_offsets[v], name_offsets[v + 1])
+      name order    int32[V]        VertexIds sorted by name, for FindVertex
+      coordinates   double[2 * V]   x, y of each vertex (only if flagged)
+      string table  char[]          all names, concatenated
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+// Write the given snapshot to a binary graph file, replacing any existing file.
+void write_graph_file(const CompactGraph& graph, const std::string& path);
+
+class MappedGraph {
+ public:
+  // Memory-maps the binary graph file at the given path. Only the header and
+  // the file size are checked, in constant time; the accessors below trust the
+  // arrays in the file unless Validate has been called.
+  explicit MappedGraph(const std::string& path);
+  ~MappedGraph();
+
+  MappedGraph(const MappedGraph&) = delete;
+  MappedGraph& operator=(const MappedGraph&) = delete;
+
+  std::size_t NumVertices() const { return num_vertices_; }
+  std::size_t NumEdges() const { return num_edges_; }
+
+  bool IsDirected() const { return is_directed_; }
+
+  // Checks the arrays of a file that may be truncated or corrupt, in O(V + E)
+  // time: edge and name offsets must never decrease or pass the end of their
+  // arrays, and every target and entry of the name index must be a VertexId of
+  // the graph, with the index sorted by name. Throws if not. Making a
+  // CompactGraph of a MappedGraph validates it.
+  void Validate() const;
+
+  // Name of the vertex with the given id.
+  std::string_view GetName(VertexId v) const {
+    return std::string_view(names_ + name_offsets_[v],
+                            name_offsets_[v + 1] - name_offsets_[v]);
+  }
+
+  // Id of the vertex with the given name, or kNoVertex if no such vertex
+  // exists. Binary search, so no index needs to be built on load.
+  VertexId FindVertex(std::string_view name) const;
+
+  // Same edge access as CompactGraph.
+  std::size_t EdgeBegin(VertexId v) const { return offsets_[v]; }
+  std::size_t EdgeEnd(VertexId v) const { return offsets_[v + 1]; }
+  std::size_t Degree(VertexId v) const { return offsets_[v + 1] - offsets_[v]; }
+
+  VertexId GetTarget(std::size_t edge) const { return targets_[edge]; }
+  double GetWeight(std::size_t edge) const { return weights_[edge]; }
+
+  // Vertex2d coordinates, if they were written.
+  bool HasCoordinates() const { return coordinates_ != nullptr; }
+  double GetX(VertexId v) const { return coordinates_[2 * v]; }
+  double GetY(VertexId v) const { return coordinates_[2 * v + 1]; }
+
+ private:
+  // Views the CSR arrays in place.
+  friend class CompactGraph;
+
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+
+  std::size_t num_vertices_ = 0, num_edges_ = 0;
+  bool is_directed_ = true;
+
+  // Views into the mapping.
+  const std::uint64_t* offsets_ = nullptr;
+  const VertexId* targets_ = nullptr;
+  const double* weights_ = nullptr;
+  const std::uint64_t* name_offsets_ = nullptr;
+  const VertexId* name_order_ = nullptr;
+  const double* coordinates_ = nullptr;
+  const char* names_ = nullptr;
+};
+
+// For a given mapped graph, return a string displaying all vertices and
+// corresponding adjacency lists. Output matches to_string(const CompactGraph&).
+std::string to_string(const MappedGraph& graph);
+
+}  // namespace graphlib
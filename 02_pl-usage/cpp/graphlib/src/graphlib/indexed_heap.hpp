@@ -0,0 +1,158 @@
+/*
+The "IndexedMinHeap" class is a d-ary min-heap of VertexIds keyed by doubles
+(e.g. distances to a search root), which also tracks where each VertexId sits
+in the heap. This gives the "index priority queue" of Sedgewick: besides the
+usual push and pop, the key of a VertexId already in the heap can be lowered in
+O(log V) time (decrease-key), instead of having to search for it and reheapify
+the whole heap.
+
+The heap arity is a template parameter. A wider heap is shallower, so
+decrease-key (which sifts up) gets cheaper while pop (which sifts down, looking
+at every child on the way) gets more expensive. 4 is a good default for
+shortest paths on sparse graphs, where decrease-keys outnumber pops.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+constexpr std::size_t kDefaultHeapArity = 4;
+
+template <std::size_t Arity = kDefaultHeapArity>
+class IndexedMinHeap {
+  static_assert(Arity >= 2, "IndexedMinHeap needs an arity of at least 2");
+
+ public:
+  // Constructs an empty heap for VertexIds in [0, num_vertices).
+  explicit IndexedMinHeap(std::size_t num_vertices)
+      : positions_(num_vertices, kNotInHeap) {}
+
+  bool Empty() const { return heap_.empty(); }
+  std::size_t Size() const { return heap_.size(); }
+
+  bool Contains(VertexId v) const { return positions_[v] != kNotInHeap; }
+
+  // Returns the key of a VertexId in the heap.
+  double GetKey(VertexId v) const {
+    if (!Contains(v)) {
+      throw std::runtime_error(
+          "IndexedMinHeap::GetKey error! Given VertexId not in heap.\n");
+    }
+    return heap_[positions_[v]].key;
+  }
+
+  // Returns the VertexId with the smallest key, and that key.
+  VertexId Top() const { return heap_.front().id; }
+  double TopKey() const { return heap_.front().key; }
+
+  void Push(VertexId v, double key) {
+    if (Contains(v)) {
+      throw std::runtime_error(
+          "IndexedMinHeap::Push error! Given VertexId already in heap.\n");
+    }
+    heap_.push_back({key, v});
+    positions_[v] = heap_.size() - 1;
+    SiftUp(heap_.size() - 1);
+  }
+
+  // Lowers the key of a VertexId in the heap.
+  void DecreaseKey(VertexId v, double key) {
+    if (!Contains(v) || key > heap_[positions_[v]].key) {
+      throw std::runtime_error(
+          "IndexedMinHeap::DecreaseKey error! Given VertexId not in heap, or "
+          "given key larger than current key.\n");
+    }
+    heap_[positions_[v]].key = key;
+    SiftUp(positions_[v]);
+  }
+
+  // Pushes the given VertexId if it's not in the heap yet, otherwise lowers its
+  // key. This is the usual way to record a relaxed edge.
+  void PushOrDecreaseKey(VertexId v, double key) {
+    if (Contains(v)) {
+      DecreaseKey(v, key);
+    } else {
+      Push(v, key);
+    }
+  }
+
+  // Removes and returns the VertexId with the smallest key.
+  VertexId Pop() {
+    const VertexId top = heap_.front().id;
+    positions_[top] = kNotInHeap;
+    if (heap_.size() > 1) {
+      heap_.front() = heap_.back();
+      positions_[heap_.front().id] = 0;
+      heap_.pop_back();
+      SiftDown(0);
+    } else {
+      heap_.pop_back();
+    }
+    return top;
+  }
+
+  // Removes every VertexId from the heap, in time proportional to the size of
+  // the heap rather than the number of vertices. This lets one heap be reused
+  // across searches that each touch a small part of a large graph.
+  void Clear() {
+    for (const Entry& entry : heap_) positions_[entry.id] = kNotInHeap;
+    heap_.clear();
+  }
+
+ private:
+  struct Entry {
+    double key;
+    VertexId id;
+  };
+
+  static constexpr std::size_t kNotInHeap = static_cast<std::size_t>(-1);
+
+  // Move the entry at position i up towards the root until its parent's key is
+  // no larger. The entry is held aside and written once, at its final position.
+  void SiftUp(std::size_t i) {
+    const Entry entry = heap_[i];
+    while (i > 0) {
+      std::size_t parent = (i - 1) / Arity;
+      if (!(entry.key < heap_[parent].key)) break;
+      heap_[i] = heap_[parent];
+      positions_[heap_[i].id] = i;
+      i = parent;
+    }
+    heap_[i] = entry;
+    positions_[entry.id] = i;
+  }
+
+  // Move the entry at position i down towards the leaves until none of its
+  // children has a smaller key.
+  void SiftDown(std::size_t i) {
+    const Entry entry = heap_[i];
+    const std::size_t size = heap_.size();
+    while (true) {
+      std::size_t first_child = Arity * i + 1;
+      if (first_child >= size) break;
+      std::size_t last_child = std::min(first_child + Arity, size);
+      std::size_t min_child = first_child;
+      for (std::size_t c = first_child + 1; c < last_child; ++c) {
+        if (heap_[c].key < heap_[min_child].key) min_child = c;
+      }
+      if (!(heap_[min_child].key < entry.key)) break;
+      heap_[i] = heap_[min_child];
+      positions_[heap_[i].id] = i;
+      i = min_child;
+    }
+    heap_[i] = entry;
+    positions_[entry.id] = i;
+  }
+
+  std::vector<Entry> heap_;
+  std::vector<std::size_t> positions_;  // position in heap_ of each VertexId
+};
+
+}  // namespace graphlib
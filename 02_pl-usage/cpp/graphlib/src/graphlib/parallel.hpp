@@ -0,0 +1,161 @@
+/*
+Minimal helpers for the multithreaded algorithms, built directly on std::thread.
+
+parallel_for splits an index range into one contiguous chunk per thread, so
+chunks can own disjoint slices of output arrays (or of bitmap words) without
+synchronization. parallel_for_dynamic instead hands out indices one at a time,
+for uneven work. Threads are started per call, which costs tens of
+microseconds; for small ranges, min_chunk_size keeps the work on fewer threads
+(down to just the calling thread). Algorithms with many short phases can
+instead keep one set of threads, separating the phases with a Barrier.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace graphlib {
+
+// The number of threads used by parallel algorithms when given 0: one per
+// hardware thread.
+inline unsigned default_num_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Blocks each of num_threads threads calling Wait until all of them have. This
+// lets an algorithm with many short phases run them all on one set of threads
+// (started by a single parallel_for), instead of starting new threads for every
+// phase. Can be waited on any number of times.
+class Barrier {
+ public:
+  explicit Barrier(unsigned num_threads) : num_threads_(num_threads) {}
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::size_t generation = generation_;
+    if (++num_waiting_ == num_threads_) {
+      num_waiting_ = 0;
+      ++generation_;
+      lock.unlock();
+      released_.notify_all();
+      return;
+    }
+    released_.wait(lock, [&] { return generation_ != generation; });
+  }
+
+ private:
+  const unsigned num_threads_;
+  unsigned num_waiting_ = 0;
+  std::size_t generation_ = 0;  // number of times all threads have arrived
+  std::mutex mutex_;
+  std::condition_variable released_;
+};
+
+// Calls function(chunk_begin, chunk_end, thread_index) for contiguous chunks
+// covering [begin, end), each on its own thread (the first on the calling
+// thread). At most num_threads chunks are used (or default_num_threads() if
+// num_threads is 0), each of at least min_chunk_size indices. Exceptions thrown
+// by function are rethrown on the calling thread once all chunks are done.
+template <typename Function>
+void parallel_for(std::size_t begin, std::size_t end, unsigned num_threads,
+                  std::size_t min_chunk_size, Function function) {
+  if (begin >= end) return;
+  if (num_threads == 0) num_threads = default_num_threads();
+  const std::size_t size = end - begin;
+  const std::size_t max_chunks =
+      size / std::max<std::size_t>(1, min_chunk_size);
+  const std::size_t num_chunks =
+      std::max<std::size_t>(1, std::min<std::size_t>(num_threads, max_chunks));
+  if (num_chunks == 1) {
+    function(begin, end, 0u);
+    return;
+  }
+
+  std::vector<std::exception_ptr> errors(num_chunks);
+  auto run_chunk = [&](std::size_t chunk) {
+    try {
+      function(begin + size * chunk / num_chunks,
+               begin + size * (chunk + 1) / num_chunks,
+               static_cast<unsigned>(chunk));
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_chunks - 1);
+  for (std::size_t chunk = 1; chunk != num_chunks; ++chunk) {
+    threads.emplace_back(run_chunk, chunk);
+  }
+  run_chunk(0);
+  for (std::thread& thread : threads) thread.join();
+
+  for (const std::exception_ptr& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+// Calls function(index, thread_index) for every index in [begin, end), on up to
+// num_threads threads (or default_num_threads() if 0). Unlike parallel_for,
+// indices are handed out one at a time to whichever thread is free, which keeps
+// threads busy when the work per index varies a lot. Each index costs an atomic
+// increment, so an index should stand for a sizable piece of work.
+template <typename Function>
+void parallel_for_dynamic(std::size_t begin, std::size_t end,
+                          unsigned num_threads, Function function) {
+  if (begin >= end) return;
+  if (num_threads == 0) num_threads = default_num_threads();
+  std::atomic<std::size_t> next(begin);
+  parallel_for(0, std::min<std::size_t>(num_threads, end - begin), num_threads,
+               1, [&](std::size_t, std::size_t, unsigned thread_index) {
+                 for (std::size_t index = next++; index < end;
+                      index = next++) {
+                   function(index, thread_index);
+                 }
+               });
+}
+
+// Sorts [first, last) like std::stable_sort, on num_threads threads (or
+// default_num_threads() if 0). Chunks of the range are sorted in parallel, then
+// merged pairwise in parallel rounds. Since the merges are stable too, the
+// result doesn't depend on the number of threads.
+template <typename RandomIt, typename Compare>
+void parallel_stable_sort(RandomIt first, RandomIt last, unsigned num_threads,
+                          Compare compare) {
+  const std::size_t kMinChunkSize = 1 << 14;
+  if (num_threads == 0) num_threads = default_num_threads();
+  const std::size_t size = last - first;
+  const std::size_t num_chunks = std::max<std::size_t>(
+      1, std::min<std::size_t>(num_threads, size / kMinChunkSize));
+  auto chunk_begin = [&](std::size_t chunk) {
+    return first + size * std::min(chunk, num_chunks) / num_chunks;
+  };
+
+  parallel_for(0, num_chunks, num_threads, 1,
+               [&](std::size_t begin, std::size_t end, unsigned) {
+                 for (std::size_t chunk = begin; chunk != end; ++chunk) {
+                   std::stable_sort(chunk_begin(chunk), chunk_begin(chunk + 1),
+                                    compare);
+                 }
+               });
+  for (std::size_t width = 1; width < num_chunks; width *= 2) {
+    const std::size_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+    parallel_for(0, num_merges, num_threads, 1,
+                 [&](std::size_t begin, std::size_t end, unsigned) {
+                   for (std::size_t merge = begin; merge != end; ++merge) {
+                     std::size_t lo = 2 * width * merge;
+                     std::inplace_merge(chunk_begin(lo),
+                                        chunk_begin(lo + width),
+                                        chunk_begin(lo + 2 * width), compare);
+                   }
+                 });
+  }
+}
+
+}  // namespace graphlib
@@ -0,0 +1,86 @@
+#include "graphlib/search_state.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace graphlib {
+
+std::string to_string(const VertexState& state) {
+  switch (state) {
+    case VertexState::UNDISCOVERED:
+      return "0";
+      break;
+    case VertexState::DISCOVERED:
+      return "1";
+      break;
+    case VertexState::PROCESSED:
+      return "2";
+      break;
+    default:
+      return "nonexistent Vertex state";
+  }
+}
+
+SearchState::SearchState(std::size_t num_vertices)
+    : state_(num_vertices, VertexState::UNDISCOVERED),
+      parent_(num_vertices, kNoVertex),
+      entry_time_(num_vertices, 0),
+      exit_time_(num_vertices, 0),
+      dist_to_root_(num_vertices, std::numeric_limits<double>::infinity()) {}
+
+void SearchState::Reset() {
+  std::fill(state_.begin(), state_.end(), VertexState::UNDISCOVERED);
+  std::fill(parent_.begin(), parent_.end(), kNoVertex);
+  std::fill(entry_time_.begin(), entry_time_.end(), 0);
+  std::fill(exit_time_.begin(), exit_time_.end(), 0);
+  std::fill(dist_to_root_.begin(), dist_to_root_.end(),
+            std::numeric_limits<double>::infinity());
+  time_ = 0;
+}
+
+std::string to_string(const Graph& graph, const SearchState& state) {
+  std::string s("Vertex set:\n");
+  for (const auto& v : graph.GetAdjacencyMap()) {
+    s += v.first->name_ + "(state=" +
+         graphlib::to_string(state.state_[v.first->id_]) + ") | ";
+  }
+  s += '\n';
+  return s;
+}
+
+template <typename GraphType>
+std::stack<const Vertex*> get_path_helper(const GraphType* graph,
+                                          const SearchState& state,
+                                          const Vertex* search_root,
+                                          const Vertex* destination) {
+  VertexId v = destination->id_;
+  std::stack<const Vertex*> s;
+  s.push(destination);
+
+  while (v != search_root->id_) {
+    v = state.parent_[v];
+    if (v == kNoVertex) {
+      std::cerr << "No path between " << search_root->name_ << " and "
+                << destination->name_ << "\n\n";
+      return std::stack<const Vertex*>();
+    }
+    s.push(graph->GetVertexPtr(v));
+  }
+  return s;
+}
+
+std::stack<const Vertex*> get_path(const Graph* graph, const SearchState& state,
+                                   const Vertex* search_root,
+                                   const Vertex* destination) {
+  return get_path_helper(graph, state, search_root, destination);
+}
+
+std::stack<const Vertex*> get_path(const CompactGraph* graph,
+                                   const SearchState& state,
+                                   const Vertex* search_root,
+                                   const Vertex* destination) {
+  return get_path_helper(graph, state, search_root, destination);
+}
+
+}  // namespace graphlib
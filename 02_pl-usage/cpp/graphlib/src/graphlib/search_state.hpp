@@ -0,0 +1,59 @@
+/*
+The "SearchState" struct holds the per-query state of graph algorithms (search
+state, search tree parents, DFS time intervals, and distances to the search
+root) in dense arrays indexed by VertexId.
+
+Keeping this state out of the Vertices lets any number of queries run over the
+same Graph (or CompactGraph, which shares the ids of its source Graph) at the
+same time, each with its own SearchState. A SearchState can also be reused
+across several searches over the same graph (e.g. one BFS per connected
+component) without being reset in between.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "graphlib/compact_graph.hpp"
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+enum class VertexState { UNDISCOVERED, DISCOVERED, PROCESSED };
+
+std::string to_string(const VertexState& state);
+
+struct SearchState {
+  // Constructs a fresh search state for a graph with the given number of
+  // vertices.
+  explicit SearchState(std::size_t num_vertices);
+
+  // Return to a fresh search state.
+  void Reset();
+
+  std::vector<VertexState> state_;           // search state
+  std::vector<VertexId> parent_;             // search tree parent
+  std::vector<int> entry_time_, exit_time_;  // dfs time intervals
+  std::vector<double> dist_to_root_;         // weighted path distances
+  int time_ = 0;                             // dfs clock
+};
+
+// Return a string displaying all vertices of the given graph along with their
+// search states.
+std::string to_string(const Graph& graph, const SearchState& state);
+
+// Repeatedly pop the stack returned by these functions to obtain the search
+// tree path from search_root to destination encoded in the given SearchState.
+// The stack is empty if there is no such path.
+std::stack<const Vertex*> get_path(const Graph* graph, const SearchState& state,
+                                   const Vertex* search_root,
+                                   const Vertex* destination);
+std::stack<const Vertex*> get_path(const CompactGraph* graph,
+                                   const SearchState& state,
+                                   const Vertex* search_root,
+                                   const Vertex* destination);
+
+}  // namespace graphlib
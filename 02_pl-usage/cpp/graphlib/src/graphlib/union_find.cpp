@@ -0,0 +1,70 @@
+#include "graphlib/union_find.hpp"
+
+#include <numeric>
+#include <utility>
+
+namespace graphlib {
+
+UnionFind::UnionFind(std::size_t num_vertices)
+    : parents_(num_vertices), ranks_(num_vertices, 0), num_sets_(num_vertices) {
+  std::iota(parents_.begin(), parents_.end(), 0);
+}
+
+VertexId UnionFind::Find(VertexId v) {
+  while (parents_[v] != v) {
+    parents_[v] = parents_[parents_[v]];
+    v = parents_[v];
+  }
+  return v;
+}
+
+bool UnionFind::Union(VertexId v1, VertexId v2) {
+  VertexId set1 = Find(v1), set2 = Find(v2);
+  if (set1 == set2) return false;
+
+  if (ranks_[set1] < ranks_[set2]) {
+    parents_[set1] = set2;
+  } else {
+    parents_[set2] = set1;
+    if (ranks_[set1] == ranks_[set2]) ++ranks_[set1];
+  }
+  --num_sets_;
+  return true;
+}
+
+ConcurrentUnionFind::ConcurrentUnionFind(std::size_t num_vertices)
+    : parents_(num_vertices) {
+  for (std::size_t v = 0; v != num_vertices; ++v) {
+    parents_[v].store(v, std::memory_order_relaxed);
+  }
+}
+
+VertexId ConcurrentUnionFind::Find(VertexId v) {
+  while (true) {
+    VertexId parent = parents_[v].load(std::memory_order_relaxed);
+    if (parent == v) return v;
+    VertexId grandparent = parents_[parent].load(std::memory_order_relaxed);
+    if (grandparent == parent) return parent;
+    parents_[v].store(grandparent, std::memory_order_relaxed);
+    v = grandparent;
+  }
+}
+
+bool ConcurrentUnionFind::Union(VertexId v1, VertexId v2) {
+  while (true) {
+    v1 = Find(v1);
+    v2 = Find(v2);
+    if (v1 == v2) return false;
+    if (v1 < v2) std::swap(v1, v2);
+
+    // v1 may have stopped being a root since Find returned it, in which case
+    // the compare-and-swap fails and both roots are looked up again.
+    VertexId root = v1;
+    if (parents_[v1].compare_exchange_weak(root, v2,
+                                           std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+}
+
+}  // namespace graphlib
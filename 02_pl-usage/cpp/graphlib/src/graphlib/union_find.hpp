@@ -0,0 +1,87 @@
+/*
+The "UnionFind" class is the weighted Union-Find (disjoint-set) data structure,
+over the dense VertexIds of a Graph or CompactGraph. The disjoint subsets it
+maintains typically represent connected components (e.g. of the growing forest
+in Kruskal's algorithm).
+
+Each disjoint subset is represented as a tree, with the tree root "naming" the
+subset. Both classic improvements are used to keep the trees flat:
+- union by rank: the root of the lower-rank tree (rank being an upper bound on
+  tree height) becomes a child of the other root.
+- path compression: Find points vertices along the path it walks closer to
+  the root (path halving: each visited vertex is re-linked to its grandparent).
+Together these make any sequence of operations take nearly constant amortized
+time per operation.
+
+The "ConcurrentUnionFind" class is a lock-free variant that many threads can
+use at once, e.g. to union the edges of a graph in parallel. Ranks can't be
+kept consistent without locking, so it links by index instead: the root with
+the larger VertexId becomes a child of the other, with a compare-and-swap that
+is retried if another thread got to either root first. Since links always point
+to smaller VertexIds, no cycles can form, and each subset ends up named by its
+smallest VertexId. Find uses path halving as well. This only ever re-links
+vertices that are no longer roots, to another of their ancestors, so it can't
+undo a concurrent union.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graphlib/graph.hpp"
+
+namespace graphlib {
+
+class UnionFind {
+ public:
+  // Initially, each vertex is its own subset.
+  explicit UnionFind(std::size_t num_vertices);
+
+  // Returns the "name" of the subset containing the given vertex (i.e. the
+  // root of the vertex's tree).
+  VertexId Find(VertexId v);
+
+  // Same as Find, but without compressing the path. Unlike Find, this can be
+  // called from several threads at once (as long as nothing calls Find or
+  // Union meanwhile).
+  VertexId FindRoot(VertexId v) const {
+    while (parents_[v] != v) v = parents_[v];
+    return v;
+  }
+
+  bool IsConnected(VertexId v1, VertexId v2) { return Find(v1) == Find(v2); }
+
+  // Merge the subsets containing the given vertices. Returns false if they were
+  // already the same subset.
+  bool Union(VertexId v1, VertexId v2);
+
+  std::size_t NumSets() const { return num_sets_; }
+
+ private:
+  std::vector<VertexId> parents_;  // tree roots are their own parents
+  std::vector<std::uint8_t> ranks_;
+  std::size_t num_sets_;
+};
+
+class ConcurrentUnionFind {
+ public:
+  // Initially, each vertex is its own subset.
+  explicit ConcurrentUnionFind(std::size_t num_vertices);
+
+  // Returns the "name" of the subset containing the given vertex: its smallest
+  // VertexId, once no unions are in progress.
+  VertexId Find(VertexId v);
+
+  // Merge the subsets containing the given vertices. Returns false if they were
+  // already the same subset. When several threads merge the same subsets, only
+  // one of them gets true.
+  bool Union(VertexId v1, VertexId v2);
+
+ private:
+  std::vector<std::atomic<VertexId>> parents_;  // roots are their own parents
+};
+
+}  // namespace graphlib